@@ -0,0 +1,148 @@
+// bench/bench_chip8.cpp
+// Interpreter throughput on a synthetic loop, and full-ROM runs over
+// ROM/GAMES (or $CHIP8_BENCH_ROMS) for a fixed cycle budget.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "chip8.h"
+#include "config.h"
+#include "debug.h"
+}
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t kBatch     = 1000;     // instructions per benchmark iteration
+constexpr uint64_t kRomCycles = 100000;   // cycles per full-ROM run
+
+/* ALU/I loop with a skip and two jumps: no draws, no waits. */
+void load_loop(struct Chip8& c8) {
+    static const uint16_t prog[] = {
+        0x6000,   // 0x200: LD V0, 0
+        0x7001,   // 0x202: ADD V0, 1
+        0x8104,   // 0x204: ADD V1, V0
+        0x8203,   // 0x206: XOR V2, V0
+        0xA300,   // 0x208: LD I, 0x300
+        0xF01E,   // 0x20A: ADD I, V0
+        0x3000,   // 0x20C: SE V0, 0
+        0x1202,   // 0x20E: JP 0x202
+        0x1200,   // 0x210: JP 0x200
+    };
+    chip8_init(&c8);
+    for (size_t i = 0; i < sizeof(prog) / sizeof(prog[0]); ++i) {
+        const uint16_t a = (uint16_t)(PROGRAM_START_ADDRESS + 2 * i);
+        memory_write(&c8.chip8_mem, a,     (uint8_t)(prog[i] >> 8));
+        memory_write(&c8.chip8_mem, a + 1, (uint8_t)(prog[i] & 0xFF));
+    }
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+}
+
+void BM_Step(benchmark::State& state) {
+    static struct Chip8 c8;
+    load_loop(c8);
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < kBatch; ++i) chip8_step(&c8);
+    }
+    benchmark::DoNotOptimize(c8.chip8_regs.V[1]);
+    state.counters["instr/s"] = benchmark::Counter((double)state.iterations() * kBatch, benchmark::Counter::kIsRate);
+    chip8_destroy(&c8);
+}
+BENCHMARK(BM_Step);
+
+void BM_RunBlocks(benchmark::State& state) {
+    static struct Chip8 c8;
+    load_loop(c8);
+    for (auto _ : state) {
+        uint32_t ran = 0;
+        chip8_run_blocks(&c8, kBatch, &ran);
+    }
+    benchmark::DoNotOptimize(c8.chip8_regs.V[1]);
+    state.counters["instr/s"] = benchmark::Counter((double)state.iterations() * kBatch, benchmark::Counter::kIsRate);
+    chip8_destroy(&c8);
+}
+BENCHMARK(BM_RunBlocks);
+
+/* debug_run() over the same loop. range(0): 0 = nothing set, 1 = 16
+ * breakpoints that are never hit, 2 = plus a watchpoint (single-steps). */
+void BM_DebugRun(benchmark::State& state) {
+    static struct Chip8 c8;
+    static Debugger d;
+    load_loop(c8);
+    debug_init(&d);
+    if (state.range(0) >= 1) {
+        for (uint16_t a = 0x212; a < 0x232; a += 2) debug_set_break(&d, a, nullptr);
+    }
+    if (state.range(0) >= 2) debug_watch(&d, 0x400, 16, DEBUG_WATCH_WRITE, true);
+    for (auto _ : state) {
+        uint32_t ran = 0;
+        debug_run(&d, &c8, kBatch, &ran, nullptr);
+    }
+    benchmark::DoNotOptimize(c8.chip8_regs.V[1]);
+    state.counters["instr/s"] = benchmark::Counter((double)state.iterations() * kBatch, benchmark::Counter::kIsRate);
+    chip8_destroy(&c8);
+}
+BENCHMARK(BM_DebugRun)->ArgName("mode")->Arg(0)->Arg(1)->Arg(2);
+
+/* One ROM from power-on for kRomCycles at the default clock, no input.
+ * range(0) = chip8_skip_idle, to show what wait-loop fast-forward buys. */
+void BM_Rom(benchmark::State& state, std::string path) {
+    static struct Chip8 base, c8;
+    chip8_init(&base);
+    if (chip8_load_rom(&base, path.c_str()) != CHIP8_OK) {
+        state.SkipWithError("failed to load ROM");
+        chip8_destroy(&base);
+        return;
+    }
+    base.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    base.chip8_skip_idle = state.range(0) != 0;
+
+    const uint32_t cycles_per_frame = CPU_CLOCK_HZ / TIMER_CLOCK_HZ;
+    for (auto _ : state) {
+        chip8_fork(&c8, &base);
+        for (uint64_t done = 0; done < kRomCycles;) {
+            uint32_t ran = 0;
+            if (chip8_run_frame(&c8, cycles_per_frame, &ran) != CHIP8_OK) break;
+            done += ran;
+        }
+        benchmark::DoNotOptimize(c8.chip8_disp.rows[0]);
+        chip8_destroy(&c8);
+    }
+    state.counters["instr/s"] = benchmark::Counter((double)state.iterations() * kRomCycles, benchmark::Counter::kIsRate);
+    chip8_destroy(&base);
+}
+
+void register_rom_benchmarks() {
+    const char* env = std::getenv("CHIP8_BENCH_ROMS");
+    const fs::path dir = env && *env ? fs::path(env) : fs::path(CHIP8_BENCH_ROM_DIR);
+
+    std::error_code ec;
+    std::vector<fs::path> roms;
+    for (const auto& e : fs::directory_iterator(dir, ec)) {
+        if (e.is_regular_file() && e.path().extension() == ".ch8") roms.push_back(e.path());
+    }
+    std::sort(roms.begin(), roms.end());
+
+    for (const auto& p : roms) {
+        benchmark::RegisterBenchmark(("BM_Rom/" + p.stem().string()).c_str(), BM_Rom, p.string())
+            ->ArgName("skip_idle")->Arg(1)->Arg(0)
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    register_rom_benchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
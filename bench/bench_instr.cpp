@@ -0,0 +1,108 @@
+// bench/bench_instr.cpp
+// exec() cost per opcode class: decode + handler call, one opcode at a time,
+// and disassembly of the whole 4 KB code space.
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "chip8.h"
+#include "disasm.h"
+#include "instr.h"
+}
+
+namespace {
+
+struct OpCase {
+    const char* name;
+    uint16_t    op;
+    uint16_t    op2;   // executed right after `op` (0 = none), e.g. RET after CALL
+};
+
+const OpCase kCases[] = {
+    { "CLS",        0x00E0, 0 },
+    { "CALL+RET",   0x2300, 0x00EE },
+    { "JP",         0x1200, 0 },
+    { "JP V0",      0xB200, 0 },
+    { "SE Vx,kk",   0x3012, 0 },
+    { "SNE Vx,kk",  0x4012, 0 },
+    { "SE Vx,Vy",   0x5120, 0 },
+    { "LD Vx,kk",   0x6012, 0 },
+    { "ADD Vx,kk",  0x7012, 0 },
+    { "LD Vx,Vy",   0x8120, 0 },
+    { "OR",         0x8121, 0 },
+    { "AND",        0x8122, 0 },
+    { "XOR",        0x8123, 0 },
+    { "ADD Vx,Vy",  0x8124, 0 },
+    { "SUB",        0x8125, 0 },
+    { "SHR",        0x8126, 0 },
+    { "SUBN",       0x8127, 0 },
+    { "SHL",        0x812E, 0 },
+    { "LD I",       0xA300, 0 },
+    { "RND",        0xC0FF, 0 },
+    { "DRW 5",      0xD125, 0 },
+    { "DRW 15",     0xD12F, 0 },
+    { "SKP",        0xE09E, 0 },
+    { "SKNP",       0xE0A1, 0 },
+    { "LD Vx,DT",   0xF007, 0 },
+    { "LD Vx,K",    0xF00A, 0 },
+    { "LD DT,Vx",   0xF015, 0 },
+    { "LD ST,Vx",   0xF018, 0 },
+    { "ADD I,Vx",   0xF01E, 0 },
+    { "LD F,Vx",    0xF029, 0 },
+    { "LD B,Vx",    0xF033, 0 },
+    { "LD [I],V7",  0xF755, 0 },
+    { "LD V7,[I]",  0xF765, 0 },
+};
+
+void BM_Exec(benchmark::State& state) {
+    const OpCase& c = kCases[state.range(0)];
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    keyboard_press(&c8.chip8_kbd, 0x0);   // SKP/Fx0A take their "key down" path
+
+    Registers* r = &c8.chip8_regs;
+    for (uint8_t i = 0; i < NUM_REGS; ++i) r->V[i] = (uint8_t)(i * 7 + 1);
+
+    int64_t n = 0;
+    for (auto _ : state) {
+        r->PC = 0x202;
+        r->I  = 0x300;   // memory ops stay in one place
+        exec(c.op, r, &c8.chip8_mem, &c8.chip8_disp, &c8.chip8_stack, &c8.chip8_kbd);
+        if (c.op2) {
+            exec(c.op2, r, &c8.chip8_mem, &c8.chip8_disp, &c8.chip8_stack, &c8.chip8_kbd);
+            ++n;
+        }
+        ++n;
+    }
+    benchmark::DoNotOptimize(r->V[0]);
+    state.SetLabel(c.name);
+    state.counters["instr/s"] = benchmark::Counter((double)n, benchmark::Counter::kIsRate);
+    chip8_destroy(&c8);
+}
+
+void ExecArgs(benchmark::internal::Benchmark* b) {
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); ++i) b->Arg((int64_t)i);
+}
+
+/* Every word of 0x000-0xFFF listed, opcodes cycling through all 64K values. */
+void BM_DisasmRange(benchmark::State& state) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    for (uint32_t a = 0; a < 0x1000; ++a) {
+        (void)memory_write(&c8.chip8_mem, (uint16_t)a, (uint8_t)(a * 37u + (a >> 3)));
+    }
+
+    static char buf[2048 * DISASM_LINE_MAX];
+    int64_t n = 0;
+    for (auto _ : state) {
+        size_t next = 0;
+        benchmark::DoNotOptimize(disasm_range(&c8.chip8_mem, 0, 0x1000, buf, sizeof(buf), &next));
+        n += (int64_t)(next / 2);
+    }
+    state.counters["instr/s"] = benchmark::Counter((double)n, benchmark::Counter::kIsRate);
+    chip8_destroy(&c8);
+}
+
+} // namespace
+
+BENCHMARK(BM_Exec)->Apply(ExecArgs);
+BENCHMARK(BM_DisasmRange);
@@ -0,0 +1,36 @@
+// bench/bench_screen.cpp
+// screen_draw_sprite() at aligned, unaligned and wrapping positions.
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "screen.h"
+}
+
+namespace {
+
+void BM_DrawSprite(benchmark::State& state) {
+    const uint8_t x = (uint8_t)state.range(0);
+    const uint8_t y = (uint8_t)state.range(1);
+    const uint8_t n = (uint8_t)state.range(2);
+    const uint8_t sprite[15] = { 0xF0, 0x90, 0x90, 0x90, 0xF0, 0x3C, 0x7E, 0xFF,
+                                 0xDB, 0xFF, 0x24, 0x5A, 0xA5, 0x81, 0xFF };
+    Screen s;
+    screen_init(&s);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(screen_draw_sprite(&s, x, y, sprite, n));
+        benchmark::ClobberMemory();
+    }
+    state.counters["sprites/s"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK(BM_DrawSprite)
+    ->ArgNames({ "x", "y", "n" })
+    ->Args({ 0, 0, 5 })      // byte-aligned
+    ->Args({ 3, 10, 5 })     // unaligned
+    ->Args({ 61, 10, 5 })    // wraps on x
+    ->Args({ 20, 29, 5 })    // wraps on y
+    ->Args({ 61, 29, 15 })   // wraps on both, tallest sprite
+    ->Args({ 3, 10, 15 });
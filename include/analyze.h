@@ -0,0 +1,77 @@
+#ifndef CHIP8_ANALYZE_H
+#define CHIP8_ANALYZE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "chip8_status.h"
+#include "mem.h"
+
+/*
+ * Static ROM analysis: follows control flow from an entry point without
+ * running anything and builds the control-flow graph of the reachable code.
+ *
+ * - JP / CALL targets, the instruction after a CALL (assumed to return) and
+ *   both outcomes of every skip are followed; RET and EXIT end a path.
+ * - JP V0, addr (Bnnn) cannot be resolved statically: the site is flagged
+ *   ANALYZE_INDIRECT and the path ends there, so code only reached through
+ *   it stays unmarked.
+ * - An undecodable opcode on a path is flagged ANALYZE_UNKNOWN and ends the
+ *   path (it usually means the path ran into data).
+ * - Code written at run time (self-modifying ROMs) is not visible.
+ *
+ * Bytes that are neither instruction starts nor operands are data.
+ */
+
+/* Per-byte flags (RomAnalysis::flags). */
+#define ANALYZE_CODE      0x01u   /* first byte of a reachable instruction */
+#define ANALYZE_OPERAND   0x02u   /* later byte of a reachable instruction */
+#define ANALYZE_LEADER    0x04u   /* a basic block starts here */
+#define ANALYZE_JUMP      0x08u   /* target of a JP, or a skip outcome */
+#define ANALYZE_CALL      0x10u   /* target of a CALL */
+#define ANALYZE_INDIRECT  0x20u   /* JP V0, addr: successors unknown */
+#define ANALYZE_UNKNOWN   0x40u   /* undecodable opcode on a reachable path */
+#define ANALYZE_DATA_REF  0x80u   /* address loaded into I by LD I, addr */
+
+/* How a basic block ends. */
+typedef enum {
+    BLOCK_END_FALL = 0,   /* runs into the next block's leader */
+    BLOCK_END_JUMP,       /* JP addr */
+    BLOCK_END_BRANCH,     /* skip: the next instruction or the one after */
+    BLOCK_END_CALL,       /* CALL addr, then the return site */
+    BLOCK_END_RET,        /* RET */
+    BLOCK_END_HALT,       /* EXIT */
+    BLOCK_END_INDIRECT,   /* JP V0, addr */
+    BLOCK_END_STOP        /* unknown opcode or end of RAM */
+} BlockEnd;
+
+typedef struct {
+    uint16_t start;       /* first instruction */
+    uint16_t last;        /* last instruction (the one that ends the block) */
+    uint16_t instrs;      /* instructions in the block */
+    uint8_t  end;         /* BlockEnd */
+    uint8_t  nsucc;       /* valid entries in succ[] */
+    uint16_t succ[2];     /* successor block starts (CALL: target, return site) */
+} RomBlock;
+
+typedef struct {
+    uint8_t   flags[MEMORY_SIZE];   /* ANALYZE_* per byte of RAM */
+    RomBlock* blocks;               /* ordered by start address */
+    size_t    block_count;
+    size_t    instr_count;          /* reachable instructions */
+    size_t    code_bytes;           /* bytes flagged CODE or OPERAND */
+    size_t    indirect_count;       /* Bnnn sites reached */
+    size_t    unknown_count;        /* undecodable opcodes reached */
+} RomAnalysis;
+
+/* Analyse the code reachable from `entry` (usually PROGRAM_START_ADDRESS)
+ * in `m`. `out` is overwritten; release it with rom_analysis_free(). */
+Chip8Status rom_analyze(const Memory* m, uint16_t entry, RomAnalysis* out);
+
+/* Free the block list; `a` may be analysed into again afterwards. */
+void rom_analysis_free(RomAnalysis* a);
+
+/* Index of the block starting at `addr`, or -1. */
+long rom_analysis_find_block(const RomAnalysis* a, uint16_t addr);
+
+#endif /* CHIP8_ANALYZE_H */
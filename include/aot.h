@@ -0,0 +1,111 @@
+#ifndef CHIP8_AOT_H
+#define CHIP8_AOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "icache.h"   // ICACHE_SPAN
+#include "mem.h"
+#include "quirks.h"
+#include "regs.h"
+
+struct Chip8;
+
+/*
+ * Ahead-of-time translated ROMs.
+ *
+ * chip8_aot turns the code rom_analyze() finds reachable in a ROM into one C
+ * function per ROM. The code is cut into units: runs of straight-line
+ * instructions of which only the last may jump, skip, draw, wait or store
+ * (the decode cache's rule for blocks). Each unit is a label; static jumps
+ * and fall-through go straight to the next label, anything else dispatches
+ * on PC. chip8_run_blocks() enters the function instead of interpreting
+ * while the instance runs the quirks profile the module was translated for,
+ * and the function returns to the interpreter at the first unit that
+ *  - does not fit the remaining cycle budget (units run whole or not at all),
+ *  - is not known to match RAM (see below),
+ *  - was not translated, or
+ *  - heads a wait loop while idle skipping is on (the interpreter
+ *    fast-forwards those).
+ * Results are identical to the interpreter's, cycle for cycle. Unlike the
+ * decode cache, units may start at odd addresses: some ROMs keep all their
+ * code there.
+ *
+ * A write to RAM under a unit (through the memory_* API) marks it unverified;
+ * its bytes are compared once on the next entry, and it runs natively again
+ * if they match (e.g. after a state load restored them).
+ */
+
+#define AOT_SPAN      ICACHE_SPAN          /* code space units may cover */
+#define AOT_MAX_UNITS (AOT_SPAN / 2u)      /* units never overlap and take >= 2 bytes */
+
+/* Run translated units from the current PC for at most `budget` cycles;
+ * returns the cycles run (0 if the unit at PC could not run). */
+typedef uint32_t (*AotRunFn)(struct Chip8* c8, uint32_t budget);
+
+typedef struct {
+    uint16_t start;    /* address of the first instruction */
+    uint16_t bytes;    /* bytes of RAM translated (F000 nnnn takes 4) */
+    uint16_t instrs;   /* cycles the unit accounts for */
+} AotUnit;
+
+typedef struct AotModule {
+    const char*     name;         /* ROM file name */
+    uint64_t        rom_hash;     /* input_log_rom_hash() of the ROM */
+    Chip8Quirks     quirks;       /* profile the units hard-code */
+    const uint8_t*  image;        /* ROM bytes as loaded at PROGRAM_START_ADDRESS */
+    size_t          image_size;
+    const AotUnit*  units;
+    size_t          unit_count;
+    const uint16_t* entry;        /* [pc]: 1 + unit starting at pc, or 0 (AOT_SPAN entries) */
+    const uint16_t* owner;        /* [addr]: 1 + unit covering the byte, or 0 (AOT_SPAN entries) */
+    AotRunFn        run;
+} AotModule;
+
+/* The modules one generated file holds. */
+typedef struct {
+    const AotModule* const* modules;
+    size_t count;
+} AotTable;
+
+/* Per-unit state kept by each instance (struct Chip8::chip8_aot_state). */
+enum {
+    AOT_UNIT_LIVE = 0,     /* RAM matches: run natively */
+    AOT_UNIT_UNVERIFIED,   /* written since the last check: compare on entry */
+    AOT_UNIT_STALE         /* RAM differs: interpret */
+};
+
+#ifdef CHIP8_AOT_GAMES
+/* ROM/GAMES translated at build time (the chip8_aot_games library). */
+extern const AotTable aot_games;
+#endif
+
+/* Module translated from the ROM hashing to `rom_hash`, or NULL. */
+const AotModule* aot_find(const AotTable* table, uint64_t rom_hash);
+
+/* Mark the units overlapping [addr, addr+len) unverified. */
+void aot_invalidate(const AotModule* mod, uint8_t* state, uint16_t addr, size_t len);
+
+/* Resolve an unverified unit against RAM; returns true if it is live. */
+bool aot_verify(const AotModule* mod, uint8_t* state, size_t unit, const Memory* m);
+
+/* Run `mod` from the current PC for at most `budget` cycles, checking the
+ * unit at PC against RAM first if it was written. Returns the cycles run;
+ * 0 means the interpreter has to take this PC. */
+uint32_t aot_enter(struct Chip8* c8, const AotModule* mod, uint32_t budget);
+
+/* Fallback for instructions the translator leaves to the interpreter: decode
+ * `op` under the instance's quirks profile and run its handler. */
+void aot_exec(struct Chip8* c8, uint16_t op);
+
+/* Taken skip, as the interpreter's: step over the whole next instruction,
+ * which is 4 bytes when RAM holds F000 there now. PC points at it. */
+static inline void aot_skip(Registers* regs, const Memory* m) {
+    const uint16_t pc = regs->PC;
+    const bool long_op = (size_t)pc + 1u < MEMORY_SIZE &&
+                         memory_peek(m, pc) == 0xF0 && memory_peek(m, (uint16_t)(pc + 1)) == 0x00;
+    regs->PC = (uint16_t)(pc + (long_op ? 4 : 2));
+}
+
+#endif /* CHIP8_AOT_H */
@@ -13,6 +13,11 @@ bool beep_init(Beeper** out_beeper, int freq_hz, float volume);
 /* Turn beep on/off. */
 void beep_set(Beeper* b, bool on);
 
+/* Play an XO-CHIP sample pattern instead of the tone: 16 bytes = 128 1-bit
+ * samples, MSB first, looped at 4000 * 2^((pitch - 64) / 48) samples per
+ * second. pattern == NULL goes back to the tone. Takes effect immediately. */
+void beep_set_pattern(Beeper* b, const uint8_t* pattern, uint8_t pitch);
+
 /* Destroy. */
 void beep_destroy(Beeper* b);
 
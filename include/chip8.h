@@ -7,6 +7,17 @@
 #include "stack.h"
 #include "keyboard.h"
 #include "screen.h"
+#include "icache.h"
+#include "timer.h"
+#include "quirks.h"
+#include "analyze.h"
+#include "aot.h"
+#ifdef CHIP8_PROFILE
+#include "profile.h"
+#endif
+#ifdef CHIP8_TRACE
+#include "trace.h"
+#endif
 
 struct Chip8 {
     // ram
@@ -23,12 +34,146 @@ struct Chip8 {
 
     // display
     Screen chip8_disp;
+
+    // wall-clock timer accumulator + beep edge state (regs_tick_timers)
+    TimerState chip8_timer;
+
+    // decoded-instruction cache; kept coherent through chip8_mem's write hook,
+    // so RAM must be modified via the memory_* API
+    DecodeCache chip8_icache;
+
+#ifdef CHIP8_PROFILE
+    // per-PC / per-kind execution counts (only in profiler builds)
+    Profile chip8_prof;
+#endif
+
+#ifdef CHIP8_TRACE
+    // binary execution trace, when one is attached (only in trace builds)
+    TraceWriter chip8_trace;
+#endif
+
+    // ahead-of-time translated code for the loaded ROM (NULL: interpret only)
+    // and the state of each of its units for this instance's RAM
+    const AotModule* chip8_aot;
+    uint8_t          chip8_aot_state[AOT_MAX_UNITS];
+
+    // fast-forward provable wait loops in chip8_run_blocks (default on), and
+    // how many cycles that skipped so far
+    bool     chip8_skip_idle;
+    uint64_t chip8_idle_cycles;
 };
 
+/* Reset the machine. `c8` is treated as fresh storage: call chip8_destroy()
+ * first when re-initialising an instance that ran, or its RAM pages leak.
+ * Never copy a struct Chip8 by value; use chip8_fork(). */
 void chip8_init(struct Chip8 *c8);
+/* Release the instance's RAM pages. `c8` must be chip8_init'ed again before reuse. */
+void chip8_destroy(struct Chip8* c8);
+/* Initialise `dst` as an exact copy of `src` that shares its RAM pages
+ * copy-on-write; each side duplicates a page only when it first writes it.
+ * `dst` is fresh storage (as for chip8_init). The decode cache is copied too,
+ * since it describes identical RAM. Forks may run on different threads. */
+void chip8_fork(struct Chip8* dst, const struct Chip8* src);
+/* Seed the instance's Cxkk RNG; the same seed replays the same run.
+ * chip8_init() seeds with 0, so unseeded runs are reproducible too. */
+void chip8_seed(struct Chip8* c8, uint64_t seed);
+
 Chip8Status chip8_load_rom(struct Chip8* c8, const char* filepath);
+
+/* Quirks profile the instance decodes under (CHIP8_QUIRKS_DEFAULT after
+ * chip8_init). Changing it drops the decode cache. */
+void chip8_set_quirks(struct Chip8* c8, Chip8Quirks quirks);
+Chip8Quirks chip8_get_quirks(const struct Chip8* c8);
+/* Profile the ROM database lists for the ROM just loaded into `c8`, or
+ * CHIP8_QUIRKS_DEFAULT when it is not listed. Does not apply it. */
+Chip8Quirks chip8_detect_quirks(const struct Chip8* c8);
+
+/* Decode everything rom_analyze() found reachable into the decode cache and
+ * build the cached blocks at its block leaders, instead of on first
+ * execution. Only even PCs below ICACHE_SPAN are cached. Returns the number
+ * of slots filled. The cache stays coherent as usual afterwards. */
+size_t chip8_predecode(struct Chip8* c8, const RomAnalysis* a);
+
+/* Run the units of `mod` (see aot.h) instead of interpreting them, wherever
+ * RAM still matches; NULL goes back to interpreting everything. The module
+ * only takes effect while the instance runs the quirks profile it was
+ * translated for. Profiler builds always interpret. */
+void chip8_set_aot(struct Chip8* c8, const AotModule* mod);
+
+#ifdef CHIP8_TRACE
+/* Attach a trace opened with trace_open() (NULL detaches). Records staged
+ * for the previous ring are flushed to it first, and the cycle count
+ * restarts at 0. Translated code is not run while a trace is attached. */
+void chip8_set_trace(struct Chip8* c8, TraceRing* ring);
+#endif
+
 Chip8Status chip8_step(struct Chip8* c8);
 
+/* "Run block" mode: execute up to `max_cycles` instructions as a chain of
+ * cached straight-line basic blocks (each ends at its first jump/skip/draw/
+ * key/store instruction). Same results as calling chip8_step() that many
+ * times; *out_executed receives the count actually run (less on error).
+ * Profiles with display wait run a separate copy of the loop that idles out
+ * the budget once a DRW has run, until regs_tick_frame(). */
+Chip8Status chip8_run_blocks(struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed);
+
+/* chip8_run_blocks() that also stops before any instruction, other than the
+ * first, whose address has its bit set in `stop_map` (MEMORY_SIZE bits,
+ * bit a & 63 of word a >> 6; see debug.h). The map is tested once per block
+ * entered, which is then cut short before the first marked address (odd
+ * bits only matter when PC itself is odd, as blocks are even-aligned); wait
+ * loops are fast-forwarded only when none of their addresses is marked.
+ * Translated code is not run. Returns with PC at the marked address, or
+ * with the budget spent. */
+Chip8Status chip8_run_until(struct Chip8* c8, uint32_t max_cycles, const uint64_t* stop_map,
+                            uint32_t* out_executed);
+
+/* Wait loops that chip8_run_blocks() fast-forwards instead of executing:
+ *  - HALT:  `JP addr` to itself, or SCHIP `EXIT`; only a reset ever leaves it
+ *  - TIMER: `LD Vx, DT; SE/SNE Vx, kk; JP back` still waiting on DT; nothing
+ *           changes before the next DT tick
+ *  - KEY:   `LD Vx, K` with no key down; nothing changes before a key press
+ *  - VBLANK: display-wait profiles after a DRW; idle until the next tick
+ * Whole loop iterations are skipped and their register effects applied at
+ * once, so results are identical to plain execution, cycle for cycle. */
+typedef enum {
+    CHIP8_IDLE_NONE = 0,
+    CHIP8_IDLE_HALT,
+    CHIP8_IDLE_TIMER,
+    CHIP8_IDLE_KEY,
+    CHIP8_IDLE_VBLANK
+} Chip8Idle;
+
+/* Which wait loop, if any, the instruction at PC is spinning in right now. */
+Chip8Idle chip8_idle_state(const struct Chip8* c8);
+
+/* One 60 Hz frame: run `cycles_per_frame` instructions, then tick DT/ST once.
+ * Timers are not ticked if execution stops early on an error. */
+Chip8Status chip8_run_frame(struct Chip8* c8, uint32_t cycles_per_frame, uint32_t* out_executed);
+
+/* ============================
+ * Save states (src/savestate.c)
+ * ============================
+ * Versioned little-endian binary blob holding registers, RNG, stack, keys,
+ * timer state, SCHIP mode and flags, XO-CHIP planes and audio, the packed
+ * screen planes (blank rows omitted) and RAM. RAM is stored as runs of bytes
+ * that differ from `base` (MEMORY_SIZE bytes, typically the RAM right after
+ * chip8_load_rom, or a shared warm-start image); base == NULL means an
+ * all-zero image. The same base must be passed to chip8_load_state; its
+ * hash is recorded and checked. The decode cache is rebuilt lazily.
+ */
+#define CHIP8_STATE_VERSION  3u
+#define CHIP8_STATE_MAX_SIZE (192u + (size_t)SCREEN_PLANES * HIRES_HEIGHT * 16u + 3u * (size_t)MEMORY_SIZE)
+
+Chip8Status chip8_save_state(const struct Chip8* c8, const uint8_t* base,
+                             uint8_t* buf, size_t cap, size_t* out_len);
+
+/* Restores into `c8` (which must have been chip8_init'ed). On error `c8` is
+ * left untouched, except that CHIP8_ERR_OUT_OF_MEMORY may leave RAM partially
+ * restored. */
+Chip8Status chip8_load_state(struct Chip8* c8, const uint8_t* base,
+                             const uint8_t* buf, size_t len);
+
 void dump_n(const struct Chip8* c8,
                   uint16_t start_addr,
                   size_t   nbytes,
@@ -36,4 +181,7 @@ void dump_n(const struct Chip8* c8,
 #define mem_dump(c8, start_addr, nbytes) \
     dump_n((c8), (start_addr), (nbytes), 4) /* 1 word == 2 bytes, 4 words per line by default */
 
+/* Like dump_n, but one disassembled instruction per line (see disasm.h). */
+void disasm_n(const struct Chip8* c8, uint16_t start_addr, size_t nbytes);
+
 #endif // CHIP8_H
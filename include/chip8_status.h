@@ -17,6 +17,19 @@ typedef enum Chip8Status {
     CHIP8_ERR_PIXEL_SET_FAILURE,
     CHIP8_ERR_ROM_OPEN,            /* failed to open ROM file */
     CHIP8_ERR_ROM_READ,            /* failed to read ROM */   
+    CHIP8_ERR_BUFFER_TOO_SMALL,    /* caller buffer cannot hold the output */
+    CHIP8_ERR_STATE_INVALID,       /* save-state blob malformed or wrong version */
+    CHIP8_ERR_STATE_BASE_MISMATCH, /* save-state was taken against another base image */
+    CHIP8_ERR_OUT_OF_MEMORY,       /* allocation failed (copy-on-write RAM page) */
+    CHIP8_ERR_REWIND_EMPTY,        /* no older frame left in the rewind history */
+    CHIP8_ERR_FILE_OPEN,           /* failed to open a (non-ROM) file */
+    CHIP8_ERR_FILE_IO,             /* short read/write on a (non-ROM) file */
+    CHIP8_ERR_REPLAY_INVALID,      /* input recording malformed or wrong version */
+    CHIP8_ERR_REPLAY_ROM_MISMATCH, /* input recording was made with another ROM */
+    CHIP8_ERR_TRACE_INVALID,       /* execution trace malformed or wrong version */
+    CHIP8_ERR_DEBUG_FULL,          /* no room for another breakpoint */
+    CHIP8_ERR_DEBUG_ODD_ADDR,      /* breakpoint at an odd address */
+    CHIP8_ERR_REPLAY_QUIRKS_MISMATCH, /* input recording was made with another quirks profile */
 } Chip8Status;
 
 /* Convert status to a short, stable string. */
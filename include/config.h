@@ -14,6 +14,9 @@ extern const char *EMULATOR_WINDOW_TITLE;
 #define EMULATOR_WINDOW_SCALER 10
 #define DISPLAY_WIDTH          64
 #define DISPLAY_HEIGHT         32
+#define HIRES_WIDTH            128   // SCHIP high-resolution mode (00FF)
+#define HIRES_HEIGHT           64
+#define SCREEN_PLANES          2     // XO-CHIP bitplanes (Fn01)
 
 /* ============================
  * Register configuration
@@ -29,9 +32,11 @@ extern const char *EMULATOR_WINDOW_TITLE;
  * Memory configuration
  * ============================ */
 enum {
-    MEMORY_SIZE = 4096,             // ram size
+    MEMORY_SIZE = 0x10000,          // ram size: XO-CHIP's full 16-bit address space
     PROGRAM_START_ADDRESS = 0x200,  // program loader addr
     FONT_START_ADDR = 0x50,         // fontset conventional start addr
+    BIG_FONT_START_ADDR = 0x100,    // SCHIP 8x10 digits 0-9 (Fx30)
+    BIG_SPRITE_HEIGHT = 10u,        // height of a big font digit
     DEFAULT_SPRITE_HIGHT = 5u       // default height of sprite
 };
 
@@ -41,6 +46,12 @@ enum {
 #define CPU_CLOCK_HZ   500  // Hz
 #define TIMER_CLOCK_HZ 60   // Hz
 
+/* ============================
+ * Audio configuration (XO-CHIP)
+ * ============================ */
+#define AUDIO_PATTERN_BYTES 16   // 128 1-bit samples, loaded by F002
+#define AUDIO_PITCH_DEFAULT 64   // Fx3A pitch that plays the pattern at 4000 Hz
+
 /* ============================
  * Input configuration
  * ============================ */
@@ -0,0 +1,131 @@
+#ifndef CHIP8_DEBUG_H
+#define CHIP8_DEBUG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "chip8_status.h"
+
+struct Chip8;
+
+/*
+ * Breakpoints and watchpoints around the interpreter. debug_run() drives
+ * the machine itself, so a run without it pays nothing.
+ *
+ * Breakpoints live in a bitmap with one bit per address. With only
+ * breakpoints set, debug_run() hands the bitmap to chip8_run_until(), the
+ * block loop testing the bits covering each basic block as it enters it; a
+ * run that never hits one stays close to block-mode speed. A breakpoint may
+ * carry a condition on a register, tested only when its bit is hit.
+ *
+ * Watchpoints (memory reads by Dxyn/Fx65/5xy3/F002, writes by Fx33/Fx55/
+ * 5xy2) need the I register each access uses, so while any is set the run
+ * single-steps and checks the instruction about to execute, without idle-loop
+ * fast-forwarding.
+ *
+ * Stops happen before the instruction at the breakpoint, or the access, runs.
+ * The next debug_run() executes that instruction without checking it again,
+ * so "continue" makes progress. Translated (AOT) code is not run.
+ */
+#define DEBUG_MAX_BREAKS 64u
+#define DEBUG_MAP_WORDS  ((size_t)MEMORY_SIZE / 64u)
+
+/* Registers a condition can test: V0..VF are 0..15. */
+enum { DEBUG_REG_I = 16, DEBUG_REG_DT, DEBUG_REG_ST, DEBUG_REG_COUNT };
+
+typedef enum {
+    DEBUG_CMP_NONE = 0,   /* unconditional */
+    DEBUG_CMP_EQ, DEBUG_CMP_NE, DEBUG_CMP_LT, DEBUG_CMP_LE, DEBUG_CMP_GT, DEBUG_CMP_GE
+} DebugCmp;
+
+typedef struct {
+    uint8_t  reg;     /* DEBUG_REG_* or 0..15 */
+    uint8_t  cmp;     /* DebugCmp */
+    uint16_t value;
+} DebugCond;
+
+typedef struct {
+    uint16_t  addr;
+    DebugCond cond;
+} DebugBreak;
+
+enum { DEBUG_WATCH_READ = 1u, DEBUG_WATCH_WRITE = 2u };
+
+typedef enum {
+    DEBUG_STOP_NONE = 0,     /* the cycle budget ran out */
+    DEBUG_STOP_BREAK,
+    DEBUG_STOP_WATCH_READ,
+    DEBUG_STOP_WATCH_WRITE
+} DebugStop;
+
+typedef struct {
+    DebugStop reason;
+    uint16_t  pc;      /* instruction about to execute */
+    uint16_t  addr;    /* first watched address it accesses (watch stops) */
+} DebugEvent;
+
+typedef struct {
+    uint64_t   break_map[DEBUG_MAP_WORDS];
+    uint64_t   read_map[DEBUG_MAP_WORDS];
+    uint64_t   write_map[DEBUG_MAP_WORDS];
+    DebugBreak breaks[DEBUG_MAX_BREAKS];
+    size_t     break_count;
+    size_t     watch_count;   /* addresses watched (either way) */
+
+    bool       resume;        /* the last run stopped at resume_pc */
+    uint16_t   resume_pc;
+} Debugger;
+
+void debug_init(Debugger* d);
+
+/* Break before the instruction at `addr` when `cond` holds (NULL: always).
+ * Setting a breakpoint again replaces its condition.
+ * CHIP8_ERR_DEBUG_FULL past DEBUG_MAX_BREAKS; CHIP8_ERR_DEBUG_ODD_ADDR for
+ * an odd `addr` (instructions sit at even addresses; name the one holding
+ * the byte instead). */
+Chip8Status debug_set_break(Debugger* d, uint16_t addr, const DebugCond* cond);
+/* Returns false if there was no breakpoint at `addr`. */
+bool debug_clear_break(Debugger* d, uint16_t addr);
+
+/* Watch [addr, addr+len) for `kinds` (DEBUG_WATCH_READ | DEBUG_WATCH_WRITE);
+ * on == false stops watching those kinds. The range must fit in RAM. */
+Chip8Status debug_watch(Debugger* d, uint16_t addr, size_t len, unsigned kinds, bool on);
+
+/* Whether any bit of [addr, addr+len) is set in a one-bit-per-address map;
+ * the range is clipped to RAM. One word test per 64 addresses. */
+static inline bool debug_map_any(const uint64_t* map, uint32_t addr, uint32_t len) {
+    if (addr >= MEMORY_SIZE) return false;
+    if (len > MEMORY_SIZE - addr) len = MEMORY_SIZE - addr;
+    while (len) {
+        const uint32_t bit  = addr & 63u;
+        const uint32_t n    = (len < 64u - bit) ? len : 64u - bit;
+        const uint64_t mask = (n == 64u) ? ~0ull : ((1ull << n) - 1u) << bit;
+        if (map[addr >> 6] & mask) return true;
+        addr += n;
+        len  -= n;
+    }
+    return false;
+}
+
+static inline bool debug_map_test(const uint64_t* map, uint16_t addr) {
+    return (map[addr >> 6] >> (addr & 63u)) & 1u;
+}
+
+static inline bool debug_has_break(const Debugger* d, uint16_t addr) {
+    return debug_map_test(d->break_map, addr);
+}
+
+/* Whether `cond` holds for the registers of `c8`. */
+bool debug_cond_holds(const struct Chip8* c8, const DebugCond* cond);
+
+/* Run up to `max_cycles` cycles like chip8_run_blocks() (same results) until
+ * a breakpoint or watchpoint stops it. With breakpoints only, idle loops are
+ * fast-forwarded as there; any watchpoint forces single-stepping through
+ * chip8_step(), which executes wait loops instruction by instruction instead
+ * (final state matches, speed and chip8_idle_cycles do not).
+ * *out_executed receives the cycles run; `ev` (may be NULL) why it stopped. */
+Chip8Status debug_run(Debugger* d, struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed,
+                      DebugEvent* ev);
+
+#endif /* CHIP8_DEBUG_H */
@@ -0,0 +1,36 @@
+#ifndef CHIP8_DISASM_H
+#define CHIP8_DISASM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mem.h"
+
+/*
+ * Listing of a RAM range, one instruction per line:
+ *
+ *     0x200: 00E0       CLS
+ *     0x206: F000 1234  LD I, 0x1234
+ *
+ * Mnemonics come from instr_disasm(), so the listing decodes exactly like
+ * the interpreter. Lines are formatted into the caller's buffer with no
+ * stdio or allocation, for tools that list code on hot paths (profiler
+ * reports, trace decoders, debuggers).
+ */
+
+/* Longest line disasm_range() writes, newline included. */
+#define DISASM_LINE_MAX 48
+
+/* Disassemble [start, start + nbytes) (clamped to RAM) into `buf`, stopping
+ * before the first line that does not fit; `buf` is NUL-terminated when
+ * cap > 0. Returns the characters written, excluding the NUL, and the
+ * address listing should resume at in *out_next (may be NULL). F000 nnnn
+ * takes one 4-byte line; a lone trailing byte is listed as DB. */
+size_t disasm_range(const Memory* m, uint16_t start, size_t nbytes, char* buf, size_t cap, size_t* out_next);
+
+/* The line for the instruction at `addr`, without the newline, into `line`
+ * (NUL-terminated) and its length into *out_len (may be NULL). Returns the
+ * bytes of RAM it covers: 2, 4 for F000 nnnn, 1 for the last byte of RAM
+ * (0 only for NULL arguments). */
+size_t disasm_line(const Memory* m, uint16_t addr, char line[DISASM_LINE_MAX], size_t* out_len);
+
+#endif /* CHIP8_DISASM_H */
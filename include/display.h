@@ -0,0 +1,27 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdbool.h>
+#include "screen.h"
+
+/* Opaque SDL window + renderer; SDL3 details are hidden in display.c.
+ * The framebuffer lives in a streaming texture per resolution (64x32 and
+ * SCHIP 128x64); the current one is scaled to the window in a single draw call.
+ * The two XO-CHIP planes are composed into four colours as rows are uploaded. */
+typedef struct Display Display;
+
+/* Create a resizable window of DISPLAY_WIDTH*scale x DISPLAY_HEIGHT*scale. */
+bool display_init(Display** out_display, const char* title, int scale);
+
+/* Enable/disable vsync on present. Returns false if the renderer refused. */
+bool display_set_vsync(Display* d, bool on);
+
+/* Upload the rows of `scr` marked dirty (consuming them) and present.
+ * With force=false nothing is drawn when no row is dirty.
+ * Returns true if a frame was presented. */
+bool display_update(Display* d, Screen* scr, bool force);
+
+/* Destroy. */
+void display_destroy(Display* d);
+
+#endif /* DISPLAY_H */
@@ -0,0 +1,59 @@
+#ifndef CHIP8_ICACHE_H
+#define CHIP8_ICACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "instr.h"
+#include "mem.h"
+
+/*
+ * Decoded-instruction cache, one slot per even PC below ICACHE_SPAN.
+ * A slot is filled lazily on first execution and emptied whenever one of its
+ * two bytes is written through the Memory API (see memory_set_write_hook).
+ * Odd PCs are never cached; callers decode those on the fly.
+ *
+ * Jumps and calls take 12-bit targets, so programs only run above 0x0FFF by
+ * falling through; RAM above that is XO-CHIP data. The cache covers the
+ * first 4 KB only and PCs beyond it are decoded on the fly as well.
+ *
+ * On top of the slots, block_len[] records straight-line basic blocks: the
+ * block entered at even PC `p` is the block_len[p >> 1] consecutive slots
+ * starting at p, ending at the first instr_ends_block() instruction. Blocks
+ * are threaded code over the slots, so they share the slots' invalidation.
+ */
+#define ICACHE_MAX_BLOCK 32u       /* max instructions per block */
+#define ICACHE_SPAN      0x1000u   /* bytes of code space covered */
+
+typedef struct {
+    Instr   slots[ICACHE_SPAN / 2];
+    uint8_t block_len[ICACHE_SPAN / 2];   /* 0 = block not built yet */
+    Chip8Quirks quirks;                   /* profile the slots were decoded for */
+} DecodeCache;
+
+/* Empty every slot. The quirks profile is kept. */
+void icache_init(DecodeCache* c);
+
+/* Decode under `quirks` from now on; empties every slot if it changed. */
+void icache_set_quirks(DecodeCache* c, Chip8Quirks quirks);
+
+/* Empty the slots overlapping [addr, addr+len) and every block containing them. */
+void icache_invalidate(DecodeCache* c, uint16_t addr, size_t len);
+
+/* Return the decoded instruction at even `pc`, decoding from `m` on a miss.
+ * Caller guarantees pc is even and pc + 1 < ICACHE_SPAN. */
+static inline const Instr* icache_fetch(DecodeCache* c, const Memory* m, uint16_t pc) {
+    Instr* in = &c->slots[pc >> 1];
+    if (!in->fn) {
+        instr_decode_quirks((uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1))),
+                            c->quirks, in);
+    }
+    return in;
+}
+
+/* Return the number of instructions in the block entered at even `pc`,
+ * building it (and decoding its slots) on a miss. Always >= 1.
+ * Same preconditions as icache_fetch(). */
+uint8_t icache_block(DecodeCache* c, const Memory* m, uint16_t pc);
+
+#endif /* CHIP8_ICACHE_H */
@@ -1,12 +1,15 @@
 #ifndef INSTR_H
 #define INSTR_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "regs.h"
 #include "mem.h"
 #include "screen.h"
 #include "stack.h"
 #include "keyboard.h"
+#include "quirks.h"
 
 /* Instruction field helpers */
 #define OP_NNN(op) ((uint16_t)((op) & 0x0FFF))          /* 12-bit addr   */
@@ -15,9 +18,76 @@
 #define OP_KK(op)  ((uint8_t)((op) & 0x00FF))           /* 8-bit const   */
 #define OP_N(op)   ((uint8_t)((op) & 0x000F))           /* low nibble    */
 
+typedef struct Instr Instr;
+
+/* Handler for one decoded instruction. Operands come pre-extracted in `in`. */
+typedef void (*InstrHandler)(const Instr* in,
+                             Registers* regs,
+                             Memory* mem,
+                             Screen* screen,
+                             Stack* stack,
+                             Keyboard* keyboard);
+
+/* Pre-decoded instruction: handler pointer plus operands extracted once. */
+struct Instr {
+    InstrHandler fn;    /* NULL marks an empty decode-cache slot */
+    uint16_t     op;    /* raw opcode (for logging) */
+    uint16_t     nnn;
+    uint8_t      x;
+    uint8_t      y;
+    uint8_t      kk;
+    uint8_t      n;
+};
+
+/* Instruction kinds: one per handler, shared by decode and tooling. */
+typedef enum {
+    INSTR_CLS, INSTR_RET, INSTR_SYS, INSTR_JP, INSTR_CALL,
+    INSTR_SE_IMM, INSTR_SNE_IMM, INSTR_SE_REG, INSTR_SNE_REG, INSTR_JP_V0,
+    INSTR_LD_IMM, INSTR_ADD_IMM, INSTR_LD_REG, INSTR_OR, INSTR_AND, INSTR_XOR,
+    INSTR_ADD_REG, INSTR_SUB, INSTR_SHR, INSTR_SUBN, INSTR_SHL,
+    INSTR_LD_I, INSTR_RND, INSTR_DRW, INSTR_SKP, INSTR_SKNP,
+    INSTR_LD_VX_DT, INSTR_LD_KEY, INSTR_LD_DT, INSTR_LD_ST, INSTR_ADD_I,
+    INSTR_LD_F, INSTR_BCD, INSTR_ST_REGS, INSTR_LD_REGS,
+    /* SUPER-CHIP */
+    INSTR_SCD, INSTR_SCR, INSTR_SCL, INSTR_EXIT, INSTR_LOW, INSTR_HIGH,
+    INSTR_LD_HF, INSTR_ST_RPL, INSTR_LD_RPL,
+    /* XO-CHIP */
+    INSTR_SCU, INSTR_LD_LONG, INSTR_ST_RANGE, INSTR_LD_RANGE, INSTR_PLANE,
+    INSTR_AUDIO, INSTR_PITCH,
+    INSTR_UNKNOWN,
+    INSTR_KIND_COUNT
+} InstrKind;
+
+/* Classify `opcode`; instr_decode() picks its handler from the same result. */
+InstrKind instr_kind(uint16_t opcode);
+
+/* Mnemonic with operand placeholders, e.g. "LD Vx, DT". */
+const char* instr_kind_name(InstrKind kind);
+
+/* Longest instr_disasm() text, NUL included. */
+#define INSTR_DISASM_MAX 24
+
+/* Disassemble `opcode` with its operands, e.g. "LD V3, 0x2A", into `buf`
+ * (truncated to `cap`, always NUL-terminated when cap > 0). Driven by the
+ * same kind table as decode; undecodable words come out as "DW 0x8128".
+ * Returns the full length, excluding the NUL, like snprintf. */
+size_t instr_disasm(uint16_t opcode, char* buf, size_t cap);
+
+/* Decode `opcode` into `out` (never fails; unknown opcodes get a logging handler). */
+void instr_decode(uint16_t opcode, Instr* out);
+
+/* instr_decode() under a quirks profile: quirky kinds get the handler variant
+ * that hard-codes the profile's behaviour (instr_decode uses the default). */
+void instr_decode_quirks(uint16_t opcode, Chip8Quirks quirks, Instr* out);
+
+/* True if `in` may change control flow, wait, draw, or write memory, i.e. it
+ * must be the last instruction of a straight-line basic block. */
+bool instr_ends_block(const Instr* in);
+
 /* Execute a single opcode.
  * NOTE:
  *  - step (PC + 2) is delegated to caller of this function
+ *  - equivalent to instr_decode() followed by a call through Instr::fn
  */
 void exec(uint16_t opcode,
         Registers* regs,
@@ -4,18 +4,96 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>   // memcpy, memcmp (inline fast paths)
 #include "config.h"
 #include "chip8_status.h"
 
+/* Optional observer notified after [addr, addr+len) changed through this API
+ * (used to invalidate decoded-instruction caches on self-modifying writes). */
+typedef void (*MemoryWriteHook)(void* ctx, uint16_t addr, size_t len);
+
+/*
+ * RAM covers the whole 16-bit address space (XO-CHIP), so single-byte
+ * accesses are always in range; only blocks can run past the end.
+ * It is split into fixed-size refcounted pages shared copy-on-write between
+ * forks (memory_fork). A page is duplicated the first time a shared page is
+ * written, so a fork costs MEM_PAGE_COUNT pointer copies plus the pages it
+ * later dirties. Untouched pages of a fresh machine point at static zero/font
+ * pages and are never allocated.
+ *
+ * Reads may go through memory_peek()/memory_read(); every write must go
+ * through memory_write*() so sharing and the write hook stay correct.
+ * A Memory must not be copied by value: use memory_fork().
+ */
+#define MEM_PAGE_SHIFT 8u
+#define MEM_PAGE_SIZE  (1u << MEM_PAGE_SHIFT)
+#define MEM_PAGE_MASK  (MEM_PAGE_SIZE - 1u)
+#define MEM_PAGE_COUNT ((size_t)MEMORY_SIZE / MEM_PAGE_SIZE)
+
+typedef struct MemPage MemPage;    /* refcounted page, private to mem.c */
+
 typedef struct {
-    uint8_t memory[MEMORY_SIZE];
+    MemPage*       pages[MEM_PAGE_COUNT];
+    const uint8_t* bytes[MEM_PAGE_COUNT];   /* pages[i]'s data, for inline reads */
+
+    MemoryWriteHook on_write;      /* NULL = no observer */
+    void*           on_write_ctx;
 } Memory;
 
+/* Point every page at the shared zero/font pages. Does not release pages the
+ * struct may already hold: use memory_reset() or memory_release() for that. */
 void memory_init (Memory* m);
+/* Release all pages and zero the whole address space (font included). */
 void memory_reset(Memory* m);
+/* Drop this Memory's page references; it reads as all zeroes afterwards. */
+void memory_release(Memory* m);
+
+/* Make `dst` share all of `src`'s pages. `dst` must not hold pages (fresh or
+ * released); its write hook is cleared. Never allocates. */
+void memory_fork(Memory* dst, const Memory* src);
+
+/* Install (or clear, with hook == NULL) the write observer. */
+void memory_set_write_hook(Memory* m, MemoryWriteHook hook, void* ctx);
+
+/* Unchecked read (every uint16_t address is valid). */
+static inline uint8_t memory_peek(const Memory* m, uint16_t addr) {
+    return m->bytes[addr >> MEM_PAGE_SHIFT][addr & MEM_PAGE_MASK];
+}
 
 Chip8Status memory_read     (const Memory* m, uint16_t addr, uint8_t* out_value);
 Chip8Status memory_write    (Memory* m, uint16_t addr, uint8_t value);
 Chip8Status memory_load_rom (Memory* m, const uint8_t* data, size_t size);
 
+/* Copy [addr, addr+len) out into `dst`. */
+Chip8Status memory_read_block (const Memory* m, uint16_t addr, uint8_t* dst, size_t len);
+/* Copy `src` into [addr, addr+len). Pages whose contents already match are
+ * left alone (and stay shared). The hook sees one call for the whole range,
+ * and none if nothing changed. */
+Chip8Status memory_write_block(Memory* m, uint16_t addr, const uint8_t* src, size_t len);
+
+/* Interpreter fast paths (Fx33/Fx55/Fx65): no NULL checks, the range is
+ * validated once, and the copy is all-or-nothing. Both return false, touching
+ * nothing, if [addr, addr+len) does not fit in RAM. The common single-page
+ * case is a bounds check plus memcpy/memcmp. Other callers should use the
+ * checked API above. */
+static inline bool memory_load_fast(const Memory* m, uint16_t addr, uint8_t* dst, size_t len) {
+    if ((size_t)addr + len > MEMORY_SIZE) return false;
+    const size_t off = addr & MEM_PAGE_MASK;
+    if (off + len <= MEM_PAGE_SIZE) {
+        memcpy(dst, m->bytes[addr >> MEM_PAGE_SHIFT] + off, len);
+        return true;
+    }
+    return memory_read_block(m, addr, dst, len) == CHIP8_OK;
+}
+
+/* Storing bytes that are already there is a no-op: no page copy, no hook call. */
+static inline bool memory_store_fast(Memory* m, uint16_t addr, const uint8_t* src, size_t len) {
+    if ((size_t)addr + len > MEMORY_SIZE) return false;
+    const size_t off = addr & MEM_PAGE_MASK;
+    if (off + len <= MEM_PAGE_SIZE && memcmp(m->bytes[addr >> MEM_PAGE_SHIFT] + off, src, len) == 0) {
+        return true;
+    }
+    return memory_write_block(m, addr, src, len) == CHIP8_OK;
+}
+
 #endif /* CHIP8_MEM_H */
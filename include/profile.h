@@ -0,0 +1,63 @@
+#ifndef CHIP8_PROFILE_H
+#define CHIP8_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+#include "instr.h"
+#include "keyboard.h"
+#include "mem.h"
+#include "regs.h"
+
+/*
+ * Cycle-accounting profiler. The interpreter only calls prof_record() when
+ * the core is built with CHIP8_PROFILE (CMake: -DCHIP8_ENABLE_PROFILER=ON);
+ * otherwise the hooks compile to nothing and struct Chip8 has no Profile.
+ */
+
+/* Two DT reads at the same PC at most this many cycles apart count as a poll loop. */
+#define PROF_DT_POLL_SPAN 16u
+
+typedef struct {
+    uint64_t cycles;                        /* instructions recorded */
+    uint64_t pc_count[MEMORY_SIZE];         /* executions per address */
+    uint64_t kind_count[INSTR_KIND_COUNT];  /* executions per instruction kind */
+
+    uint64_t key_wait_cycles;   /* Fx0A executions that found no key down */
+    uint64_t dt_wait_cycles;    /* cycles between repeated Fx07 reads of a non-zero DT */
+
+    uint16_t dt_poll_pc;        /* PC of the last Fx07 that read DT > 0 (0xFFFF = none) */
+    uint64_t dt_poll_cycle;
+} Profile;
+
+void prof_init(Profile* p);
+
+/* Account one instruction at `pc`, called just before it executes. */
+static inline void prof_record(Profile* p, uint16_t pc, const Instr* in,
+                               const Registers* regs, const Keyboard* kbd) {
+    const InstrKind kind = instr_kind(in->op);
+    p->pc_count[pc]++;
+    p->kind_count[kind]++;
+
+    if (kind == INSTR_LD_KEY) {
+        uint8_t key;
+        if (keyboard_first_pressed(kbd, &key) != CHIP8_OK) p->key_wait_cycles++;
+    } else if (kind == INSTR_LD_VX_DT) {
+        if (regs->DT == 0) {
+            p->dt_poll_pc = 0xFFFF;
+        } else {
+            if (pc == p->dt_poll_pc && p->cycles - p->dt_poll_cycle <= PROF_DT_POLL_SPAN) {
+                p->dt_wait_cycles += p->cycles - p->dt_poll_cycle;
+            }
+            p->dt_poll_pc    = pc;
+            p->dt_poll_cycle = p->cycles;
+        }
+    }
+    p->cycles++;
+}
+
+/* Print totals, wait-loop shares, per-kind counts and the `top_n` hottest
+ * addresses (with the opcode currently at each, disassembled) to `out`. */
+void prof_report(const Profile* p, const Memory* m, FILE* out, size_t top_n);
+
+#endif /* CHIP8_PROFILE_H */
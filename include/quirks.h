@@ -0,0 +1,49 @@
+#ifndef CHIP8_QUIRKS_H
+#define CHIP8_QUIRKS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Quirks profiles: the behaviours CHIP-8 interpreters historically disagree on.
+ * A profile is applied at decode time (instr_decode_quirks): each quirk has
+ * its own handler variant, so the executing loop never tests a quirk flag.
+ * The only loop-level quirk, display wait, gets its own copy of the block
+ * loop in chip8_run_blocks().
+ */
+typedef enum {
+    CHIP8_QUIRKS_DEFAULT = 0,   /* this emulator's original mix (see README) */
+    CHIP8_QUIRKS_VIP,           /* COSMAC VIP CHIP-8 */
+    CHIP8_QUIRKS_CHIP48,        /* HP-48 CHIP-48 */
+    CHIP8_QUIRKS_SCHIP,         /* SUPER-CHIP 1.1 */
+    CHIP8_QUIRKS_XOCHIP,        /* XO-CHIP (Octo) */
+    CHIP8_QUIRKS_COUNT
+} Chip8Quirks;
+
+/* How Fx55 / Fx65 leave I behind. */
+typedef enum {
+    QUIRK_INDEX_INC,            /* I += x + 1 */
+    QUIRK_INDEX_INC_X,          /* I += x (CHIP-48's off-by-one) */
+    QUIRK_INDEX_KEEP            /* I unchanged */
+} QuirkIndex;
+
+typedef struct {
+    const char* name;           /* as accepted by quirks_from_name() */
+    bool    vf_reset;           /* 8xy1/8xy2/8xy3 clear VF */
+    bool    shift_vy;           /* 8xy6/8xyE shift Vy into Vx (else Vx in place) */
+    uint8_t index;              /* QuirkIndex for Fx55/Fx65 */
+    bool    jump_vx;            /* Bxnn jumps to xnn + Vx (else Bnnn: nnn + V0) */
+    bool    display_wait;       /* DRW idles the CPU until the next 60 Hz tick */
+} QuirksProfile;
+
+/* Profile description; out-of-range values give the default profile. */
+const QuirksProfile* quirks_profile(Chip8Quirks q);
+
+/* Parse a profile name ("default", "vip", "chip48", "schip", "xochip"). */
+bool quirks_from_name(const char* name, Chip8Quirks* out);
+
+/* Look up a ROM in the built-in database by input_log_rom_hash() of the
+ * freshly loaded RAM. Returns false (leaving *out alone) for unknown ROMs. */
+bool quirks_lookup_rom(uint64_t rom_hash, Chip8Quirks* out);
+
+#endif /* CHIP8_QUIRKS_H */
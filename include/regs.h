@@ -2,7 +2,9 @@
 #define CHIP8_REGS_H
 
 #include "config.h"
+#include "rng.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef struct {
     uint8_t V[NUM_REGS];      // 16 general purpose 8-bit registers (V0-VF)
@@ -13,6 +15,16 @@ typedef struct {
 
     uint8_t DT;                     // 8-bit delay timer
     uint8_t ST;                     // 8-bit sound timer
+
+    uint8_t RPL[NUM_REGS];          // SCHIP user flags (Fx75 / Fx85)
+
+    uint8_t pattern[AUDIO_PATTERN_BYTES];  // XO-CHIP audio samples, MSB first (F002)
+    uint8_t pitch;                  // XO-CHIP pattern playback rate (Fx3A)
+    bool    has_pattern;            // F002 ran: ST plays `pattern` instead of the beep
+
+    bool    vblank_wait;            // display-wait quirk: DRW ran, CPU idles until the next tick
+
+    Rng rng;                        // per-instance RNG state for Cxkk (not a CHIP-8 register)
 } Registers;
 
 void regs_init(Registers* regs);
@@ -0,0 +1,76 @@
+#ifndef CHIP8_REPLAY_H
+#define CHIP8_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "chip8.h"
+#include "chip8_status.h"
+
+/*
+ * Input recordings: every keypad change tagged with the CPU cycle it was
+ * applied before, plus what else a run depends on (RNG seed, ROM hash,
+ * quirks profile, cycles per 60 Hz frame). Replaying the events at the same cycles
+ * reproduces the run bit-exactly, in the SDL frontend or headless.
+ *
+ * File format (little-endian): "C8IR" u16 version u8 quirks u8 reserved
+ * u64 seed u64 rom_hash u32 cycles_per_frame u64 end_cycle u32 count, then
+ * per event a LEB128 cycle delta and one byte (key | 0x10 if pressed).
+ */
+#define INPUT_LOG_VERSION 2u
+
+typedef struct {
+    uint64_t cycle;   /* applied before this cycle executes */
+    uint8_t  key;     /* 0x0..0xF */
+    bool     down;
+} InputEvent;
+
+typedef struct {
+    uint64_t    seed;
+    uint64_t    rom_hash;           /* input_log_rom_hash() right after loading */
+    Chip8Quirks quirks;             /* the resolved profile the run used */
+    uint32_t    cycles_per_frame;
+    uint64_t    end_cycle;          /* length of the recorded run */
+
+    InputEvent* events;             /* sorted by cycle */
+    size_t      count;
+    size_t      cap;
+} InputLog;
+
+/* Start an empty log. */
+void input_log_init(InputLog* log, uint64_t seed, uint64_t rom_hash, Chip8Quirks quirks,
+                    uint32_t cycles_per_frame);
+void input_log_free(InputLog* log);
+
+/* Append an event; `cycle` must not be lower than the previous event's. */
+Chip8Status input_log_append(InputLog* log, uint64_t cycle, uint8_t key, bool down);
+
+/* Write/read a log file. input_log_load() initialises `log` (free it after). */
+Chip8Status input_log_save(const InputLog* log, const char* path);
+Chip8Status input_log_load(InputLog* log, const char* path);
+
+/* FNV-1a over the program area (PROGRAM_START_ADDRESS..end), taken right
+ * after the ROM is loaded; identifies the ROM without re-reading the file. */
+uint64_t input_log_rom_hash(const Memory* m);
+
+/* ---------- replay ---------- */
+
+typedef struct {
+    const InputLog* log;
+    size_t          next;           /* first event not applied yet */
+} InputPlayer;
+
+void input_player_init(InputPlayer* p, const InputLog* log);
+
+/* Apply every event due at or before `cycle` to `kbd`. */
+void input_player_apply(InputPlayer* p, Keyboard* kbd, uint64_t cycle);
+
+/* Cycles from `cycle` until the next pending event (UINT64_MAX when none). */
+uint64_t input_player_until_next(const InputPlayer* p, uint64_t cycle);
+
+/* Replaying counterpart of chip8_run_frame(): run the log's cycles_per_frame
+ * instructions, applying events at their exact cycles, then tick DT/ST once.
+ * `*cycle` is the running cycle counter and is advanced. */
+Chip8Status input_player_run_frame(InputPlayer* p, struct Chip8* c8, uint64_t* cycle);
+
+#endif /* CHIP8_REPLAY_H */
@@ -0,0 +1,42 @@
+#ifndef CHIP8_REWIND_H
+#define CHIP8_REWIND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "chip8.h"
+#include "chip8_status.h"
+
+/*
+ * Rewind history: one snapshot per frame in a fixed-size ring buffer.
+ *
+ * Each record is the XOR of the machine state (RAM, registers incl. RNG,
+ * stack, framebuffer, timer state) against the previously recorded frame,
+ * with zero runs elided, so a typical frame costs tens of bytes. Recording
+ * is O(state size) per frame regardless of history length; when the ring is
+ * full the oldest frames are dropped. The keypad is live input and is never
+ * rewound.
+ */
+typedef struct RewindBuffer RewindBuffer;
+
+/* Allocate a history of `capacity_bytes` (at least a few KB). A frame whose
+ * record would not fit the whole ring starts a new history instead. */
+Chip8Status rewind_init(RewindBuffer** out_rw, size_t capacity_bytes);
+void        rewind_destroy(RewindBuffer* rw);
+
+/* Forget all history; the next record starts a new baseline. */
+void rewind_clear(RewindBuffer* rw);
+
+/* Record the state of `c8` as the newest frame. Call once per frame. */
+Chip8Status rewind_record(RewindBuffer* rw, const struct Chip8* c8);
+
+/* Restore `c8` to the frame recorded before the newest one and drop the
+ * newest. Returns CHIP8_ERR_REWIND_EMPTY when no older frame is left. */
+Chip8Status rewind_step_back(RewindBuffer* rw, struct Chip8* c8);
+
+/* Number of frames rewind_step_back() can currently go back. */
+size_t rewind_frames(const RewindBuffer* rw);
+
+/* Bytes of the ring currently holding frame records. */
+size_t rewind_bytes_used(const RewindBuffer* rw);
+
+#endif /* CHIP8_REWIND_H */
@@ -0,0 +1,28 @@
+#ifndef CHIP8_RNG_H
+#define CHIP8_RNG_H
+
+#include <stdint.h>
+
+/*
+ * Small per-instance PRNG for Cxkk (PCG32, fixed stream).
+ * No shared state and no locks: each emulator owns one, and a given seed
+ * always yields the same sequence on every platform. An all-zero Rng is a
+ * valid (unseeded) state.
+ */
+typedef struct {
+    uint64_t state;
+} Rng;
+
+/* Reset the generator to the sequence selected by `seed`. */
+void rng_seed(Rng* r, uint64_t seed);
+
+/* Next 32 random bits. */
+static inline uint32_t rng_next(Rng* r) {
+    const uint64_t old = r->state;
+    r->state = old * 6364136223846793005ull + 1442695040888963407ull;
+    const uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    const uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+}
+
+#endif /* CHIP8_RNG_H */
@@ -7,38 +7,99 @@
 #include "config.h"
 #include "chip8_status.h"
 
-// Logical 1bpp screen buffer for CHIP-8 (64x32).
-// Pixels are stored row-major as bytes 0/1.
+// Logical screen buffer: 64x32, or 128x64 in SCHIP hi-res mode, with two
+// XO-CHIP bitplanes. Each row is packed into 64-bit words, bit 63 leftmost:
+// rows[y] holds x 0..63 (a whole lo-res row), rows_right[y] x 64..127
+// (hi-res only); rows2/rows2_right are plane 2 in the same layout.
+// A sprite row is a rotate + XOR, so wrap-around on x comes for free, and
+// scrolling is whole-word shifts and row moves. A pixel's colour (0..3) is
+// its plane-1 bit plus twice its plane-2 bit.
 typedef struct {
-    uint8_t pixels[DISPLAY_WIDTH * DISPLAY_HEIGHT];
-    bool    dirty;  // set true whenever any pixel changes
+    uint64_t rows[HIRES_HEIGHT];
+    uint64_t rows_right[HIRES_HEIGHT];
+    uint64_t rows2[HIRES_HEIGHT];
+    uint64_t rows2_right[HIRES_HEIGHT];
+    uint64_t dirty_rows;  // bit y set whenever a pixel in row y changes
+    bool     hires;       // 128x64 (00FF) instead of 64x32 (00FE)
+    uint8_t  planes;      // planes drawn, cleared and scrolled (XO-CHIP Fn01):
+                          // bit 0 = plane 1, bit 1 = plane 2; 1 after init
 } Screen;
 
 // Initialize the screen to all-black.
 void screen_init(Screen* s);
 
-// Clear the screen to black and mark dirty.
+// Clear the selected planes and mark every row dirty.
 void screen_clear(Screen* s);
 
-// Get pixel at (x, y) with wrapping. Returns 0 or 1.
+// Switch between 64x32 and 128x64. Switching clears both planes (even if the
+// mode does not change, like SCHIP's 00FE/00FF).
+void screen_set_hires(Screen* s, bool hires);
+
+// Select the planes later draws, clears and scrolls apply to (bits 0-1).
+void screen_select_planes(Screen* s, uint8_t mask);
+
+// Number of selected planes (0..2): a sprite holds this many images.
+uint8_t screen_plane_count(const Screen* s);
+
+// Current resolution.
+uint8_t screen_width (const Screen* s);
+uint8_t screen_height(const Screen* s);
+
+// Get the plane-1 pixel at (x, y) with wrapping. Returns 0 or 1.
 uint8_t screen_get_pixel(const Screen* s, uint8_t x, uint8_t y);
 
-// Set pixel at (x, y) to val (0/1) with wrapping.
+// Get the colour of (x, y) with wrapping: plane 1 + 2 * plane 2, 0..3.
+uint8_t screen_get_color(const Screen* s, uint8_t x, uint8_t y);
+
+// Set the plane-1 pixel at (x, y) to val (0/1) with wrapping.
 Chip8Status screen_set_pixel(Screen* s, uint8_t x, uint8_t y, uint8_t val);
 
-// Toggle (XOR) pixel at (x, y) with wrapping.
+// Toggle (XOR) the plane-1 pixel at (x, y) with wrapping.
 // Returns true if this operation caused a collision (1 -> 0).
 bool screen_toggle_pixel(Screen* s, uint8_t x, uint8_t y);
 
-// Draw an N-byte sprite located at memory `sprite` at (x, y).
-// Each sprite byte encodes one row, MSB is the leftmost pixel.
+// Draw an N-byte sprite located at memory `sprite` at (x, y) into each
+// selected plane. Each sprite byte encodes one row, MSB is the leftmost
+// pixel. With both planes selected `sprite` holds 2*N bytes: plane 1's
+// image, then plane 2's.
 // Returns true if any collision occurred (CHIP-8 VF semantics).
 bool screen_draw_sprite(Screen* s, uint8_t x, uint8_t y, const uint8_t* sprite, uint8_t n);
 
-// Get a const pointer to the raw pixel buffer.
-const uint8_t* screen_pixels(const Screen* s);
+// Draw a 16x16 sprite (SCHIP Dxy0): 32 bytes, two per row, big-endian,
+// per selected plane (as above). Returns true if any collision occurred.
+bool screen_draw_sprite16(Screen* s, uint8_t x, uint8_t y, const uint8_t* sprite);
+
+// Scroll the selected planes by n pixels of the current resolution; pixels
+// shifted in are blank. Rows move as whole words, no per-pixel work.
+void screen_scroll_up   (Screen* s, uint8_t n);
+void screen_scroll_down (Screen* s, uint8_t n);
+void screen_scroll_left (Screen* s, uint8_t n);
+void screen_scroll_right(Screen* s, uint8_t n);
 
-// Consume and clear the "dirty" flag; returns whether it was dirty.
+// Get a const pointer to plane 1's packed rows (HIRES_HEIGHT words, MSB = x 0);
+// screen_rows_right() holds x 64..127 of each row in hi-res mode.
+const uint64_t* screen_rows(const Screen* s);
+const uint64_t* screen_rows_right(const Screen* s);
+
+// The same for plane 2.
+const uint64_t* screen_rows2(const Screen* s);
+const uint64_t* screen_rows2_right(const Screen* s);
+
+// Compatibility view: unpack into `out` (screen_width * screen_height bytes,
+// row-major, one colour 0..3 per pixel; 0/1 while plane 2 is blank).
+// Returns `out`, or NULL on NULL arguments.
+const uint8_t* screen_pixels(const Screen* s, uint8_t* out);
+
+// 64-bit FNV-1a hash of the framebuffer contents (stable across platforms).
+// Lo-res screens hash their 32 rows only, hi-res ones a mode byte plus both
+// halves of all 64 rows. A non-blank plane 2 appends a marker byte and its
+// rows in the same layout, so single-plane hashes are unchanged.
+uint64_t screen_hash(const Screen* s);
+
+// Consume and clear the dirty state; returns whether any row was dirty.
 bool screen_consume_dirty(Screen* s);
 
+// Consume and clear the per-row dirty mask (bit y = row y changed).
+uint64_t screen_consume_dirty_rows(Screen* s);
+
 #endif // SCREEN_H
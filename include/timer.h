@@ -5,13 +5,29 @@
 #include <stdint.h>
 #include "regs.h"   // Registers { DT, ST, ... }
 
+/* Per-instance timer bookkeeping for wall-clock driven callers.
+ * No global state: instances (e.g. one per worker thread) never interfere. */
+typedef struct {
+    uint64_t acc_ns;            /* elapsed time not yet converted to 60 Hz ticks */
+    bool     prev_st_nonzero;   /* ST state seen by the previous call (beep edges) */
+} TimerState;
+
+/* Reset accumulator and beep edge state. */
+void timer_state_init(TimerState* ts);
+
 /* Advance DT/ST at 60 Hz using elapsed nanoseconds since last call.
  * - Decrements DT and ST (if >0) at 60 Hz.
  * - If ST transitions 0->>0, *out_start_beep = true.
  * - If ST transitions >0->0, *out_stop_beep  = true.
  * Any output pointer can be NULL if caller doesn't care.
+ * Returns whether the beep state changed. Reentrant; `ts` belongs to one instance.
  */
-bool regs_tick_timers(Registers* regs, uint64_t elapsed_ns,
+bool regs_tick_timers(Registers* regs, TimerState* ts, uint64_t elapsed_ns,
                       bool* out_start_beep, bool* out_stop_beep);
 
+/* One 60 Hz tick: decrement DT and ST (if >0) exactly once and end any
+ * display-wait idle (Registers::vblank_wait).
+ * For frame-locked callers that run a fixed number of cycles per frame. */
+void regs_tick_frame(Registers* regs);
+
 #endif // TIMERS_H
@@ -0,0 +1,111 @@
+#ifndef CHIP8_TRACE_H
+#define CHIP8_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "chip8_status.h"
+#include "instr.h"   // OP_X
+#include "regs.h"
+
+/*
+ * Binary execution trace. The interpreter appends one fixed-size record per
+ * executed instruction when the core is built with CHIP8_TRACE (CMake:
+ * -DCHIP8_ENABLE_TRACE=ON) and a trace is attached with chip8_set_trace();
+ * otherwise the hooks compile to nothing and struct Chip8 has no writer.
+ *
+ * Records are staged in a small per-instance batch (plain stores, no
+ * atomics), handed in bulk to a lock-free single-producer/single-consumer
+ * ring, and written to the file by a background thread, so the emulator
+ * thread never does I/O. When the ring is full the producer either waits
+ * for the writer (the default: the trace stays complete) or drops records
+ * and counts them.
+ *
+ * File format (little-endian): "C8TR" u16 version u16 record size
+ * u64 rom_hash u64 records u64 dropped, then the records as below. The two
+ * counts are filled in by trace_close(); a trace cut short (crash, kill)
+ * has them at 0 and is read up to the last whole record.
+ */
+#define TRACE_VERSION     1u
+#define TRACE_HEADER_SIZE 32u
+#define TRACE_RECORD_SIZE 16u
+
+/* One executed instruction, with the state it left behind. Which of vx /
+ * vf / i it changed follows from the opcode (chip8_trace shows only those). */
+typedef struct {
+    uint64_t cycle;   /* cycles since the trace was attached, idle ones included */
+    uint16_t pc;      /* address the instruction was fetched from */
+    uint16_t op;
+    uint16_t i;       /* I after it */
+    uint8_t  vx;      /* V[x] after it (x = the opcode's second nibble) */
+    uint8_t  vf;      /* VF after it */
+} TraceRecord;
+
+/* Ring plus writer thread; opaque (src/trace.c). */
+typedef struct TraceRing TraceRing;
+
+#define TRACE_BATCH 256u
+
+/* Producer side, embedded in struct Chip8 in trace builds. */
+typedef struct {
+    TraceRing*  ring;     /* NULL: not tracing */
+    uint64_t    cycle;
+    uint32_t    count;    /* records staged in batch */
+    TraceRecord batch[TRACE_BATCH];
+} TraceWriter;
+
+typedef struct {
+    uint64_t records;   /* written to the file */
+    uint64_t dropped;   /* lost to a full ring (drop mode only) */
+    uint64_t stalls;    /* times the producer waited for the writer */
+} TraceStats;
+
+/* Create `path` and start its writer thread. `capacity` is in records and
+ * rounded up to a power of two (0 picks a default of 1M, 16 MB). */
+Chip8Status trace_open(TraceRing** out, const char* path, size_t capacity, uint64_t rom_hash,
+                       bool drop_when_full);
+
+/* Hand the staged batch to the ring (the inline hooks call this when the
+ * batch fills; detach/close calls it for the remainder). */
+void trace_writer_flush(TraceWriter* w);
+
+/* Stop the writer after it drained the ring, finish the header and close
+ * the file. Detach the ring from every writer (and flush them) first.
+ * `stats` may be NULL. Returns the first I/O error seen, if any. */
+Chip8Status trace_close(TraceRing* ring, TraceStats* stats);
+
+/* Append one record for the instruction `op` at `pc` that just executed. */
+static inline void trace_record(TraceWriter* w, uint16_t pc, uint16_t op, const Registers* regs) {
+    if (!w->ring) return;
+    TraceRecord* r = &w->batch[w->count];
+    r->cycle = w->cycle++;
+    r->pc    = pc;
+    r->op    = op;
+    r->i     = regs->I;
+    r->vx    = regs->V[OP_X(op)];
+    r->vf    = regs->V[0xF];
+    if (++w->count == TRACE_BATCH) trace_writer_flush(w);
+}
+
+/* Account cycles that passed without an instruction (wait-loop skipping,
+ * display wait), so record cycles stay true. */
+static inline void trace_idle(TraceWriter* w, uint64_t cycles) {
+    if (w->ring) w->cycle += cycles;
+}
+
+/* ---------- reading ---------- */
+
+typedef struct {
+    uint64_t rom_hash;
+    uint64_t records;   /* 0 if the trace was not closed */
+    uint64_t dropped;
+} TraceHeader;
+
+/* Read and check the header; `fp` is left at the first record. */
+Chip8Status trace_read_header(FILE* fp, TraceHeader* out);
+
+/* Read up to `max` records; returns how many were read (0 at the end). */
+size_t trace_read(FILE* fp, TraceRecord* out, size_t max);
+
+#endif /* CHIP8_TRACE_H */
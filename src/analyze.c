@@ -0,0 +1,186 @@
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memset
+
+#include "analyze.h"
+#include "instr.h"   // instr_kind, OP_NNN
+
+/* One decoded instruction's effect on control flow. */
+typedef struct {
+    uint8_t  len;         /* bytes: 4 for XO-CHIP's F000 nnnn, else 2 */
+    uint8_t  end;         /* BlockEnd; BLOCK_END_FALL for straight-line code */
+    uint8_t  nsucc;
+    uint16_t succ[2];
+} Flow;
+
+static uint16_t peek_op(const Memory* m, uint16_t pc) {
+    return (uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1)));
+}
+
+static uint8_t instr_len(const Memory* m, uint16_t pc) {
+    return ((size_t)pc + 1u < MEMORY_SIZE && peek_op(m, pc) == 0xF000u) ? 4u : 2u;
+}
+
+/* Decode the instruction at `pc` into its successors. */
+static Flow flow_at(const Memory* m, uint16_t pc) {
+    Flow f = { 2u, BLOCK_END_FALL, 0u, { 0u, 0u } };
+    if ((size_t)pc + 1u >= MEMORY_SIZE) {
+        f.end = BLOCK_END_STOP;
+        return f;
+    }
+
+    const uint16_t op = peek_op(m, pc);
+    f.len = instr_len(m, pc);
+    if ((size_t)pc + f.len > MEMORY_SIZE) {
+        f.end = BLOCK_END_STOP;
+        return f;
+    }
+    const uint16_t next = (uint16_t)(pc + f.len);
+    const bool has_next = (size_t)pc + f.len < MEMORY_SIZE;   /* no wrap to 0x0000 */
+
+    switch (instr_kind(op)) {
+    case INSTR_JP:
+        f.end = BLOCK_END_JUMP;
+        f.succ[f.nsucc++] = OP_NNN(op);
+        break;
+    case INSTR_CALL:
+        f.end = BLOCK_END_CALL;
+        f.succ[f.nsucc++] = OP_NNN(op);
+        if (has_next) f.succ[f.nsucc++] = next;
+        break;
+    case INSTR_RET:
+        f.end = BLOCK_END_RET;
+        break;
+    case INSTR_EXIT:
+        f.end = BLOCK_END_HALT;
+        break;
+    case INSTR_JP_V0:
+        f.end = BLOCK_END_INDIRECT;
+        break;
+    case INSTR_SE_IMM: case INSTR_SNE_IMM: case INSTR_SE_REG: case INSTR_SNE_REG:
+    case INSTR_SKP:    case INSTR_SKNP:
+        f.end = BLOCK_END_BRANCH;
+        if (has_next) {
+            f.succ[f.nsucc++] = next;
+            const uint8_t skipped = instr_len(m, next);
+            if ((size_t)next + skipped < MEMORY_SIZE) f.succ[f.nsucc++] = (uint16_t)(next + skipped);
+        }
+        break;
+    case INSTR_UNKNOWN:
+        f.end = BLOCK_END_STOP;
+        break;
+    default:
+        if (has_next) f.succ[f.nsucc++] = next;
+        else          f.end = BLOCK_END_STOP;
+        break;
+    }
+    return f;
+}
+
+/* Pass 1: mark every reachable instruction, depth first. Each instruction
+ * pushes at most two successors, so the stack never exceeds 2 per address. */
+static Chip8Status mark_reachable(const Memory* m, uint16_t entry, RomAnalysis* a) {
+    uint16_t* stack = (uint16_t*)malloc(sizeof(uint16_t) * (2u * (size_t)MEMORY_SIZE + 1u));
+    if (!stack) return CHIP8_ERR_OUT_OF_MEMORY;
+
+    size_t top = 0;
+    stack[top++] = entry;
+    a->flags[entry] |= ANALYZE_LEADER;
+
+    while (top > 0) {
+        const uint16_t pc = stack[--top];
+        if (a->flags[pc] & ANALYZE_CODE) continue;
+
+        const Flow f = flow_at(m, pc);
+        a->flags[pc] |= ANALYZE_CODE;
+        for (uint8_t i = 1; i < f.len && (size_t)pc + i < MEMORY_SIZE; ++i) {
+            a->flags[pc + i] |= ANALYZE_OPERAND;
+        }
+        a->instr_count++;
+
+        const uint16_t op = peek_op(m, pc);
+        if (instr_kind(op) == INSTR_LD_I) a->flags[OP_NNN(op)] |= ANALYZE_DATA_REF;
+        if (f.end == BLOCK_END_INDIRECT) { a->flags[pc] |= ANALYZE_INDIRECT; a->indirect_count++; }
+        if (f.end == BLOCK_END_STOP)     { a->flags[pc] |= ANALYZE_UNKNOWN;  a->unknown_count++; }
+
+        for (uint8_t i = 0; i < f.nsucc; ++i) {
+            const uint16_t s = f.succ[i];
+            /* every control transfer starts a block at each successor */
+            if (f.end != BLOCK_END_FALL) a->flags[s] |= ANALYZE_LEADER;
+            if (f.end == BLOCK_END_JUMP || f.end == BLOCK_END_BRANCH) a->flags[s] |= ANALYZE_JUMP;
+            if (f.end == BLOCK_END_CALL && i == 0) a->flags[s] |= ANALYZE_CALL;
+            if (!(a->flags[s] & ANALYZE_CODE)) stack[top++] = s;
+        }
+    }
+
+    free(stack);
+    return CHIP8_OK;
+}
+
+/* Pass 2: cut the marked code into blocks at the leaders. */
+static Chip8Status build_blocks(const Memory* m, RomAnalysis* a) {
+    size_t leaders = 0;
+    for (size_t p = 0; p < MEMORY_SIZE; ++p) {
+        if ((a->flags[p] & (ANALYZE_LEADER | ANALYZE_CODE)) == (ANALYZE_LEADER | ANALYZE_CODE)) ++leaders;
+        if (a->flags[p] & (ANALYZE_CODE | ANALYZE_OPERAND)) a->code_bytes++;
+    }
+    if (leaders == 0) return CHIP8_OK;
+
+    a->blocks = (RomBlock*)malloc(sizeof(RomBlock) * leaders);
+    if (!a->blocks) return CHIP8_ERR_OUT_OF_MEMORY;
+
+    for (size_t p = 0; p < MEMORY_SIZE; ++p) {
+        if ((a->flags[p] & (ANALYZE_LEADER | ANALYZE_CODE)) != (ANALYZE_LEADER | ANALYZE_CODE)) continue;
+
+        RomBlock* b = &a->blocks[a->block_count++];
+        memset(b, 0, sizeof(*b));
+        b->start = (uint16_t)p;
+
+        uint16_t pc = (uint16_t)p;
+        for (;;) {
+            const Flow f = flow_at(m, pc);
+            b->instrs++;
+            b->last = pc;
+            const size_t next = (size_t)pc + f.len;
+            if (f.end == BLOCK_END_FALL && next < MEMORY_SIZE &&
+                (a->flags[next] & (ANALYZE_CODE | ANALYZE_LEADER)) == ANALYZE_CODE) {
+                pc = (uint16_t)next;   /* straight-line code continues */
+                continue;
+            }
+            b->end   = f.end;
+            b->nsucc = f.nsucc;
+            b->succ[0] = f.succ[0];
+            b->succ[1] = f.succ[1];
+            break;
+        }
+    }
+    return CHIP8_OK;
+}
+
+Chip8Status rom_analyze(const Memory* m, uint16_t entry, RomAnalysis* out) {
+    CHIP8_CHECK_ARG(m);
+    CHIP8_CHECK_ARG(out);
+
+    memset(out, 0, sizeof(*out));
+    Chip8Status st = mark_reachable(m, entry, out);
+    if (st == CHIP8_OK) st = build_blocks(m, out);
+    if (st != CHIP8_OK) rom_analysis_free(out);
+    return st;
+}
+
+void rom_analysis_free(RomAnalysis* a) {
+    if (!a) return;
+    free(a->blocks);
+    a->blocks = NULL;
+    a->block_count = 0;
+}
+
+long rom_analysis_find_block(const RomAnalysis* a, uint16_t addr) {
+    if (!a || !a->blocks) return -1;
+    size_t lo = 0, hi = a->block_count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (a->blocks[mid].start < addr) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < a->block_count && a->blocks[lo].start == addr) ? (long)lo : -1;
+}
@@ -0,0 +1,53 @@
+#include "aot.h"
+#include "chip8.h"
+#include "instr.h"
+
+const AotModule* aot_find(const AotTable* table, uint64_t rom_hash) {
+    if (!table) return NULL;
+    for (size_t i = 0; i < table->count; ++i) {
+        if (table->modules[i]->rom_hash == rom_hash) return table->modules[i];
+    }
+    return NULL;
+}
+
+void aot_invalidate(const AotModule* mod, uint8_t* state, uint16_t addr, size_t len) {
+    if (!mod || !mod->owner || !state || len == 0) return;
+
+    if ((size_t)addr >= AOT_SPAN) return;
+    size_t end = (size_t)addr + len;
+    if (end > AOT_SPAN) end = AOT_SPAN;
+
+    for (size_t a = addr; a < end; ++a) {
+        const uint16_t u = mod->owner[a];
+        if (u) state[u - 1] = AOT_UNIT_UNVERIFIED;
+    }
+}
+
+bool aot_verify(const AotModule* mod, uint8_t* state, size_t unit, const Memory* m) {
+    const AotUnit* u = &mod->units[unit];
+    const size_t off = (size_t)u->start - PROGRAM_START_ADDRESS;
+
+    bool same = true;
+    for (size_t i = 0; i < u->bytes && same; ++i) {
+        same = memory_peek(m, (uint16_t)(u->start + i)) == mod->image[off + i];
+    }
+    state[unit] = same ? AOT_UNIT_LIVE : AOT_UNIT_STALE;
+    return same;
+}
+
+uint32_t aot_enter(struct Chip8* c8, const AotModule* mod, uint32_t budget) {
+    const uint16_t pc = c8->chip8_regs.PC;
+    const uint16_t unit = (pc < AOT_SPAN) ? mod->entry[pc] : 0;
+    if (!unit) return 0;
+
+    const uint8_t state = c8->chip8_aot_state[unit - 1];
+    if (state == AOT_UNIT_STALE) return 0;
+    if (state == AOT_UNIT_UNVERIFIED && !aot_verify(mod, c8->chip8_aot_state, unit - 1u, &c8->chip8_mem)) return 0;
+    return mod->run(c8, budget);
+}
+
+void aot_exec(struct Chip8* c8, uint16_t op) {
+    Instr in;
+    instr_decode_quirks(op, c8->chip8_icache.quirks, &in);
+    in.fn(&in, &c8->chip8_regs, &c8->chip8_mem, &c8->chip8_disp, &c8->chip8_stack, &c8->chip8_kbd);
+}
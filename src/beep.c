@@ -2,6 +2,7 @@
 #include <SDL3/SDL.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -14,6 +15,12 @@ struct Beeper {
     float phase_inc;           /* 2π f / sample_rate */
     float volume;              /* 0..1 */
     bool  playing;
+
+    /* XO-CHIP pattern playback (beep_set_pattern) */
+    bool    use_pattern;
+    uint8_t pattern[16];
+    float   pattern_pos;       /* bit position, 0..128 */
+    float   pattern_inc;       /* pattern bits per output sample */
 };
 
 /* SDL3: stream callback, adding additional_amount byte-data to the stream */
@@ -35,7 +42,19 @@ static void SDLCALL beeper_stream_cb(void* userdata,
                                 ? (int)sizeof(tmp) : additional_amount;
         const int frames = chunk_bytes / bytes_per_sample;
 
-        if (b->playing) {
+        if (b->playing && b->use_pattern) {
+            /* 1-bit samples as a square wave around zero */
+            float pos = b->pattern_pos;
+            const float inc = b->pattern_inc;
+            const float vol = b->volume;
+            for (int i = 0; i < frames; ++i) {
+                const unsigned bit = (unsigned)pos;
+                tmp[i] = ((b->pattern[bit >> 3] >> (7u - (bit & 7u))) & 1u) ? vol : -vol;
+                pos += inc;
+                if (pos >= 128.0f) pos -= 128.0f;
+            }
+            b->pattern_pos = pos;
+        } else if (b->playing) {
             float phase = b->phase;
             const float inc = b->phase_inc;
             const float vol = b->volume;
@@ -103,6 +122,18 @@ void beep_set(Beeper* b, bool on)
     }
 }
 
+void beep_set_pattern(Beeper* b, const uint8_t* pattern, uint8_t pitch)
+{
+    if (!b) return;
+    const float rate = 4000.0f * powf(2.0f, ((float)pitch - 64.0f) / 48.0f);
+    if (SDL_LockAudioStream(b->stream)) {
+        b->use_pattern = pattern != NULL;
+        if (pattern) memcpy(b->pattern, pattern, sizeof(b->pattern));
+        b->pattern_inc = rate / (float)b->sample_rate;
+        SDL_UnlockAudioStream(b->stream);
+    }
+}
+
 void beep_destroy(Beeper* b)
 {
     if (!b) return;
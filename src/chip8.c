@@ -4,6 +4,36 @@
 
 #include "chip8.h"
 #include "instr.h"
+#include "timer.h"
+#include "replay.h"   // input_log_rom_hash
+#include "disasm.h"
+#include "debug.h"    // debug_map_any, debug_map_test
+
+/* Profiler hook: one call per executed instruction, or nothing at all. */
+#ifdef CHIP8_PROFILE
+  #define PROF_RECORD(c8, pc, in) \
+      prof_record(&(c8)->chip8_prof, (pc), (in), &(c8)->chip8_regs, &(c8)->chip8_kbd)
+#else
+  #define PROF_RECORD(c8, pc, in) ((void)0)
+#endif
+
+/* Trace hooks: a record after each executed instruction, and the cycles that
+ * passed idle, or nothing at all. `op` is read before the handler runs (a
+ * store may drop its own decode-cache slot). */
+#ifdef CHIP8_TRACE
+  #define TRACE_RECORD(c8, pc, op) trace_record(&(c8)->chip8_trace, (pc), (op), &(c8)->chip8_regs)
+  #define TRACE_IDLE(c8, n)        trace_idle(&(c8)->chip8_trace, (n))
+#else
+  #define TRACE_RECORD(c8, pc, op) ((void)(op))
+  #define TRACE_IDLE(c8, n)        ((void)0)
+#endif
+
+/* Memory write hook: drop decoded instructions overlapping the written range. */
+static void chip8_on_mem_write(void* ctx, uint16_t addr, size_t len) {
+    struct Chip8* c8 = (struct Chip8*)ctx;
+    icache_invalidate(&c8->chip8_icache, addr, len);
+    if (c8->chip8_aot) aot_invalidate(c8->chip8_aot, c8->chip8_aot_state, addr, len);
+}
 
 void chip8_init(struct Chip8 *c8) {
     // Initialize the chip8 emulator
@@ -12,6 +42,38 @@ void chip8_init(struct Chip8 *c8) {
     memset(c8, 0, sizeof(struct Chip8));
     memory_init(&c8->chip8_mem);
     screen_init(&c8->chip8_disp);
+    icache_init(&c8->chip8_icache);
+    timer_state_init(&c8->chip8_timer);
+    memory_set_write_hook(&c8->chip8_mem, chip8_on_mem_write, c8);
+    chip8_seed(c8, 0);
+    c8->chip8_regs.pitch = AUDIO_PITCH_DEFAULT;
+    c8->chip8_skip_idle = true;
+#ifdef CHIP8_PROFILE
+    prof_init(&c8->chip8_prof);
+#endif
+}
+
+void chip8_destroy(struct Chip8* c8) {
+    if (!c8) return;
+    memory_set_write_hook(&c8->chip8_mem, NULL, NULL);
+    memory_release(&c8->chip8_mem);
+}
+
+void chip8_fork(struct Chip8* dst, const struct Chip8* src) {
+    if (!dst || !src || dst == src) return;
+    memcpy(dst, src, sizeof(struct Chip8));
+    memory_fork(&dst->chip8_mem, &src->chip8_mem);
+    memory_set_write_hook(&dst->chip8_mem, chip8_on_mem_write, dst);
+#ifdef CHIP8_TRACE
+    /* a ring has one producer: the child starts untraced */
+    dst->chip8_trace.ring  = NULL;
+    dst->chip8_trace.count = 0;
+#endif
+}
+
+void chip8_seed(struct Chip8* c8, uint64_t seed) {
+    if (!c8) return;
+    rng_seed(&c8->chip8_regs.rng, seed);
 }
 
 /* Helper: get file size (returns 0 on failure). */
@@ -74,6 +136,54 @@ Chip8Status chip8_load_rom(struct Chip8* c8, const char* filepath) {
     return CHIP8_OK;
 }
 
+void chip8_set_quirks(struct Chip8* c8, Chip8Quirks quirks) {
+    if (!c8) return;
+    icache_set_quirks(&c8->chip8_icache, quirks);
+}
+
+Chip8Quirks chip8_get_quirks(const struct Chip8* c8) {
+    return c8 ? c8->chip8_icache.quirks : CHIP8_QUIRKS_DEFAULT;
+}
+
+Chip8Quirks chip8_detect_quirks(const struct Chip8* c8) {
+    Chip8Quirks q = CHIP8_QUIRKS_DEFAULT;
+    if (c8) (void)quirks_lookup_rom(input_log_rom_hash(&c8->chip8_mem), &q);
+    return q;
+}
+
+size_t chip8_predecode(struct Chip8* c8, const RomAnalysis* a) {
+    if (!c8 || !a) return 0;
+    DecodeCache* cache = &c8->chip8_icache;
+
+    size_t filled = 0;
+    for (size_t pc = 0; pc + 1u < ICACHE_SPAN; pc += 2) {
+        if (!(a->flags[pc] & ANALYZE_CODE)) continue;
+        (void)icache_fetch(cache, &c8->chip8_mem, (uint16_t)pc);
+        ++filled;
+    }
+    for (size_t i = 0; i < a->block_count; ++i) {
+        const uint16_t pc = a->blocks[i].start;
+        if ((pc & 1u) == 0 && (size_t)pc + 1u < ICACHE_SPAN) (void)icache_block(cache, &c8->chip8_mem, pc);
+    }
+    return filled;
+}
+
+void chip8_set_aot(struct Chip8* c8, const AotModule* mod) {
+    if (!c8) return;
+    c8->chip8_aot = mod;
+    /* nothing is known about RAM yet: each unit is checked on first entry */
+    memset(c8->chip8_aot_state, AOT_UNIT_UNVERIFIED, sizeof(c8->chip8_aot_state));
+}
+
+#ifdef CHIP8_TRACE
+void chip8_set_trace(struct Chip8* c8, TraceRing* ring) {
+    if (!c8) return;
+    trace_writer_flush(&c8->chip8_trace);
+    c8->chip8_trace.ring  = ring;
+    c8->chip8_trace.cycle = 0;
+}
+#endif
+
 void dump_n(const struct Chip8* c8,
                   uint16_t start_addr,
                   size_t   nbytes,
@@ -82,7 +192,7 @@ void dump_n(const struct Chip8* c8,
     if (!c8 || nbytes == 0) return;
     if (words_per_line <= 0) words_per_line = 4;
 
-    const uint8_t* mem = c8->chip8_mem.memory;
+    const Memory* mem = &c8->chip8_mem;
 
     size_t start = (size_t)start_addr;
     if (start >= MEMORY_SIZE) return;
@@ -100,11 +210,11 @@ void dump_n(const struct Chip8* c8,
 
             if (wa + 1 < end) {
                 // big-endian
-                uint8_t hi = mem[wa];
-                uint8_t lo = mem[wa + 1];
+                uint8_t hi = memory_peek(mem, (uint16_t)wa);
+                uint8_t lo = memory_peek(mem, (uint16_t)(wa + 1));
                 printf(" %02X%02X", hi, lo);
             } else if (wa < end) {
-                uint8_t b = mem[wa];
+                uint8_t b = memory_peek(mem, (uint16_t)wa);
                 printf(" %02X", b);
                 break;
             } else {
@@ -115,28 +225,265 @@ void dump_n(const struct Chip8* c8,
     }
 }
 
+void disasm_n(const struct Chip8* c8, uint16_t start_addr, size_t nbytes) {
+    if (!c8 || nbytes == 0) return;
+
+    char buf[4096];
+    size_t addr = start_addr;
+    const size_t end = (size_t)start_addr + nbytes;
+    while (addr < end && addr < MEMORY_SIZE) {
+        size_t next;
+        disasm_range(&c8->chip8_mem, (uint16_t)addr, end - addr, buf, sizeof(buf), &next);
+        fputs(buf, stdout);
+        addr = next;
+    }
+}
+
 static inline uint16_t fetch_opcode(const struct Chip8* c8, uint16_t pc, Chip8Status* out_st) {
     if (out_st) *out_st = CHIP8_OK;
     if ((size_t)pc + 1u >= MEMORY_SIZE) {
         if (out_st) *out_st = CHIP8_ERR_MEM_OOB;
         return 0;
     }
-    const uint8_t* m = c8->chip8_mem.memory;
-    return (uint16_t)((m[pc] << 8) | m[pc + 1]);
+    const Memory* m = &c8->chip8_mem;
+    return (uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1)));
+}
+
+/* Classify the loop entered at even `pc` (opcode `op`) and its length in
+ * instructions; the loop registers come from the current state. */
+static Chip8Idle idle_loop(const struct Chip8* c8, uint16_t pc, uint16_t op, uint32_t* out_len) {
+    const Registers* regs = &c8->chip8_regs;
+
+    if (((op & 0xF000u) == 0x1000u && OP_NNN(op) == pc) || op == 0x00FDu) {   /* JP self, EXIT */
+        *out_len = 1;
+        return CHIP8_IDLE_HALT;
+    }
+    if ((op & 0xF0FFu) == 0xF00Au) {                                /* LD Vx, K */
+        uint8_t key;
+        if (keyboard_first_pressed(&c8->chip8_kbd, &key) == CHIP8_OK) return CHIP8_IDLE_NONE;
+        *out_len = 1;
+        return CHIP8_IDLE_KEY;
+    }
+    if ((op & 0xF0FFu) == 0xF007u && (size_t)pc + 5u < MEMORY_SIZE) {   /* LD Vx, DT */
+        const Memory* m = &c8->chip8_mem;
+        const uint16_t skip = (uint16_t)((memory_peek(m, (uint16_t)(pc + 2)) << 8) | memory_peek(m, (uint16_t)(pc + 3)));
+        const uint16_t jump = (uint16_t)((memory_peek(m, (uint16_t)(pc + 4)) << 8) | memory_peek(m, (uint16_t)(pc + 5)));
+        if (jump != (0x1000u | pc) || OP_X(skip) != OP_X(op)) return CHIP8_IDLE_NONE;
+
+        /* The skip over the JP back is the only way out. */
+        bool stays;
+        if      ((skip & 0xF000u) == 0x3000u) stays = regs->DT != OP_KK(skip);   /* SE  Vx, kk */
+        else if ((skip & 0xF000u) == 0x4000u) stays = regs->DT == OP_KK(skip);   /* SNE Vx, kk */
+        else return CHIP8_IDLE_NONE;
+        if (!stays) return CHIP8_IDLE_NONE;
+
+        *out_len = 3;
+        return CHIP8_IDLE_TIMER;
+    }
+    return CHIP8_IDLE_NONE;
+}
+
+Chip8Idle chip8_idle_state(const struct Chip8* c8) {
+    if (!c8) return CHIP8_IDLE_NONE;
+    if (c8->chip8_regs.vblank_wait) return CHIP8_IDLE_VBLANK;
+    const uint16_t pc = c8->chip8_regs.PC;
+    if ((pc & 1u) || (size_t)pc + 1u >= MEMORY_SIZE) return CHIP8_IDLE_NONE;
+
+    uint32_t len;
+    return idle_loop(c8, pc, fetch_opcode(c8, pc, NULL), &len);
+}
+
+/* Fast-forward whole iterations of a wait loop at `pc` within `budget` cycles.
+ * Returns the cycles skipped; 0 means execute normally. */
+static uint32_t idle_skip(struct Chip8* c8, uint16_t pc, const Instr* in, uint32_t budget) {
+    uint32_t len = 0;
+    const Chip8Idle kind = idle_loop(c8, pc, in->op, &len);
+    if (kind == CHIP8_IDLE_NONE || budget < len || (size_t)pc + 2u * len > ICACHE_SPAN) return 0;
+
+    const uint32_t skipped = budget - budget % len;
+#ifdef CHIP8_PROFILE
+    for (uint32_t i = 0; i < skipped; ++i) {
+        const uint16_t a = (uint16_t)(pc + 2u * (i % len));
+        PROF_RECORD(c8, a, icache_fetch(&c8->chip8_icache, &c8->chip8_mem, a));
+    }
+#endif
+    /* Every iteration leaves the same state behind: PC back at the loop, Vx
+     * holding DT (TIMER) or 0 (KEY, which stores before re-waiting). */
+    Registers* regs = &c8->chip8_regs;
+    if (kind == CHIP8_IDLE_TIMER) regs->V[in->x] = regs->DT;
+    if (kind == CHIP8_IDLE_KEY)   regs->V[in->x] = 0;
+    regs->PC = pc;
+
+    c8->chip8_idle_cycles += skipped;
+    TRACE_IDLE(c8, skipped);
+    return skipped;
 }
 
 Chip8Status chip8_step(struct Chip8* c8) {
     CHIP8_CHECK_ARG(c8);
     Registers* regs = &c8->chip8_regs;
 
-    Chip8Status st = CHIP8_OK;
+    if (regs->vblank_wait) {   /* display wait: the cycle passes idle */
+        ++c8->chip8_idle_cycles;
+        TRACE_IDLE(c8, 1);
+        return CHIP8_OK;
+    }
+
     const uint16_t pc = regs->PC;
-    const uint16_t op = fetch_opcode(c8, pc, &st);
-    if (st != CHIP8_OK) return st;
+    const Instr* in;
+    Instr odd;
+
+    if ((pc & 1u) == 0 && (size_t)pc + 1u < ICACHE_SPAN) {
+        /* hot path: decoded once, then a single indirect call */
+        in = icache_fetch(&c8->chip8_icache, &c8->chip8_mem, pc);
+    } else {
+        /* odd PCs and PCs past the code space are legal but rare: decode without caching */
+        Chip8Status st = CHIP8_OK;
+        const uint16_t op = fetch_opcode(c8, pc, &st);
+        if (st != CHIP8_OK) return st;
+        instr_decode_quirks(op, c8->chip8_icache.quirks, &odd);
+        in = &odd;
+    }
+
+    PROF_RECORD(c8, pc, in);
 
     /* step 2 */
     regs->PC = (uint16_t)(pc + 2);
 
-    exec(op, regs, &c8->chip8_mem, &c8->chip8_disp, &c8->chip8_stack, &c8->chip8_kbd);
+    const uint16_t op = in->op;
+    in->fn(in, regs, &c8->chip8_mem, &c8->chip8_disp, &c8->chip8_stack, &c8->chip8_kbd);
+    TRACE_RECORD(c8, pc, op);
     return CHIP8_OK;
-}
\ No newline at end of file
+}
+
+/* The block loop, instantiated once per value of `display_wait` and of
+ * `stop` being NULL (both always constants), so profiles without the quirk
+ * never test for it and runs without a stop map never test one. All other
+ * quirks live in the handlers the decode cache picked. */
+static inline Chip8Status run_blocks_impl(struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed,
+                                          const bool display_wait, const uint64_t* const stop) {
+    Registers* regs = &c8->chip8_regs;
+    DecodeCache* cache = &c8->chip8_icache;
+    Chip8Status st = CHIP8_OK;
+    uint32_t done = 0;
+#ifndef CHIP8_PROFILE
+    const AotModule* aot = c8->chip8_aot;
+    if (aot && (aot->unit_count == 0 || aot->quirks != cache->quirks)) aot = NULL;
+    if (stop) aot = NULL;                   /* a unit runs past any marked address */
+  #ifdef CHIP8_TRACE
+    if (c8->chip8_trace.ring) aot = NULL;   /* translated units leave no records */
+  #endif
+#endif
+
+    while (done < max_cycles) {
+        if (display_wait && regs->vblank_wait) {
+            /* a DRW ended the block: nothing runs before regs_tick_frame() */
+            c8->chip8_idle_cycles += max_cycles - done;
+            TRACE_IDLE(c8, max_cycles - done);
+            done = max_cycles;
+            break;
+        }
+
+#ifndef CHIP8_PROFILE
+        if (aot) {
+            const uint32_t ran = aot_enter(c8, aot, max_cycles - done);
+            if (ran) {
+                done += ran;
+                continue;
+            }
+        }
+#endif
+
+        const uint16_t pc = regs->PC;
+        if (stop && done > 0 && debug_map_test(stop, pc)) break;
+
+        if ((pc & 1u) || (size_t)pc + 1u >= ICACHE_SPAN) {
+            /* no blocks at odd/uncached PCs: single step (reports OOB) */
+            st = chip8_step(c8);
+            if (st != CHIP8_OK) break;
+            ++done;
+            continue;
+        }
+
+        uint32_t len = icache_block(cache, &c8->chip8_mem, pc);
+        if (c8->chip8_skip_idle && !(stop && debug_map_any(stop, pc, 6u))) {   /* loops span <= 3 instructions */
+            const uint32_t skipped = idle_skip(c8, pc, &cache->slots[pc >> 1], max_cycles - done);
+            if (skipped) {
+                done += skipped;
+                continue;
+            }
+        }
+        if (len > max_cycles - done) len = max_cycles - done;
+        if (stop && len > 1u && debug_map_any(stop, pc + 2u, 2u * (len - 1u))) {
+            /* the block's instructions sit at even addresses only: an odd
+             * marked bit in range stops nothing here */
+            for (uint32_t i = 1; i < len; ++i) {
+                if (debug_map_test(stop, (uint16_t)(pc + 2u * i))) {
+                    len = i;   /* up to the marked address */
+                    break;
+                }
+            }
+        }
+
+        /* Only the last instruction of a block can observe or change PC, so
+         * set it once; the ones before it are pure register/timer updates. */
+        regs->PC = (uint16_t)(pc + 2u * len);
+        const Instr* in = &cache->slots[pc >> 1];
+        for (uint32_t i = 0; i < len; ++i, ++in) {
+            PROF_RECORD(c8, (uint16_t)(pc + 2u * i), in);
+            const uint16_t op = in->op;
+            in->fn(in, regs, &c8->chip8_mem, &c8->chip8_disp, &c8->chip8_stack, &c8->chip8_kbd);
+            TRACE_RECORD(c8, (uint16_t)(pc + 2u * i), op);
+        }
+        done += len;
+    }
+
+    *out_executed = done;
+    return st;
+}
+
+static Chip8Status run_blocks_free(struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed) {
+    return run_blocks_impl(c8, max_cycles, out_executed, false, NULL);
+}
+
+static Chip8Status run_blocks_display_wait(struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed) {
+    return run_blocks_impl(c8, max_cycles, out_executed, true, NULL);
+}
+
+static Chip8Status run_until_free(struct Chip8* c8, uint32_t max_cycles, const uint64_t* stop_map,
+                                  uint32_t* out_executed) {
+    return run_blocks_impl(c8, max_cycles, out_executed, false, stop_map);
+}
+
+static Chip8Status run_until_display_wait(struct Chip8* c8, uint32_t max_cycles, const uint64_t* stop_map,
+                                          uint32_t* out_executed) {
+    return run_blocks_impl(c8, max_cycles, out_executed, true, stop_map);
+}
+
+Chip8Status chip8_run_blocks(struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed) {
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(out_executed);
+
+    return quirks_profile(c8->chip8_icache.quirks)->display_wait
+        ? run_blocks_display_wait(c8, max_cycles, out_executed)
+        : run_blocks_free(c8, max_cycles, out_executed);
+}
+
+Chip8Status chip8_run_until(struct Chip8* c8, uint32_t max_cycles, const uint64_t* stop_map,
+                            uint32_t* out_executed) {
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(stop_map);
+    CHIP8_CHECK_ARG(out_executed);
+
+    return quirks_profile(c8->chip8_icache.quirks)->display_wait
+        ? run_until_display_wait(c8, max_cycles, stop_map, out_executed)
+        : run_until_free(c8, max_cycles, stop_map, out_executed);
+}
+
+Chip8Status chip8_run_frame(struct Chip8* c8, uint32_t cycles_per_frame, uint32_t* out_executed) {
+    Chip8Status st = chip8_run_blocks(c8, cycles_per_frame, out_executed);
+    if (st != CHIP8_OK) return st;
+
+    regs_tick_frame(&c8->chip8_regs);
+    return CHIP8_OK;
+}
@@ -13,6 +13,19 @@ const char* chip8_status_str(Chip8Status s) {
         case CHIP8_ERR_PIXEL_SET_FAILURE:   return "fail at setting pixel";
         case CHIP8_ERR_ROM_OPEN:            return "failed to open ROM file";
         case CHIP8_ERR_ROM_READ:            return "failed to read ROM";
+        case CHIP8_ERR_BUFFER_TOO_SMALL:    return "buffer too small";
+        case CHIP8_ERR_STATE_INVALID:       return "invalid save-state";
+        case CHIP8_ERR_STATE_BASE_MISMATCH: return "save-state base image mismatch";
+        case CHIP8_ERR_OUT_OF_MEMORY:       return "out of memory";
+        case CHIP8_ERR_REWIND_EMPTY:        return "rewind history empty";
+        case CHIP8_ERR_FILE_OPEN:           return "failed to open file";
+        case CHIP8_ERR_FILE_IO:             return "file read/write failed";
+        case CHIP8_ERR_REPLAY_INVALID:      return "invalid input recording";
+        case CHIP8_ERR_REPLAY_ROM_MISMATCH: return "input recording is for another ROM";
+        case CHIP8_ERR_TRACE_INVALID:       return "invalid execution trace";
+        case CHIP8_ERR_DEBUG_FULL:          return "too many breakpoints";
+        case CHIP8_ERR_DEBUG_ODD_ADDR:      return "breakpoint address is odd";
+        case CHIP8_ERR_REPLAY_QUIRKS_MISMATCH: return "input recording is for another quirks profile";
         default:                            return "unknown";
     }
 }
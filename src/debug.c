@@ -0,0 +1,197 @@
+#include <string.h>   // memset
+
+#include "debug.h"
+#include "chip8.h"
+#include "instr.h"
+
+/* ---------- address bitmaps ---------- */
+
+static inline void map_set(uint64_t* map, uint32_t addr, bool on) {
+    const uint64_t bit = 1ull << (addr & 63u);
+    if (on) map[addr >> 6] |= bit;
+    else    map[addr >> 6] &= ~bit;
+}
+
+/* ---------- setup ---------- */
+
+void debug_init(Debugger* d) {
+    if (!d) return;
+    memset(d, 0, sizeof(*d));
+}
+
+Chip8Status debug_set_break(Debugger* d, uint16_t addr, const DebugCond* cond) {
+    CHIP8_CHECK_ARG(d);
+    if (addr & 1u) return CHIP8_ERR_DEBUG_ODD_ADDR;
+    const DebugCond always = { 0, DEBUG_CMP_NONE, 0 };
+    if (!cond) cond = &always;
+
+    size_t k = 0;
+    while (k < d->break_count && d->breaks[k].addr != addr) ++k;
+    if (k == d->break_count) {
+        if (d->break_count == DEBUG_MAX_BREAKS) return CHIP8_ERR_DEBUG_FULL;
+        ++d->break_count;
+    }
+    d->breaks[k].addr = addr;
+    d->breaks[k].cond = *cond;
+    map_set(d->break_map, addr, true);
+    return CHIP8_OK;
+}
+
+bool debug_clear_break(Debugger* d, uint16_t addr) {
+    if (!d) return false;
+    for (size_t k = 0; k < d->break_count; ++k) {
+        if (d->breaks[k].addr != addr) continue;
+        d->breaks[k] = d->breaks[--d->break_count];
+        map_set(d->break_map, addr, false);
+        return true;
+    }
+    return false;
+}
+
+Chip8Status debug_watch(Debugger* d, uint16_t addr, size_t len, unsigned kinds, bool on) {
+    CHIP8_CHECK_ARG(d);
+    if (len == 0 || (size_t)addr + len > MEMORY_SIZE) return CHIP8_ERR_MEM_OOB;
+
+    for (uint32_t a = addr; a < (uint32_t)addr + len; ++a) {
+        const bool before = debug_map_test(d->read_map, a) || debug_map_test(d->write_map, a);
+        if (kinds & DEBUG_WATCH_READ)  map_set(d->read_map, a, on);
+        if (kinds & DEBUG_WATCH_WRITE) map_set(d->write_map, a, on);
+        const bool after = debug_map_test(d->read_map, a) || debug_map_test(d->write_map, a);
+        if (after && !before) ++d->watch_count;
+        if (before && !after) --d->watch_count;
+    }
+    return CHIP8_OK;
+}
+
+/* ---------- checks ---------- */
+
+bool debug_cond_holds(const struct Chip8* c8, const DebugCond* cond) {
+    if (!c8 || !cond) return false;
+    const Registers* regs = &c8->chip8_regs;
+    uint16_t v;
+    switch (cond->reg) {
+    case DEBUG_REG_I:  v = regs->I;  break;
+    case DEBUG_REG_DT: v = regs->DT; break;
+    case DEBUG_REG_ST: v = regs->ST; break;
+    default:           v = regs->V[cond->reg & 0x0Fu]; break;
+    }
+    switch ((DebugCmp)cond->cmp) {
+    case DEBUG_CMP_NONE: return true;
+    case DEBUG_CMP_EQ:   return v == cond->value;
+    case DEBUG_CMP_NE:   return v != cond->value;
+    case DEBUG_CMP_LT:   return v <  cond->value;
+    case DEBUG_CMP_LE:   return v <= cond->value;
+    case DEBUG_CMP_GT:   return v >  cond->value;
+    case DEBUG_CMP_GE:   return v >= cond->value;
+    }
+    return false;
+}
+
+/* A breakpoint bit is set at `pc`: does one of its conditions hold? */
+static bool break_hit(const Debugger* d, const struct Chip8* c8, uint16_t pc) {
+    for (size_t k = 0; k < d->break_count; ++k) {
+        if (d->breaks[k].addr == pc && debug_cond_holds(c8, &d->breaks[k].cond)) return true;
+    }
+    return false;
+}
+
+/* The RAM range the instruction `op` is about to read or write, from the
+ * current I. Returns false if it touches no RAM (or would fail out of range,
+ * touching nothing). Dxyn is clipped at the end of RAM like op_drw. */
+static bool mem_access(const struct Chip8* c8, uint16_t op, uint32_t* addr, uint32_t* len, bool* write) {
+    const uint32_t I = c8->chip8_regs.I;
+    const uint8_t  x = OP_X(op), y = OP_Y(op);
+    bool clip = false;
+
+    switch (instr_kind(op)) {
+    case INSTR_BCD:      *len = 3;              *write = true;  break;
+    case INSTR_ST_REGS:  *len = x + 1u;         *write = true;  break;
+    case INSTR_LD_REGS:  *len = x + 1u;         *write = false; break;
+    case INSTR_ST_RANGE: *len = (x <= y ? y - x : x - y) + 1u; *write = true;  break;
+    case INSTR_LD_RANGE: *len = (x <= y ? y - x : x - y) + 1u; *write = false; break;
+    case INSTR_AUDIO:    *len = AUDIO_PATTERN_BYTES; *write = false; break;
+    case INSTR_DRW:
+        *len   = (OP_N(op) ? OP_N(op) : 32u) * screen_plane_count(&c8->chip8_disp);
+        *write = false;
+        clip   = true;
+        break;
+    default:
+        return false;
+    }
+    if (I + *len > MEMORY_SIZE) {
+        if (!clip) return false;
+        *len = MEMORY_SIZE - I;
+    }
+    *addr = I;
+    return true;
+}
+
+/* Does the instruction at `pc` access a watched address? Fills `ev` if so. */
+static bool watch_hit(const Debugger* d, const struct Chip8* c8, uint16_t pc, DebugEvent* ev) {
+    if ((size_t)pc + 1u >= MEMORY_SIZE) return false;   /* chip8_step reports it */
+    const Memory* m = &c8->chip8_mem;
+    const uint16_t op = (uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1)));
+
+    uint32_t addr, len;
+    bool write;
+    if (!mem_access(c8, op, &addr, &len, &write)) return false;
+    const uint64_t* map = write ? d->write_map : d->read_map;
+    if (!debug_map_any(map, addr, len)) return false;
+
+    while (!debug_map_test(map, addr)) ++addr;
+    ev->reason = write ? DEBUG_STOP_WATCH_WRITE : DEBUG_STOP_WATCH_READ;
+    ev->pc     = pc;
+    ev->addr   = (uint16_t)addr;
+    return true;
+}
+
+/* ---------- run ---------- */
+
+Chip8Status debug_run(Debugger* d, struct Chip8* c8, uint32_t max_cycles, uint32_t* out_executed,
+                      DebugEvent* ev) {
+    CHIP8_CHECK_ARG(d);
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(out_executed);
+
+    Registers* regs = &c8->chip8_regs;
+    DebugEvent e = { DEBUG_STOP_NONE, 0, 0 };
+    Chip8Status st = CHIP8_OK;
+    uint32_t done = 0;
+
+    while (done < max_cycles) {
+        const uint16_t pc = regs->PC;
+
+        /* display wait idles without running an instruction; otherwise the
+         * instruction the last run stopped at goes through unchecked */
+        if (!regs->vblank_wait && !(d->resume && pc == d->resume_pc)) {
+            if (debug_has_break(d, pc) && break_hit(d, c8, pc)) {
+                e.reason = DEBUG_STOP_BREAK;
+                e.pc     = pc;
+                break;
+            }
+            if (d->watch_count && watch_hit(d, c8, pc, &e)) break;
+        }
+        if (!regs->vblank_wait) d->resume = false;
+
+        /* Watchpoints depend on I at each access: check every instruction.
+         * Otherwise run blocks up to the next address with a breakpoint bit
+         * (whose condition may not hold: then it runs on from there). */
+        uint32_t n = 0;
+        if (d->watch_count) {
+            st = chip8_step(c8);
+            if (st == CHIP8_OK) n = 1;
+        } else {
+            st = chip8_run_until(c8, max_cycles - done, d->break_map, &n);
+        }
+        done += n;
+        if (st != CHIP8_OK) break;
+    }
+
+    if (e.reason != DEBUG_STOP_NONE) {
+        d->resume    = true;
+        d->resume_pc = e.pc;
+    }
+    *out_executed = done;
+    if (ev) *ev = e;
+    return st;
+}
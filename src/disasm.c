@@ -0,0 +1,85 @@
+#include <string.h>   // memcpy
+
+#include "disasm.h"
+#include "config.h"   // MEMORY_SIZE
+#include "instr.h"
+
+static const char HEX[16] = "0123456789ABCDEF";
+
+static size_t put_hex(char* out, unsigned v, int digits) {
+    for (int i = 0; i < digits; ++i) out[i] = HEX[(v >> (4 * (digits - 1 - i))) & 0xFu];
+    return (size_t)digits;
+}
+
+static size_t put_str(char* out, const char* s) {
+    const size_t n = strlen(s);
+    memcpy(out, s, n);
+    return n;
+}
+
+/* The line for `addr` without newline or NUL into `line`, its length into
+ * *out_n; returns the RAM bytes it covers. Needs addr < end <= MEMORY_SIZE. */
+static size_t format_line(const Memory* m, size_t addr, size_t end, char* line, size_t* out_n) {
+    size_t n = 0;
+
+    /* "0x" + three hex digits, four past 0xFFF (XO-CHIP RAM) */
+    n += put_str(line + n, "0x");
+    n += put_hex(line + n, (unsigned)addr, addr > 0xFFFu ? 4 : 3);
+    n += put_str(line + n, ": ");
+
+    size_t len;
+    if (addr + 1u >= end) {                      /* lone trailing byte */
+        const uint8_t b = memory_peek(m, (uint16_t)addr);
+        n += put_hex(line + n, b, 2);
+        n += put_str(line + n, "         DB 0x");
+        n += put_hex(line + n, b, 2);
+        len = 1;
+    } else {
+        const uint16_t op = (uint16_t)((memory_peek(m, (uint16_t)addr) << 8) | memory_peek(m, (uint16_t)(addr + 1)));
+        n += put_hex(line + n, op, 4);
+        if (op == 0xF000u && addr + 3u < end) {  /* XO-CHIP LD I, nnnn: operand word inline */
+            const uint16_t nnnn = (uint16_t)((memory_peek(m, (uint16_t)(addr + 2)) << 8) |
+                                             memory_peek(m, (uint16_t)(addr + 3)));
+            n += put_str(line + n, " ");
+            n += put_hex(line + n, nnnn, 4);
+            n += put_str(line + n, "  LD I, 0x");
+            n += put_hex(line + n, nnnn, 4);
+            len = 4;
+        } else {
+            n += put_str(line + n, "       ");
+            n += instr_disasm(op, line + n, DISASM_LINE_MAX - n);
+            len = 2;
+        }
+    }
+    *out_n = n;
+    return len;
+}
+
+size_t disasm_line(const Memory* m, uint16_t addr, char line[DISASM_LINE_MAX], size_t* out_len) {
+    size_t n = 0, len = 0;
+    if (m && line) len = format_line(m, addr, MEMORY_SIZE, line, &n);   /* every uint16_t address is in RAM */
+    if (line) line[n] = '\0';
+    if (out_len) *out_len = n;
+    return len;
+}
+
+size_t disasm_range(const Memory* m, uint16_t start, size_t nbytes, char* buf, size_t cap, size_t* out_next) {
+    size_t end = (size_t)start + nbytes;
+    if (end > MEMORY_SIZE) end = MEMORY_SIZE;
+
+    size_t addr = start, written = 0;
+    char line[DISASM_LINE_MAX];
+    while (m && buf && addr < end) {
+        size_t n;
+        const size_t len = format_line(m, addr, end, line, &n);
+        if (written + n + 2u > cap) break;        /* line, newline and the NUL */
+        memcpy(buf + written, line, n);
+        written += n;
+        buf[written++] = '\n';
+        addr += len;
+    }
+
+    if (buf && cap > 0) buf[written] = '\0';
+    if (out_next) *out_next = addr;
+    return written;
+}
@@ -0,0 +1,113 @@
+#include "display.h"
+#include <SDL3/SDL.h>
+#include <stdlib.h>
+
+/* ARGB8888 colour per pixel value (plane 1 bit + 2 * plane 2 bit):
+ * black, white, and two greys for the XO-CHIP second plane. */
+static const uint32_t PALETTE[4] = { 0xFF000000u, 0xFFFFFFFFu, 0xFFAAAAAAu, 0xFF555555u };
+
+struct Display {
+    SDL_Window*   window;
+    SDL_Renderer* renderer;
+    SDL_Texture*  texture[2];  /* streaming: [0] 64x32 lo-res, [1] 128x64 hi-res */
+};
+
+bool display_init(Display** out_display, const char* title, int scale)
+{
+    if (!out_display || scale <= 0) return false;
+
+    Display* d = (Display*)calloc(1, sizeof(*d));
+    if (!d) return false;
+
+    d->window = SDL_CreateWindow(title, DISPLAY_WIDTH * scale, DISPLAY_HEIGHT * scale,
+                                 SDL_WINDOW_RESIZABLE);
+    if (!d->window) goto fail;
+
+    d->renderer = SDL_CreateRenderer(d->window, NULL);
+    if (!d->renderer) goto fail;
+
+    for (int i = 0; i < 2; ++i) {
+        d->texture[i] = SDL_CreateTexture(d->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                          SDL_TEXTUREACCESS_STREAMING,
+                                          i ? HIRES_WIDTH : DISPLAY_WIDTH,
+                                          i ? HIRES_HEIGHT : DISPLAY_HEIGHT);
+        if (!d->texture[i]) goto fail;
+
+        /* crisp pixels when scaling up */
+        SDL_SetTextureScaleMode(d->texture[i], SDL_SCALEMODE_NEAREST);
+    }
+
+    *out_display = d;
+    return true;
+
+fail:
+    display_destroy(d);
+    return false;
+}
+
+bool display_set_vsync(Display* d, bool on)
+{
+    if (!d) return false;
+    return SDL_SetRenderVSync(d->renderer, on ? 1 : SDL_RENDERER_VSYNC_DISABLED);
+}
+
+/* Expand 64 pixels of both planes into ARGB. The two words shift left in
+ * step, so each pixel's colour index is their top bits; no per-pixel lookups
+ * into the Screen. */
+static void compose_word(uint32_t* out, uint64_t p1, uint64_t p2)
+{
+    if (!p2) {   /* common case: single plane */
+        for (int i = 0; i < 64; ++i, p1 <<= 1) out[i] = PALETTE[p1 >> 63];
+        return;
+    }
+    for (int i = 0; i < 64; ++i, p1 <<= 1, p2 <<= 1) {
+        out[i] = PALETTE[(p1 >> 63) | ((p2 >> 62) & 2u)];
+    }
+}
+
+/* Compose one row of the packed planes (one word each, or two in hi-res)
+ * into ARGB pixels and upload it. */
+static void upload_row(SDL_Texture* tex, int y, int width, const Screen* scr)
+{
+    uint32_t line[HIRES_WIDTH];
+    compose_word(line, screen_rows(scr)[y], screen_rows2(scr)[y]);
+    if (width > 64) compose_word(line + 64, screen_rows_right(scr)[y], screen_rows2_right(scr)[y]);
+    const SDL_Rect r = { 0, y, width, 1 };
+    SDL_UpdateTexture(tex, &r, line, (int)(width * sizeof(uint32_t)));
+}
+
+bool display_update(Display* d, Screen* scr, bool force)
+{
+    if (!d || !scr) return false;
+
+    uint64_t dirty = screen_consume_dirty_rows(scr);
+    if (!dirty && !force) return false;
+
+    /* Only changed rows are touched; cost does not depend on lit pixels.
+       A mode switch clears the screen, so every row of the new texture is dirty. */
+    SDL_Texture* tex = d->texture[scr->hires ? 1 : 0];
+    const int width  = screen_width(scr);
+    const int height = screen_height(scr);
+    while (dirty) {
+        int y = 0;
+        while (!((dirty >> y) & 1u)) ++y;
+        dirty &= dirty - 1u;   /* drop lowest set bit */
+        if (y < height) upload_row(tex, y, width, scr);
+    }
+
+    SDL_RenderClear(d->renderer);
+    SDL_RenderTexture(d->renderer, tex, NULL, NULL);
+    SDL_RenderPresent(d->renderer);
+    return true;
+}
+
+void display_destroy(Display* d)
+{
+    if (!d) return;
+    for (int i = 0; i < 2; ++i) {
+        if (d->texture[i]) SDL_DestroyTexture(d->texture[i]);
+    }
+    if (d->renderer) SDL_DestroyRenderer(d->renderer);
+    if (d->window)   SDL_DestroyWindow(d->window);
+    free(d);
+}
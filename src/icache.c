@@ -0,0 +1,47 @@
+#include "icache.h"
+#include <string.h>   // memset
+
+void icache_init(DecodeCache* c) {
+    if (!c) return;
+    memset(c->slots, 0, sizeof(c->slots));
+    memset(c->block_len, 0, sizeof(c->block_len));
+}
+
+void icache_set_quirks(DecodeCache* c, Chip8Quirks quirks) {
+    if (!c || c->quirks == quirks) return;
+    c->quirks = quirks;
+    icache_init(c);
+}
+
+void icache_invalidate(DecodeCache* c, uint16_t addr, size_t len) {
+    if (!c || len == 0) return;
+
+    size_t first = (size_t)addr >> 1;
+    size_t last  = ((size_t)addr + len - 1) >> 1;
+    if (first >= ICACHE_SPAN / 2) return;
+    if (last  >= ICACHE_SPAN / 2) last = ICACHE_SPAN / 2 - 1;
+
+    /* Only drop the handler: a running handler may still read its own operands. */
+    for (size_t i = first; i <= last; ++i) c->slots[i].fn = NULL;
+
+    /* Any block entered up to ICACHE_MAX_BLOCK-1 slots earlier may span them. */
+    size_t block_first = (first >= ICACHE_MAX_BLOCK - 1) ? first - (ICACHE_MAX_BLOCK - 1) : 0;
+    memset(&c->block_len[block_first], 0, last - block_first + 1);
+}
+
+uint8_t icache_block(DecodeCache* c, const Memory* m, uint16_t pc) {
+    uint8_t len = c->block_len[pc >> 1];
+    if (len) return len;
+
+    uint16_t p = pc;
+    for (;;) {
+        const Instr* in = icache_fetch(c, m, p);
+        ++len;
+        if (instr_ends_block(in) || len == ICACHE_MAX_BLOCK) break;
+        p = (uint16_t)(p + 2);
+        if ((size_t)p + 1u >= ICACHE_SPAN) break;   /* next fetch is not cached: end here */
+    }
+
+    c->block_len[pc >> 1] = len;
+    return len;
+}
@@ -1,303 +1,728 @@
+#include <string.h>      // memcpy
+
 #include "instr.h"
 #include "chip8_status.h"
-#include "config.h"      // MEMORY_SIZE, FONT_START_ADDR
-#include <stdlib.h>      // rand()
+#include "config.h"      // MEMORY_SIZE, FONT_START_ADDR, AUDIO_PATTERN_BYTES
+#include "rng.h"
 
 #define VF (regs->V[0xF])
 
-void exec(uint16_t op,
-          Registers* regs,
-          Memory* mem,
-          Screen* screen,
-          Stack* stack,
-          Keyboard* kbd)
-{
-    const uint8_t  x   = OP_X(op);
-    const uint8_t  y   = OP_Y(op);
-    const uint8_t  kk  = OP_KK(op);
-    const uint8_t  n   = OP_N(op);
-    const uint16_t nnn = OP_NNN(op);
+/* Common handler parameter list; every opcode handler shares this signature. */
+#define INSTR_ARGS const Instr* in, Registers* regs, Memory* mem, \
+                   Screen* screen, Stack* stack, Keyboard* kbd
+#define INSTR_UNUSED (void)in; (void)regs; (void)mem; (void)screen; (void)stack; (void)kbd
 
-    switch (op & 0xF000) {
+/* ---------- 0nnn ---------- */
 
-    case 0x0000:
-        switch (op) {
-        case 0x00E0: { // CLS
-            if (!screen) CHIP8_LOG_WARN("CLS: screen is NULL");
-            screen_clear(screen);
-            break;
-        }
-        case 0x00EE: { // RET
-            Chip8Status st = stack_pop(stack, regs, &regs->PC);
-            if (st != CHIP8_OK) {
-                CHIP8_LOG_ERROR("RET failed: %s (PC stays at 0x%03X)",
-                                chip8_status_str(st), regs->PC);
-            }
-            break;
-        }
-        default:
-            /* 0nnn: SYS addr — ignored for modern interpreters */
-            break;
-        }
-        break;
+static void op_cls(INSTR_ARGS) { // 00E0: CLS
+    INSTR_UNUSED;
+    if (!screen) CHIP8_LOG_WARN("CLS: screen is NULL");
+    screen_clear(screen);
+}
 
-    case 0x1000: { // 1nnn: JP addr
-        regs->PC = nnn;
-        break;
+static void op_ret(INSTR_ARGS) { // 00EE: RET
+    INSTR_UNUSED;
+    Chip8Status st = stack_pop(stack, regs, &regs->PC);
+    if (st != CHIP8_OK) {
+        CHIP8_LOG_ERROR("RET failed: %s (PC stays at 0x%03X)",
+                        chip8_status_str(st), regs->PC);
     }
+}
 
-    case 0x2000: { // 2nnn: CALL addr
-        Chip8Status st = stack_push(stack, regs, regs->PC); // caller pre-incremented
-        if (st != CHIP8_OK) {
-            CHIP8_LOG_ERROR("CALL push failed: %s", chip8_status_str(st));
-            break;
-        }
-        regs->PC = nnn;
-        break;
-    }
+/* ---------- SUPER-CHIP 00Cn / 00Fx ---------- */
+
+static void op_scd(INSTR_ARGS) { // 00Cn: SCD n — scroll down n rows
+    INSTR_UNUSED;
+    screen_scroll_down(screen, in->n);
+}
+
+static void op_scu(INSTR_ARGS) { // 00Dn: SCU n — scroll up n rows (XO-CHIP)
+    INSTR_UNUSED;
+    screen_scroll_up(screen, in->n);
+}
+
+static void op_scr(INSTR_ARGS) { // 00FB: SCR — scroll right 4 pixels
+    INSTR_UNUSED;
+    screen_scroll_right(screen, 4);
+}
 
-    case 0x3000: { // 3xkk: SE Vx, byte
-        if (regs->V[x] == kk) regs->PC += 2;
-        break;
+static void op_scl(INSTR_ARGS) { // 00FC: SCL — scroll left 4 pixels
+    INSTR_UNUSED;
+    screen_scroll_left(screen, 4);
+}
+
+static void op_exit(INSTR_ARGS) { // 00FD: EXIT — stop the interpreter
+    INSTR_UNUSED;
+    regs->PC -= 2;   // park on this opcode (a halt loop for chip8_idle_state)
+}
+
+static void op_low(INSTR_ARGS) { // 00FE: LOW — 64x32, clears the screen
+    INSTR_UNUSED;
+    screen_set_hires(screen, false);
+}
+
+static void op_high(INSTR_ARGS) { // 00FF: HIGH — 128x64, clears the screen
+    INSTR_UNUSED;
+    screen_set_hires(screen, true);
+}
+
+static void op_sys(INSTR_ARGS) { // 0nnn: SYS addr — ignored for modern interpreters
+    INSTR_UNUSED;
+}
+
+static void op_unknown(INSTR_ARGS) {
+    INSTR_UNUSED;
+    CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", in->op);
+}
+
+/* ---------- flow control ---------- */
+
+/* Taken skips step over one whole instruction: 4 bytes when it is XO-CHIP's
+ * two-word F000 nnnn, else 2. PC already points at the skipped instruction. */
+static inline void skip_next(Registers* regs, const Memory* mem) {
+    const uint16_t pc = regs->PC;
+    const bool long_op = (size_t)pc + 1u < MEMORY_SIZE &&
+                         memory_peek(mem, pc) == 0xF0 && memory_peek(mem, (uint16_t)(pc + 1)) == 0x00;
+    regs->PC = (uint16_t)(pc + (long_op ? 4 : 2));
+}
+
+static void op_jp(INSTR_ARGS) { // 1nnn: JP addr
+    INSTR_UNUSED;
+    regs->PC = in->nnn;
+}
+
+static void op_call(INSTR_ARGS) { // 2nnn: CALL addr
+    INSTR_UNUSED;
+    Chip8Status st = stack_push(stack, regs, regs->PC); // caller pre-incremented
+    if (st != CHIP8_OK) {
+        CHIP8_LOG_ERROR("CALL push failed: %s", chip8_status_str(st));
+        return;
     }
+    regs->PC = in->nnn;
+}
+
+static void op_se_imm(INSTR_ARGS) { // 3xkk: SE Vx, byte
+    INSTR_UNUSED;
+    if (regs->V[in->x] == in->kk) skip_next(regs, mem);
+}
+
+static void op_sne_imm(INSTR_ARGS) { // 4xkk: SNE Vx, byte
+    INSTR_UNUSED;
+    if (regs->V[in->x] != in->kk) skip_next(regs, mem);
+}
+
+static void op_se_reg(INSTR_ARGS) { // 5xy0: SE Vx, Vy
+    INSTR_UNUSED;
+    if (regs->V[in->x] == regs->V[in->y]) skip_next(regs, mem);
+}
+
+static void op_sne_reg(INSTR_ARGS) { // 9xy0: SNE Vx, Vy
+    INSTR_UNUSED;
+    if (regs->V[in->x] != regs->V[in->y]) skip_next(regs, mem);
+}
+
+static void op_jp_v0(INSTR_ARGS) { // Bnnn: JP V0, addr
+    INSTR_UNUSED;
+    regs->PC = (uint16_t)(in->nnn + regs->V[0]);
+}
 
-    case 0x4000: { // 4xkk: SNE Vx, byte
-        if (regs->V[x] != kk) regs->PC += 2;
-        break;
+static void op_jp_vx(INSTR_ARGS) { // Bxnn: JP Vx, addr (CHIP-48 / SCHIP quirk)
+    INSTR_UNUSED;
+    regs->PC = (uint16_t)(in->nnn + regs->V[in->x]);
+}
+
+/* ---------- loads / ALU ---------- */
+
+static void op_ld_imm(INSTR_ARGS) { // 6xkk: LD Vx, byte
+    INSTR_UNUSED;
+    regs->V[in->x] = in->kk;
+}
+
+static void op_add_imm(INSTR_ARGS) { // 7xkk: ADD Vx by kk, byte
+    INSTR_UNUSED;
+    regs->V[in->x] += in->kk;
+}
+
+static void op_ld_reg(INSTR_ARGS) { // 8xy0: LD Vx, Vy
+    INSTR_UNUSED;
+    regs->V[in->x] = regs->V[in->y];
+}
+
+static void op_or(INSTR_ARGS) { // 8xy1: OR Vx, Vy
+    INSTR_UNUSED;
+    regs->V[in->x] |= regs->V[in->y]; VF = 0;
+}
+
+static void op_and(INSTR_ARGS) { // 8xy2: AND Vx, Vy
+    INSTR_UNUSED;
+    regs->V[in->x] &= regs->V[in->y]; VF = 0;
+}
+
+static void op_xor(INSTR_ARGS) { // 8xy3: XOR Vx, Vy
+    INSTR_UNUSED;
+    regs->V[in->x] ^= regs->V[in->y]; VF = 0;
+}
+
+/* 8xy1/2/3 without the VIP's VF reset. */
+static void op_or_keep(INSTR_ARGS) {
+    INSTR_UNUSED;
+    regs->V[in->x] |= regs->V[in->y];
+}
+
+static void op_and_keep(INSTR_ARGS) {
+    INSTR_UNUSED;
+    regs->V[in->x] &= regs->V[in->y];
+}
+
+static void op_xor_keep(INSTR_ARGS) {
+    INSTR_UNUSED;
+    regs->V[in->x] ^= regs->V[in->y];
+}
+
+static void op_add_reg(INSTR_ARGS) { // 8xy4: ADD Vx, Vy (with carry)
+    INSTR_UNUSED;
+    uint16_t sum = (uint16_t)regs->V[in->x] + (uint16_t)regs->V[in->y];
+    VF = (sum > 0xFF) ? 1 : 0;
+    regs->V[in->x] = (uint8_t)(sum & 0xFF);
+}
+
+static void op_sub(INSTR_ARGS) { // 8xy5: SUB Vx, Vy (Vx = Vx - Vy)
+    INSTR_UNUSED;
+    VF = (regs->V[in->x] > regs->V[in->y]) ? 1 : 0; // NOT borrow
+    regs->V[in->x] = (uint8_t)(regs->V[in->x] - regs->V[in->y]);
+}
+
+static void op_shr(INSTR_ARGS) { // 8xy6: SHR Vx (VF = LSB of Vx)
+    INSTR_UNUSED;
+    VF = (uint8_t)(regs->V[in->x] & 0x01);
+    regs->V[in->x] >>= 1;
+}
+
+static void op_subn(INSTR_ARGS) { // 8xy7: SUBN Vx, Vy (Vx = Vy - Vx)
+    INSTR_UNUSED;
+    VF = (regs->V[in->y] > regs->V[in->x]) ? 1 : 0; // NOT borrow
+    regs->V[in->x] = (uint8_t)(regs->V[in->y] - regs->V[in->x]);
+}
+
+static void op_shl(INSTR_ARGS) { // 8xyE: SHL Vx (VF = MSB of Vx)
+    INSTR_UNUSED;
+    VF = (uint8_t)((regs->V[in->x] & 0x80) ? 1 : 0);
+    regs->V[in->x] = (uint8_t)(regs->V[in->x] << 1);
+}
+
+/* VIP / XO-CHIP shifts: Vx = Vy shifted; VF is written last, so it wins when x == F. */
+static void op_shr_vy(INSTR_ARGS) { // 8xy6: SHR Vx, Vy
+    INSTR_UNUSED;
+    const uint8_t v = regs->V[in->y];
+    regs->V[in->x] = (uint8_t)(v >> 1);
+    VF = (uint8_t)(v & 0x01);
+}
+
+static void op_shl_vy(INSTR_ARGS) { // 8xyE: SHL Vx, Vy
+    INSTR_UNUSED;
+    const uint8_t v = regs->V[in->y];
+    regs->V[in->x] = (uint8_t)(v << 1);
+    VF = (uint8_t)(v >> 7);
+}
+
+static void op_ld_i(INSTR_ARGS) { // Annn: LD I, addr
+    INSTR_UNUSED;
+    regs->I = in->nnn;
+}
+
+static void op_rnd(INSTR_ARGS) { // Cxkk: RND Vx, byte
+    INSTR_UNUSED;
+    regs->V[in->x] = (uint8_t)((rng_next(&regs->rng) & 0xFF) & in->kk);
+}
+
+/* ---------- display ---------- */
+
+static void op_drw(INSTR_ARGS) { // Dxyn: DRW Vx, Vy, nibble (n == 0: SCHIP 16x16)
+    INSTR_UNUSED;
+    if (!screen) { CHIP8_LOG_ERROR("DRW: screen is NULL"); return; }
+
+    // One image per selected XO-CHIP plane, back to back in RAM.
+    const uint16_t I = regs->I;
+    const size_t per_plane = in->n ? in->n : 32u;
+    const size_t want = per_plane * screen_plane_count(screen);
+
+    // Clamp bytes so we never read past RAM end; well-formed ROMs keep I+len in bounds.
+    size_t len = want;
+    if (len > (size_t)MEMORY_SIZE - I) {
+        len = (size_t)MEMORY_SIZE - I;
+        CHIP8_LOG_WARN("DRW: sprite truncated at RAM end (I=0x%04X, %u -> %u bytes)", I, (unsigned)want, (unsigned)len);
     }
 
-    case 0x5000: { // 5xy0: SE Vx, Vy
-        if (n != 0x0)  {
-            CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
-            break;
-        }
+    uint8_t sprite[SCREEN_PLANES * 32] = { 0 };   // copied out since rows may straddle a RAM page
+    memory_read_block(mem, I, sprite, len);
+    const bool collision = in->n
+        ? screen_draw_sprite(screen, regs->V[in->x], regs->V[in->y], sprite, in->n)
+        : screen_draw_sprite16(screen, regs->V[in->x], regs->V[in->y], sprite);
+    VF = collision ? 1 : 0;
+}
 
-        if (regs->V[x] == regs->V[y]) regs->PC += 2;
-        break;
+static void op_drw_wait(INSTR_ARGS) { // Dxyn with display wait: draw, then idle until the 60 Hz tick
+    op_drw(in, regs, mem, screen, stack, kbd);
+    regs->vblank_wait = true;
+}
+
+/* ---------- keyboard ---------- */
+
+/* Shared by Ex9E / ExA1: returns false (and logs) when the key check fails. */
+static bool key_check(const Instr* in, Registers* regs, Keyboard* kbd, bool* out_down) {
+    Chip8Status st = keyboard_is_down(kbd, regs->V[in->x], out_down);
+    if (st != CHIP8_OK) {
+        // Out-of-range key or null ptr: do not skip; just log
+        CHIP8_LOG_ERROR("SKP/SKNP key check failed: %s (Vx=0x%02X)",
+                        chip8_status_str(st), regs->V[in->x]);
+        return false;
     }
+    return true;
+}
 
-    case 0x6000: { // 6xkk: LD Vx, byte
-        regs->V[x] = kk;
-        break;
+static void op_skp(INSTR_ARGS) { // Ex9E: SKP Vx: skip if key(Vx) is pressed
+    INSTR_UNUSED;
+    bool down = false;
+    if (key_check(in, regs, kbd, &down) && down) skip_next(regs, mem);
+}
+
+static void op_sknp(INSTR_ARGS) { // ExA1: SKNP Vx: skip if key(Vx) is NOT pressed
+    INSTR_UNUSED;
+    bool down = false;
+    if (key_check(in, regs, kbd, &down) && !down) skip_next(regs, mem);
+}
+
+static void op_ld_key(INSTR_ARGS) { // Fx0A: LD Vx, K — wait for key
+    INSTR_UNUSED;
+    if (!kbd) {
+        CHIP8_LOG_ERROR("Fx0A: Keyboard is NULL");
+        regs->PC -= 2;   // hold on this opcode
+        return;
     }
 
-    case 0x7000: { // 7xkk: ADD Vx by kk, byte
-        regs->V[x] += kk;
-        break;
+    uint8_t key = 0;
+    Chip8Status st = keyboard_first_pressed(kbd, &key);
+    if (st != CHIP8_OK) {
+        CHIP8_LOG_ERROR("Fx0A: key check failed: %s", chip8_status_str(st));
+        regs->PC -= 2;   // fail-safe: hold here
     }
 
-    case 0x8000:
-        switch (n) {
-        case 0x0: // 8xy0: LD Vx, Vy
-            regs->V[x] = regs->V[y];
-            break;
-        case 0x1: // 8xy1: OR Vx, Vy
-            regs->V[x] |= regs->V[y]; VF = 0; break;
-        case 0x2: // 8xy2: AND Vx, Vy
-            regs->V[x] &= regs->V[y]; VF = 0; break;
-        case 0x3: // 8xy3: XOR Vx, Vy
-            regs->V[x] ^= regs->V[y]; VF = 0; break;
-        case 0x4: { // 8xy4: ADD Vx, Vy (with carry)
-            uint16_t sum = (uint16_t)regs->V[x] + (uint16_t)regs->V[y];
-            VF = (sum > 0xFF) ? 1 : 0;
-            regs->V[x] = (uint8_t)(sum & 0xFF);
-            break;
-        }
-        case 0x5: { // 8xy5: SUB Vx, Vy (Vx = Vx - Vy)
-            VF = (regs->V[x] > regs->V[y]) ? 1 : 0; // NOT borrow
-            regs->V[x] = (uint8_t)(regs->V[x] - regs->V[y]);
-            break;
-        }
-        case 0x6: { // 8xy6: SHR Vx (VF = LSB of Vx)
-            VF = (uint8_t)(regs->V[x] & 0x01);
-            regs->V[x] >>= 1;
-            break;
-        }
-        case 0x7: { // 8xy7: SUBN Vx, Vy (Vx = Vy - Vx)
-            VF = (regs->V[y] > regs->V[x]) ? 1 : 0; // NOT borrow
-            regs->V[x] = (uint8_t)(regs->V[y] - regs->V[x]);
-            break;
-        }
-        case 0xE: { // 8xyE: SHL Vx (VF = MSB of Vx)
-            VF = (uint8_t)((regs->V[x] & 0x80) ? 1 : 0);
-            regs->V[x] = (uint8_t)(regs->V[x] << 1);
-            break;
-        }
-        default:
-            CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
-            break;
-        }
-        break;
+    regs->V[in->x] = key;   // store the key index 0..15
+    // caller already pre-incremented PC; just continue
+}
 
-    case 0x9000: { // 9xy0: SNE Vx, Vy
-        if (n != 0x0) {
-            CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
-            break;
-        }
-        if (regs->V[x] != regs->V[y]) regs->PC += 2;
-        break;
-    }
+/* ---------- Fx timers / I / memory ---------- */
+
+static void op_ld_vx_dt(INSTR_ARGS) { // Fx07: LD Vx, DT
+    INSTR_UNUSED;
+    regs->V[in->x] = regs->DT;
+}
+
+static void op_ld_dt(INSTR_ARGS) { // Fx15: LD DT, Vx
+    INSTR_UNUSED;
+    regs->DT = regs->V[in->x];
+}
+
+static void op_ld_st(INSTR_ARGS) { // Fx18: LD ST, Vx
+    INSTR_UNUSED;
+    regs->ST = regs->V[in->x];
+}
 
-    case 0xA000: { // Annn: LD I, addr
-        regs->I = nnn;
-        break;
+static void op_add_i(INSTR_ARGS) { // Fx1E: ADD I, Vx
+    INSTR_UNUSED;
+    regs->I += regs->V[in->x];
+    // VF unaffected in original Chip-8
+}
+
+static void op_ld_f(INSTR_ARGS) { // Fx29: LD F, Vx (font sprite address)
+    INSTR_UNUSED;
+    uint8_t digit = (uint8_t)(regs->V[in->x] & 0x0F);
+    regs->I = (uint16_t)(FONT_START_ADDR + digit * DEFAULT_SPRITE_HIGHT);
+}
+
+static void op_ld_hf(INSTR_ARGS) { // Fx30: LD HF, Vx (SCHIP big digit address)
+    INSTR_UNUSED;
+    uint8_t digit = (uint8_t)(regs->V[in->x] & 0x0F);
+    regs->I = (uint16_t)(BIG_FONT_START_ADDR + digit * BIG_SPRITE_HEIGHT);
+}
+
+static void op_bcd(INSTR_ARGS) { // Fx33: BCD of Vx at [I..I+2]
+    INSTR_UNUSED;
+    const uint8_t v = regs->V[in->x]; // v = d[0]*100 + d[1]*10 + d[2]
+    const uint8_t d[3] = { (uint8_t)(v / 100), (uint8_t)((v / 10) % 10), (uint8_t)(v % 10) };
+    if (!memory_store_fast(mem, regs->I, d, sizeof(d))) {
+        CHIP8_LOG_ERROR("Fx33 write OOB at I=0x%03X", regs->I);
     }
+}
 
-    case 0xB000: { // Bnnn: JP V0, addr
-        regs->PC = (uint16_t)(nnn + regs->V[0]);
-        break;
+/* Fx55 / Fx65 bodies; `advance` is a constant in every caller below, so each
+ * index quirk compiles to its own straight-line handler. */
+static inline void store_regs(const Instr* in, Registers* regs, Memory* mem, uint8_t advance) {
+    const uint8_t x = in->x;   // the store below may invalidate the decode slot holding `in`
+    const uint16_t I = regs->I;
+    if (!memory_store_fast(mem, I, regs->V, (size_t)x + 1u)) {
+        CHIP8_LOG_ERROR("Fx55 OOB: V0..V%X at I=0x%03X", (unsigned)x, I);
+        return;   // nothing stored; keep I unchanged on error
     }
+    regs->I = (uint16_t)(I + advance);
+}
 
-    case 0xC000: { // Cxkk: RND Vx, byte
-        regs->V[x] = (uint8_t)((rand() & 0xFF) & kk);
-        break;
+static inline void load_regs(const Instr* in, Registers* regs, Memory* mem, uint8_t advance) {
+    const uint8_t x = in->x;
+    const uint16_t I = regs->I;
+    if (!memory_load_fast(mem, I, regs->V, (size_t)x + 1u)) {
+        CHIP8_LOG_ERROR("Fx65 OOB: V0..V%X at I=0x%03X", (unsigned)x, I);
+        return;   // registers and I unchanged on error
     }
+    regs->I = (uint16_t)(I + advance);
+}
 
-    case 0xD000: { // Dxyn: DRW Vx, Vy, nibble
-        if (!screen) { CHIP8_LOG_ERROR("DRW: screen is NULL"); break; }
-        if (n == 0) { VF = 0; break; } // standard CHIP-8: n==0 draws 0 rows
+static void op_st_regs(INSTR_ARGS) { // Fx55: LD [I], V0..Vx
+    INSTR_UNUSED;
+    store_regs(in, regs, mem, (uint8_t)(in->x + 1)); // Original CHIP-8 increments I
+}
 
-        const uint16_t I = regs->I;
-        if (I >= MEMORY_SIZE) {
-            CHIP8_LOG_ERROR("DRW: I out of bounds: 0x%03X", I);
-            VF = 0;
-            break;
-        }
+static void op_ld_regs(INSTR_ARGS) { // Fx65: LD V0..Vx, [I]
+    INSTR_UNUSED;
+    load_regs(in, regs, mem, (uint8_t)(in->x + 1)); // Original CHIP-8 increments I
+}
 
-        // Clamp rows so we never read past RAM end; well-formed ROMs keep I+n in bounds.
-        uint8_t rows = n;
-        size_t max_rows = (size_t)MEMORY_SIZE - (size_t)I;
-        if ((size_t)rows > max_rows) {
-            rows = (uint8_t)max_rows;
-            CHIP8_LOG_WARN("DRW: sprite truncated at RAM end (I=0x%03X, n=%u -> rows=%u)", I, n, rows);
-        }
+static void op_st_regs_inc_x(INSTR_ARGS) { // Fx55, CHIP-48: I += x
+    INSTR_UNUSED;
+    store_regs(in, regs, mem, in->x);
+}
+
+static void op_ld_regs_inc_x(INSTR_ARGS) { // Fx65, CHIP-48: I += x
+    INSTR_UNUSED;
+    load_regs(in, regs, mem, in->x);
+}
+
+static void op_st_regs_keep(INSTR_ARGS) { // Fx55, SCHIP: I unchanged
+    INSTR_UNUSED;
+    store_regs(in, regs, mem, 0);
+}
+
+static void op_ld_regs_keep(INSTR_ARGS) { // Fx65, SCHIP: I unchanged
+    INSTR_UNUSED;
+    load_regs(in, regs, mem, 0);
+}
 
-        const uint8_t* sprite = &mem->memory[I];
-        bool collision = screen_draw_sprite(screen, regs->V[x], regs->V[y], sprite, rows);
-        VF = collision ? 1 : 0;
-        break;
+static void op_st_rpl(INSTR_ARGS) { // Fx75: LD R, Vx — save V0..Vx to the user flags
+    INSTR_UNUSED;
+    memcpy(regs->RPL, regs->V, (size_t)in->x + 1u);
+}
+
+static void op_ld_rpl(INSTR_ARGS) { // Fx85: LD Vx, R — restore V0..Vx from the user flags
+    INSTR_UNUSED;
+    memcpy(regs->V, regs->RPL, (size_t)in->x + 1u);
+}
+
+/* ---------- XO-CHIP ---------- */
+
+static void op_ld_long(INSTR_ARGS) { // F000 nnnn: LD I, long — 16-bit address in the next word
+    INSTR_UNUSED;
+    const uint16_t at = regs->PC;   // caller pre-incremented past the opcode
+    uint8_t word[2];
+    if (!memory_load_fast(mem, at, word, sizeof(word))) {
+        CHIP8_LOG_ERROR("F000: address word past RAM end at 0x%04X", at);
+        return;
     }
+    regs->I  = (uint16_t)((word[0] << 8) | word[1]);
+    regs->PC = (uint16_t)(at + 2);
+}
 
-    case 0xE000: { // Ex9E / ExA1
-        bool down = false;
-        Chip8Status st = keyboard_is_down(kbd, regs->V[x], &down);
-        if (st != CHIP8_OK) {
-            // Out-of-range key or null ptr: do not skip; just log
-            CHIP8_LOG_ERROR("SKP/SKNP key check failed: %s (Vx=0x%02X)",
-                            chip8_status_str(st), regs->V[x]);
-            break;
-        }
+/* Vx..Vy (descending when x > y) as a count, stepping `dir` from x. */
+static inline size_t reg_range(const Instr* in, int* dir) {
+    *dir = (in->x <= in->y) ? 1 : -1;
+    return (size_t)((in->x <= in->y) ? in->y - in->x : in->x - in->y) + 1u;
+}
 
-        switch (kk) {
-        case 0x9E: // SKP Vx: skip if key(Vx) is pressed
-            if (down) { regs->PC += 2; }
-            break;
+static void op_st_range(INSTR_ARGS) { // 5xy2: LD [I], Vx-Vy — I unchanged
+    INSTR_UNUSED;
+    const uint8_t x = in->x;   // the store below may invalidate the decode slot holding `in`
+    int dir;
+    const size_t n = reg_range(in, &dir);
+    uint8_t buf[NUM_REGS];
+    for (size_t i = 0; i < n; ++i) buf[i] = regs->V[x + dir * (int)i];
+    if (!memory_store_fast(mem, regs->I, buf, n)) {
+        CHIP8_LOG_ERROR("5xy2 OOB: %u registers at I=0x%04X", (unsigned)n, regs->I);
+    }
+}
 
-        case 0xA1: // SKNP Vx: skip if key(Vx) is NOT pressed
-            if (!down) { regs->PC += 2; }
-            break;
+static void op_ld_range(INSTR_ARGS) { // 5xy3: LD Vx-Vy, [I] — I unchanged
+    INSTR_UNUSED;
+    int dir;
+    const size_t n = reg_range(in, &dir);
+    uint8_t buf[NUM_REGS];
+    if (!memory_load_fast(mem, regs->I, buf, n)) {
+        CHIP8_LOG_ERROR("5xy3 OOB: %u registers at I=0x%04X", (unsigned)n, regs->I);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) regs->V[in->x + dir * (int)i] = buf[i];
+}
 
-        default:
-            CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
-            break;
-        }
-        
-        break;
+static void op_plane(INSTR_ARGS) { // Fn01: PLANE n — select bitplanes (mask 0..3)
+    INSTR_UNUSED;
+    screen_select_planes(screen, in->x);
+}
+
+static void op_audio(INSTR_ARGS) { // F002: AUDIO — load the 16-byte sample pattern from [I]
+    INSTR_UNUSED;
+    if (!memory_load_fast(mem, regs->I, regs->pattern, AUDIO_PATTERN_BYTES)) {
+        CHIP8_LOG_ERROR("F002 OOB at I=0x%04X", regs->I);
+        return;
     }
+    regs->has_pattern = true;
+}
 
-    case 0xF000:
-        switch (kk) {
-        case 0x07: // Fx07: LD Vx, DT
-            regs->V[x] = regs->DT;
-            break;
+static void op_pitch(INSTR_ARGS) { // Fx3A: PITCH Vx — pattern playback rate
+    INSTR_UNUSED;
+    regs->pitch = regs->V[in->x];
+}
 
-        case 0x0A: // Fx0A: LD Vx, K — wait for key
-            if (!kbd) {
-                CHIP8_LOG_ERROR("Fx0A: Keyboard is NULL");
-                regs->PC -= 2;   // hold on this opcode
-                break;
-            }
-
-            uint8_t key = 0;
-            Chip8Status st = keyboard_first_pressed(kbd, &key);
-            if (st != CHIP8_OK) {
-                CHIP8_LOG_ERROR("Fx0A: key check failed: %s", chip8_status_str(st));
-                regs->PC -= 2;   // fail-safe: hold here
-            }
-
-            regs->V[x] = key;   // store the key index 0..15
-            // caller already pre-incremented PC; just continue
-            break;
+/* ---------- decode ---------- */
 
-        case 0x15: // Fx15: LD DT, Vx
-            regs->DT = regs->V[x];
-            break;
+/* 8xy* kinds indexed by the low nibble; gaps are INSTR_UNKNOWN (0 is LD_REG). */
+static const InstrKind alu_table[16] = {
+    [0x0] = INSTR_LD_REG,  [0x1] = INSTR_OR,   [0x2] = INSTR_AND,  [0x3] = INSTR_XOR,
+    [0x4] = INSTR_ADD_REG, [0x5] = INSTR_SUB,  [0x6] = INSTR_SHR,  [0x7] = INSTR_SUBN,
+    [0x8] = INSTR_UNKNOWN, [0x9] = INSTR_UNKNOWN, [0xA] = INSTR_UNKNOWN, [0xB] = INSTR_UNKNOWN,
+    [0xC] = INSTR_UNKNOWN, [0xD] = INSTR_UNKNOWN, [0xE] = INSTR_SHL,  [0xF] = INSTR_UNKNOWN,
+};
 
-        case 0x18: // Fx18: LD ST, Vx
-            regs->ST = regs->V[x];
-            break;
+InstrKind instr_kind(uint16_t op) {
+    const uint8_t kk = OP_KK(op);
+    const uint8_t n  = OP_N(op);
 
-        case 0x1E: { // Fx1E: ADD I, Vx
-            regs->I += regs->V[x];
-            // VF unaffected in original Chip-8
-            break;
+    switch (op & 0xF000) {
+    case 0x0000:
+        if (op == 0x00E0) return INSTR_CLS;
+        if (op == 0x00EE) return INSTR_RET;
+        if ((op & 0xFFF0) == 0x00C0) return INSTR_SCD;
+        if ((op & 0xFFF0) == 0x00D0) return INSTR_SCU;
+        switch (op) {
+        case 0x00FB: return INSTR_SCR;
+        case 0x00FC: return INSTR_SCL;
+        case 0x00FD: return INSTR_EXIT;
+        case 0x00FE: return INSTR_LOW;
+        case 0x00FF: return INSTR_HIGH;
+        default:     return INSTR_SYS;
         }
-
-        case 0x29: { // Fx29: LD F, Vx (font sprite address)
-            uint8_t digit = (uint8_t)(regs->V[x] & 0x0F);
-            regs->I = (uint16_t)(FONT_START_ADDR + digit * DEFAULT_SPRITE_HIGHT);
-            break;
+    case 0x1000: return INSTR_JP;
+    case 0x2000: return INSTR_CALL;
+    case 0x3000: return INSTR_SE_IMM;
+    case 0x4000: return INSTR_SNE_IMM;
+    case 0x5000:
+        if (n == 0x0) return INSTR_SE_REG;
+        if (n == 0x2) return INSTR_ST_RANGE;
+        if (n == 0x3) return INSTR_LD_RANGE;
+        return INSTR_UNKNOWN;
+    case 0x6000: return INSTR_LD_IMM;
+    case 0x7000: return INSTR_ADD_IMM;
+    case 0x8000: return alu_table[n];
+    case 0x9000: return (n == 0x0) ? INSTR_SNE_REG : INSTR_UNKNOWN;
+    case 0xA000: return INSTR_LD_I;
+    case 0xB000: return INSTR_JP_V0;
+    case 0xC000: return INSTR_RND;
+    case 0xD000: return INSTR_DRW;
+    case 0xE000:
+        if (kk == 0x9E) return INSTR_SKP;
+        if (kk == 0xA1) return INSTR_SKNP;
+        return INSTR_UNKNOWN;
+    case 0xF000:
+        if (op == 0xF000) return INSTR_LD_LONG;
+        if (op == 0xF002) return INSTR_AUDIO;
+        switch (kk) {
+        case 0x01: return INSTR_PLANE;
+        case 0x07: return INSTR_LD_VX_DT;
+        case 0x0A: return INSTR_LD_KEY;
+        case 0x15: return INSTR_LD_DT;
+        case 0x18: return INSTR_LD_ST;
+        case 0x1E: return INSTR_ADD_I;
+        case 0x29: return INSTR_LD_F;
+        case 0x30: return INSTR_LD_HF;
+        case 0x3A: return INSTR_PITCH;
+        case 0x33: return INSTR_BCD;
+        case 0x55: return INSTR_ST_REGS;
+        case 0x65: return INSTR_LD_REGS;
+        case 0x75: return INSTR_ST_RPL;
+        case 0x85: return INSTR_LD_RPL;
+        default:   return INSTR_UNKNOWN;
         }
+    default:
+        return INSTR_UNKNOWN;
+    }
+}
 
-        case 0x33: { // Fx33: BCD of Vx at [I..I+2]
-            uint16_t I = regs->I;
-            uint8_t v  = regs->V[x]; // v = v0*100 + v1*10 + v2
-            Chip8Status v0 = memory_write(mem, I + 0, (uint8_t)(v / 100));
-            Chip8Status v1 = memory_write(mem, I + 1, (uint8_t)((v / 10) % 10));
-            Chip8Status v2 = memory_write(mem, I + 2, (uint8_t)(v % 10));
-            if (v0 != CHIP8_OK || v1 != CHIP8_OK || v2 != CHIP8_OK) {
-                CHIP8_LOG_ERROR("Fx33 write OOB at I=0x%03X", I);
-            }
-            break;
-        }
+/* Handler, mnemonic and disassembly template per kind. Template escapes:
+ * %x / %y register digit, %k byte, %a address, %n nibble (decimal), %o opcode. */
+static const struct {
+    InstrHandler fn;
+    const char*  name;
+    const char*  fmt;
+} kind_table[INSTR_KIND_COUNT] = {
+    [INSTR_CLS]      = { op_cls,      "CLS",              "CLS" },
+    [INSTR_RET]      = { op_ret,      "RET",              "RET" },
+    [INSTR_SYS]      = { op_sys,      "SYS addr",         "SYS 0x%a" },
+    [INSTR_JP]       = { op_jp,       "JP addr",          "JP 0x%a" },
+    [INSTR_CALL]     = { op_call,     "CALL addr",        "CALL 0x%a" },
+    [INSTR_SE_IMM]   = { op_se_imm,   "SE Vx, byte",      "SE V%x, 0x%k" },
+    [INSTR_SNE_IMM]  = { op_sne_imm,  "SNE Vx, byte",     "SNE V%x, 0x%k" },
+    [INSTR_SE_REG]   = { op_se_reg,   "SE Vx, Vy",        "SE V%x, V%y" },
+    [INSTR_SNE_REG]  = { op_sne_reg,  "SNE Vx, Vy",       "SNE V%x, V%y" },
+    [INSTR_JP_V0]    = { op_jp_v0,    "JP V0, addr",      "JP V0, 0x%a" },
+    [INSTR_LD_IMM]   = { op_ld_imm,   "LD Vx, byte",      "LD V%x, 0x%k" },
+    [INSTR_ADD_IMM]  = { op_add_imm,  "ADD Vx, byte",     "ADD V%x, 0x%k" },
+    [INSTR_LD_REG]   = { op_ld_reg,   "LD Vx, Vy",        "LD V%x, V%y" },
+    [INSTR_OR]       = { op_or,       "OR Vx, Vy",        "OR V%x, V%y" },
+    [INSTR_AND]      = { op_and,      "AND Vx, Vy",       "AND V%x, V%y" },
+    [INSTR_XOR]      = { op_xor,      "XOR Vx, Vy",       "XOR V%x, V%y" },
+    [INSTR_ADD_REG]  = { op_add_reg,  "ADD Vx, Vy",       "ADD V%x, V%y" },
+    [INSTR_SUB]      = { op_sub,      "SUB Vx, Vy",       "SUB V%x, V%y" },
+    [INSTR_SHR]      = { op_shr,      "SHR Vx",           "SHR V%x, V%y" },
+    [INSTR_SUBN]     = { op_subn,     "SUBN Vx, Vy",      "SUBN V%x, V%y" },
+    [INSTR_SHL]      = { op_shl,      "SHL Vx",           "SHL V%x, V%y" },
+    [INSTR_LD_I]     = { op_ld_i,     "LD I, addr",       "LD I, 0x%a" },
+    [INSTR_RND]      = { op_rnd,      "RND Vx, byte",     "RND V%x, 0x%k" },
+    [INSTR_DRW]      = { op_drw,      "DRW Vx, Vy, n",    "DRW V%x, V%y, %n" },
+    [INSTR_SKP]      = { op_skp,      "SKP Vx",           "SKP V%x" },
+    [INSTR_SKNP]     = { op_sknp,     "SKNP Vx",          "SKNP V%x" },
+    [INSTR_LD_VX_DT] = { op_ld_vx_dt, "LD Vx, DT",        "LD V%x, DT" },
+    [INSTR_LD_KEY]   = { op_ld_key,   "LD Vx, K",         "LD V%x, K" },
+    [INSTR_LD_DT]    = { op_ld_dt,    "LD DT, Vx",        "LD DT, V%x" },
+    [INSTR_LD_ST]    = { op_ld_st,    "LD ST, Vx",        "LD ST, V%x" },
+    [INSTR_ADD_I]    = { op_add_i,    "ADD I, Vx",        "ADD I, V%x" },
+    [INSTR_LD_F]     = { op_ld_f,     "LD F, Vx",         "LD F, V%x" },
+    [INSTR_BCD]      = { op_bcd,      "LD B, Vx",         "LD B, V%x" },
+    [INSTR_ST_REGS]  = { op_st_regs,  "LD [I], Vx",       "LD [I], V%x" },
+    [INSTR_LD_REGS]  = { op_ld_regs,  "LD Vx, [I]",       "LD V%x, [I]" },
+    [INSTR_SCD]      = { op_scd,      "SCD nibble",       "SCD %n" },
+    [INSTR_SCR]      = { op_scr,      "SCR",              "SCR" },
+    [INSTR_SCL]      = { op_scl,      "SCL",              "SCL" },
+    [INSTR_EXIT]     = { op_exit,     "EXIT",             "EXIT" },
+    [INSTR_LOW]      = { op_low,      "LOW",              "LOW" },
+    [INSTR_HIGH]     = { op_high,     "HIGH",             "HIGH" },
+    [INSTR_LD_HF]    = { op_ld_hf,    "LD HF, Vx",        "LD HF, V%x" },
+    [INSTR_ST_RPL]   = { op_st_rpl,   "LD R, Vx",         "LD R, V%x" },
+    [INSTR_LD_RPL]   = { op_ld_rpl,   "LD Vx, R",         "LD V%x, R" },
+    [INSTR_SCU]      = { op_scu,      "SCU nibble",       "SCU %n" },
+    [INSTR_LD_LONG]  = { op_ld_long,  "LD I, long",       "LD I, long" },
+    [INSTR_ST_RANGE] = { op_st_range, "LD [I], Vx-Vy",    "LD [I], V%x-V%y" },
+    [INSTR_LD_RANGE] = { op_ld_range, "LD Vx-Vy, [I]",    "LD V%x-V%y, [I]" },
+    [INSTR_PLANE]    = { op_plane,    "PLANE x",          "PLANE %x" },
+    [INSTR_AUDIO]    = { op_audio,    "AUDIO",            "AUDIO" },
+    [INSTR_PITCH]    = { op_pitch,    "PITCH Vx",         "PITCH V%x" },
+    [INSTR_UNKNOWN]  = { op_unknown,  "???",              "DW 0x%o" },
+};
+
+const char* instr_kind_name(InstrKind kind) {
+    return ((unsigned)kind < INSTR_KIND_COUNT) ? kind_table[kind].name : "???";
+}
 
-        case 0x55: { // Fx55: LD [I], V0..Vx
-            uint16_t I = regs->I;
-            bool ok = true;
-            for (uint8_t i = 0; i <= x; ++i) {
-                if (memory_write(mem, (uint16_t)(I + i), regs->V[i]) != CHIP8_OK) {
-                    CHIP8_LOG_ERROR("Fx55 OOB at I+%u (I=0x%03X)", (unsigned)i, I);
-                    ok = false; break;
-                }
-            }
-            // Original CHIP-8 increments I; keep I unchanged on error
-            if (ok) regs->I = (uint16_t)(I + x + 1);
-            break;
-        }
+static const char HEX_DIGITS[16] = "0123456789ABCDEF";
 
-        case 0x65: { // Fx65: LD V0..Vx, [I]
-            uint16_t I = regs->I;
-            bool ok = true;
-            for (uint8_t i = 0; i <= x; ++i) {
-                uint8_t v = 0;
-                if (memory_read(mem, (uint16_t)(I + i), &v) != CHIP8_OK) {
-                    CHIP8_LOG_ERROR("Fx65 OOB at I+%u (I=0x%03X)", (unsigned)i, I);
-                    ok = false; break;
-                }
-                regs->V[i] = v;
-            }
-            if (ok) regs->I = (uint16_t)(I + x + 1); // Original CHIP-8 increments I
-            break;
-        }
+static size_t put_hex(char* out, unsigned v, int digits) {
+    for (int i = 0; i < digits; ++i) out[i] = HEX_DIGITS[(v >> (4 * (digits - 1 - i))) & 0xFu];
+    return (size_t)digits;
+}
 
-        default:
-            CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
+size_t instr_disasm(uint16_t op, char* buf, size_t cap) {
+    /* Expand into a scratch line first: the longest template fits easily. */
+    char line[INSTR_DISASM_MAX];
+    size_t n = 0;
+    for (const char* f = kind_table[instr_kind(op)].fmt; *f; ++f) {
+        if (*f != '%') {
+            line[n++] = *f;
+            continue;
+        }
+        switch (*++f) {
+        case 'x': line[n++] = HEX_DIGITS[OP_X(op)]; break;
+        case 'y': line[n++] = HEX_DIGITS[OP_Y(op)]; break;
+        case 'k': n += put_hex(line + n, OP_KK(op), 2); break;
+        case 'a': n += put_hex(line + n, OP_NNN(op), 3); break;
+        case 'o': n += put_hex(line + n, op, 4); break;
+        case 'n':
+            if (OP_N(op) >= 10) line[n++] = '1';
+            line[n++] = (char)('0' + OP_N(op) % 10);
             break;
+        default: break;
         }
-        break;
+    }
 
-    default:
-        CHIP8_LOG_WARN("Unimplemented opcode: 0x%04X", op);
-        break;
+    if (buf && cap > 0) {
+        const size_t w = (n < cap) ? n : cap - 1;
+        memcpy(buf, line, w);
+        buf[w] = '\0';
     }
+    return n;
+}
+
+/* Handler for `kind` under profile `p`: the quirk is resolved here, once per
+ * decode, by picking the variant that hard-codes it. */
+static InstrHandler quirk_handler(InstrKind kind, const QuirksProfile* p) {
+    static const InstrHandler st_regs[] = {
+        [QUIRK_INDEX_INC] = op_st_regs, [QUIRK_INDEX_INC_X] = op_st_regs_inc_x, [QUIRK_INDEX_KEEP] = op_st_regs_keep,
+    };
+    static const InstrHandler ld_regs[] = {
+        [QUIRK_INDEX_INC] = op_ld_regs, [QUIRK_INDEX_INC_X] = op_ld_regs_inc_x, [QUIRK_INDEX_KEEP] = op_ld_regs_keep,
+    };
+
+    switch (kind) {
+    case INSTR_OR:      return p->vf_reset ? op_or  : op_or_keep;
+    case INSTR_AND:     return p->vf_reset ? op_and : op_and_keep;
+    case INSTR_XOR:     return p->vf_reset ? op_xor : op_xor_keep;
+    case INSTR_SHR:     return p->shift_vy ? op_shr_vy : op_shr;
+    case INSTR_SHL:     return p->shift_vy ? op_shl_vy : op_shl;
+    case INSTR_JP_V0:   return p->jump_vx  ? op_jp_vx  : op_jp_v0;
+    case INSTR_DRW:     return p->display_wait ? op_drw_wait : op_drw;
+    case INSTR_ST_REGS: return st_regs[p->index];
+    case INSTR_LD_REGS: return ld_regs[p->index];
+    default:            return kind_table[kind].fn;
+    }
+}
+
+void instr_decode_quirks(uint16_t op, Chip8Quirks quirks, Instr* out) {
+    if (!out) return;
+    out->op  = op;
+    out->nnn = OP_NNN(op);
+    out->x   = OP_X(op);
+    out->y   = OP_Y(op);
+    out->kk  = OP_KK(op);
+    out->n   = OP_N(op);
+    out->fn  = quirk_handler(instr_kind(op), quirks_profile(quirks));
+}
+
+void instr_decode(uint16_t op, Instr* out) {
+    instr_decode_quirks(op, CHIP8_QUIRKS_DEFAULT, out);
+}
+
+bool instr_ends_block(const Instr* in) {
+    if (!in) return true;
+    const InstrHandler fn = in->fn;
+
+    /* Whitelist: register/timer/I updates that always fall through to PC + 2. */
+    return !(fn == op_sys     || fn == op_ld_imm  || fn == op_add_imm ||
+             fn == op_ld_reg  || fn == op_or      || fn == op_and     ||
+             fn == op_xor     || fn == op_add_reg || fn == op_sub     ||
+             fn == op_shr     || fn == op_subn    || fn == op_shl     ||
+             fn == op_ld_i    || fn == op_rnd     || fn == op_ld_vx_dt ||
+             fn == op_ld_dt   || fn == op_ld_st   || fn == op_add_i   ||
+             fn == op_ld_f    || fn == op_ld_regs || fn == op_ld_hf   ||
+             fn == op_st_rpl  || fn == op_ld_rpl  || fn == op_ld_range ||
+             fn == op_audio   || fn == op_pitch   ||
+             fn == op_or_keep || fn == op_and_keep || fn == op_xor_keep ||
+             fn == op_shr_vy  || fn == op_shl_vy  ||
+             fn == op_ld_regs_inc_x || fn == op_ld_regs_keep);
+}
+
+void exec(uint16_t op,
+          Registers* regs,
+          Memory* mem,
+          Screen* screen,
+          Stack* stack,
+          Keyboard* kbd)
+{
+    Instr in;
+    instr_decode(op, &in);
+    in.fn(&in, regs, mem, screen, stack, kbd);
 }
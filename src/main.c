@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "config.h"
 #include "chip8.h"
@@ -13,6 +14,9 @@
 #include "instr.h"
 #include "timer.h"
 #include "beep.h"   // Beeper*, bool beep_init(Beeper** , int freq_hz, float volume); void beep_set(Beeper*, bool on);
+#include "display.h"
+#include "rewind.h"
+#include "replay.h"
 
 /* Map SDL keycode to CHIP-8 key index [0..15], return -1 if not a CHIP-8 key. */
 static int map_sdl_key_to_chip8(SDL_Keycode kc) {
@@ -50,37 +54,41 @@ static void sdl_die(const char *where) {
     fprintf(stderr, "[%s] SDL error: %s\n", where, (e && *e) ? e : "(empty)");
 }
 
-/* Render the logical 64x32 display buffer to the SDL renderer. */
-static void draw_screen(SDL_Renderer* renderer, const Screen* scr) {
-    const uint8_t* px = screen_pixels(scr);
-    if (!px) return;
-
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    const int scale = EMULATOR_WINDOW_SCALER;
-
-    for (int y = 0; y < DISPLAY_HEIGHT; ++y) {
-        for (int x = 0; x < DISPLAY_WIDTH; ++x) {
-            if (px[y * DISPLAY_WIDTH + x]) {
-                SDL_FRect r = { (float)(x * scale), (float)(y * scale),
-                                (float)scale,        (float)scale };
-                SDL_RenderFillRect(renderer, &r);
-            }
+int main(int argc, char **argv) {
+    const char* rom_path = NULL;
+    bool want_vsync = false;
+    unsigned long rewind_mb = 8;   /* rewind history size; 0 disables it */
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    const char* quirks_name = "auto";
+    bool bad_args = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--vsync") == 0) want_vsync = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+        else if (strcmp(argv[i], "--quirks") == 0 && i + 1 < argc) quirks_name = argv[++i];
+        else if (strcmp(argv[i], "--rewind-mb") == 0 && i + 1 < argc) {
+            char* end = NULL;
+            rewind_mb = strtoul(argv[++i], &end, 10);
+            if (!end || *end != '\0') bad_args = true;
         }
+        else if (!rom_path) rom_path = argv[i];
     }
-    SDL_RenderPresent(renderer);
-}
-
-int main(int argc, char **argv) {
-    if (argc < 2) {
-        fprintf(stderr, "Usage: %s <path/to/rom>\n", (argc > 0 ? argv[0] : "chip8"));
+    const bool quirks_auto = strcmp(quirks_name, "auto") == 0;
+    Chip8Quirks quirks = CHIP8_QUIRKS_DEFAULT;
+    if (!quirks_auto && !quirks_from_name(quirks_name, &quirks)) bad_args = true;
+    if (!rom_path || bad_args || (record_path && replay_path)) {
+        fprintf(stderr, "Usage: %s [--vsync] [--rewind-mb N] [--quirks P] [--record F | --replay F] <path/to/rom>\n"
+                        "  hold Backspace to rewind frame by frame\n"
+                        "  --quirks P  auto (ROM database, the default), default, vip, chip48,\n"
+                        "              schip or xochip\n"
+                        "  --record F  save keypad input to F on exit (disables rewind)\n"
+                        "  --replay F  play back F, then continue with live input\n",
+                (argc > 0 ? argv[0] : "chip8"));
         return 2;
     }
-    const char* rom_path = argv[1];
 
-    struct Chip8 chip8;
+    static struct Chip8 chip8;   /* off the stack: profiler builds add 512 KB of counters */
     chip8_init(&chip8);
 
     /* Load ROM into memory at PROGRAM_START_ADDRESS (0x200). */
@@ -90,6 +98,47 @@ int main(int argc, char **argv) {
         return 3;
     }
     chip8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    chip8_set_quirks(&chip8, quirks_auto ? chip8_detect_quirks(&chip8) : quirks);
+    const uint64_t rom_hash = input_log_rom_hash(&chip8.chip8_mem);
+
+    /* Replays reproduce the recorded seed, quirks profile and frame length (below);
+       they must match the ROM and any explicit --quirks. */
+    InputLog replay_log;
+    InputPlayer player;
+    input_player_init(&player, NULL);
+    if (replay_path) {
+        Chip8Status ls = input_log_load(&replay_log, replay_path);
+        if (ls == CHIP8_OK && replay_log.rom_hash != rom_hash) {
+            input_log_free(&replay_log);
+            ls = CHIP8_ERR_REPLAY_ROM_MISMATCH;
+        } else if (ls == CHIP8_OK && !quirks_auto && replay_log.quirks != quirks) {
+            input_log_free(&replay_log);
+            ls = CHIP8_ERR_REPLAY_QUIRKS_MISMATCH;
+        }
+        if (ls != CHIP8_OK) {
+            fprintf(stderr, "Failed to load recording: %s (%s)\n", replay_path, chip8_status_str(ls));
+            chip8_destroy(&chip8);
+            return 3;
+        }
+        input_player_init(&player, &replay_log);
+        chip8_seed(&chip8, replay_log.seed);
+        chip8_set_quirks(&chip8, replay_log.quirks);
+    }
+
+    /* Rewinding would desynchronise a recording or replay from its cycle counts. */
+    if (record_path || replay_path) rewind_mb = 0;
+
+    /* Rewind history: one XOR-delta record per frame; oldest frames fall off. */
+    RewindBuffer* rewind = NULL;
+    if (rewind_mb > 0) {
+        Chip8Status rws = rewind_init(&rewind, (size_t)rewind_mb * 1024u * 1024u);
+        if (rws != CHIP8_OK) {
+            fprintf(stderr, "Rewind disabled: %s\n", chip8_status_str(rws));
+            rewind = NULL;
+        } else {
+            rewind_record(rewind, &chip8);
+        }
+    }
 
     /* Init SDL (video + audio). */
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO)) {
@@ -104,26 +153,48 @@ int main(int argc, char **argv) {
         beeper = NULL; // continue without sound
     }
 
-    /* Create window and renderer. */
-    const int win_w = DISPLAY_WIDTH  * EMULATOR_WINDOW_SCALER;
-    const int win_h = DISPLAY_HEIGHT * EMULATOR_WINDOW_SCALER;
+    /* Create window, renderer and the streaming framebuffer texture. */
+    Display* display = NULL;
+    if (!display_init(&display, EMULATOR_WINDOW_TITLE, EMULATOR_WINDOW_SCALER)) {
+        sdl_die("display_init");
+        beep_destroy(beeper);
+        SDL_Quit();
+        return 1;
+    }
+    bool force_redraw = true;   /* first frame, and after resize/expose */
 
-    SDL_Window *window = SDL_CreateWindow("Chip8 Window", win_w, win_h, SDL_WINDOW_RESIZABLE);
-    if (!window) { sdl_die("SDL_CreateWindow"); SDL_Quit(); return 1; }
+    /* Frame scheduler:
+       - each 60 Hz frame runs a fixed CYCLES_PER_FRAME (~700 Hz CPU), or a replay's
+         recorded frame length, and ticks DT/ST once
+       - with --vsync, presenting every frame paces the loop (60 Hz displays);
+         otherwise we present only when dirty and sleep until the next frame deadline
+       - frames that start more than one period late are counted as missed
+     */
+    const uint64_t NS_PER_SEC       = 1000000000ull;
+    const uint64_t CPU_HZ           = 700ull;
+    const uint32_t CYCLES_PER_FRAME = (uint32_t)((CPU_HZ + TIMER_CLOCK_HZ / 2) / TIMER_CLOCK_HZ);
+    const uint64_t NS_PER_FRAME     = NS_PER_SEC / TIMER_CLOCK_HZ;
+    /* a replay keeps its recorded frame length, also once live input takes over */
+    const uint32_t cycles_per_frame = replay_path ? replay_log.cycles_per_frame : CYCLES_PER_FRAME;
 
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, NULL);
-    if (!renderer) { sdl_die("SDL_CreateRenderer"); SDL_DestroyWindow(window); SDL_Quit(); return 1; }
+    /* Input recording: keypad changes tagged with the cycle they apply before. */
+    InputLog record_log;
+    if (record_path) input_log_init(&record_log, 0, rom_hash, chip8_get_quirks(&chip8), cycles_per_frame);
+    uint64_t cycle = 0;   /* CPU cycles executed so far */
 
-    /* Timing configuration:
-       - CPU runs ~700 Hz (typical range 500..1000)
-       - DT/ST are updated at 60 Hz inside regs_tick_timers() using wall-clock ns
-     */
-    const uint64_t NS_PER_SEC   = 1000000000ull;
-    const uint64_t CPU_HZ       = 700ull;
-    const uint64_t NS_PER_CYCLE = NS_PER_SEC / CPU_HZ;
+    const bool vsync = want_vsync && display_set_vsync(display, true);
+    if (want_vsync && !vsync) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "vsync unavailable, using timed frames");
+    }
 
-    uint64_t last_ns  = SDL_GetTicksNS();
-    uint64_t accum_ns = 0;
+    uint64_t frames = 0, missed = 0;
+    uint64_t deadline_ns = SDL_GetTicksNS() + NS_PER_FRAME;
+    bool beeping = false;
+    bool pattern_sent = false;   /* XO-CHIP audio pattern last handed to the beeper */
+    uint8_t sent_pattern[AUDIO_PATTERN_BYTES];
+    uint8_t sent_pitch = 0;
+    bool rewinding = false;   /* Backspace held */
+    bool replaying = replay_path && replay_log.end_cycle > 0;   /* live keypad ignored until the log ends */
 
     bool running = true;
     while (running) {
@@ -132,10 +203,15 @@ int main(int argc, char **argv) {
         while (SDL_PollEvent(&ev)) {
             if (ev.type == SDL_EVENT_QUIT) {
                 running = false;
+            } else if (ev.type == SDL_EVENT_WINDOW_EXPOSED ||
+                       ev.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) {
+                force_redraw = true;
             } else if (ev.type == SDL_EVENT_KEY_DOWN) {
                 SDL_Keycode kc = ev.key.key;  // SDL3 stores SDL_Keycode in ev.key.key
+                if (kc == SDLK_BACKSPACE) rewinding = true;
                 int ck = map_sdl_key_to_chip8(kc);
-                if (ck >= 0) {
+                if (ck >= 0 && !replaying && !ev.key.repeat) {
+                    if (record_path) input_log_append(&record_log, cycle, (uint8_t)ck, true);
                     Chip8Status st = keyboard_press(&chip8.chip8_kbd, (uint8_t)ck);
                     if (st != CHIP8_OK) {
                         CHIP8_LOG_ERROR("keyboard_press failed: %s (chip8=0x%X)",
@@ -144,8 +220,10 @@ int main(int argc, char **argv) {
                 }
             } else if (ev.type == SDL_EVENT_KEY_UP) {
                 SDL_Keycode kc = ev.key.key;
+                if (kc == SDLK_BACKSPACE) rewinding = false;
                 int ck = map_sdl_key_to_chip8(kc);
-                if (ck >= 0) {
+                if (ck >= 0 && !replaying) {
+                    if (record_path) input_log_append(&record_log, cycle, (uint8_t)ck, false);
                     Chip8Status st = keyboard_release(&chip8.chip8_kbd, (uint8_t)ck);
                     if (st != CHIP8_OK) {
                         CHIP8_LOG_ERROR("keyboard_release failed: %s (chip8=0x%X)",
@@ -155,46 +233,104 @@ int main(int argc, char **argv) {
             }
         }
 
-        /* Accumulate wall-clock time and run as many CPU cycles as fit the budget. */
-        const uint64_t now_ns = SDL_GetTicksNS();
-        const uint64_t dt_ns  = now_ns - last_ns;
-        last_ns = now_ns;
-        accum_ns += dt_ns;
-
-        while (accum_ns >= NS_PER_CYCLE) {
-            accum_ns -= NS_PER_CYCLE;
-
-            /* One CPU step: fetch+execute. chip8_step() does PC += 2 pre-step internally. */
-            Chip8Status cs = chip8_step(&chip8);
+        if (rewinding && rewind) {
+            /* Step back one recorded frame; stay on the oldest once exhausted. */
+            Chip8Status rs = rewind_step_back(rewind, &chip8);
+            if (rs != CHIP8_OK && rs != CHIP8_ERR_REWIND_EMPTY) {
+                CHIP8_LOG_ERROR("rewind_step_back failed: %s", chip8_status_str(rs));
+            }
+        } else {
+            /* One frame of CPU work, then DT/ST tick once. */
+            uint32_t ran = 0;
+            Chip8Status cs;
+            if (replaying) {
+                cs = input_player_run_frame(&player, &chip8, &cycle);
+                replaying = cycle < replay_log.end_cycle;
+            } else {
+                cs = chip8_run_frame(&chip8, cycles_per_frame, &ran);
+                cycle += ran;
+            }
             if (cs != CHIP8_OK) {
-                CHIP8_LOG_ERROR("chip8_step failed: %s (PC=0x%03X)",
+                CHIP8_LOG_ERROR("chip8_run_frame failed: %s (PC=0x%03X)",
                                 chip8_status_str(cs), chip8.chip8_regs.PC);
                 running = false;
-                break;
             }
+            if (rewind) rewind_record(rewind, &chip8);
         }
+        ++frames;
 
-        /* 60 Hz timers (DT/ST) and beep control. */
-        bool start_beep = false, stop_beep = false;
-        regs_tick_timers(&chip8.chip8_regs, dt_ns, &start_beep, &stop_beep);
-        if (start_beep && beeper) beep_set(beeper, true);
-        if (stop_beep  && beeper) beep_set(beeper, false);
+        /* XO-CHIP: once F002 has loaded a pattern, ST plays it instead of the
+           tone (rewinding to before that brings the tone back). */
+        const Registers* regs = &chip8.chip8_regs;
+        if (beeper && regs->has_pattern &&
+            (!pattern_sent || sent_pitch != regs->pitch ||
+             memcmp(sent_pattern, regs->pattern, AUDIO_PATTERN_BYTES) != 0)) {
+            memcpy(sent_pattern, regs->pattern, AUDIO_PATTERN_BYTES);
+            sent_pitch   = regs->pitch;
+            pattern_sent = true;
+            beep_set_pattern(beeper, sent_pattern, sent_pitch);
+        } else if (beeper && !regs->has_pattern && pattern_sent) {
+            pattern_sent = false;
+            beep_set_pattern(beeper, NULL, 0);
+        }
 
-        /* Redraw only when display changed. */
-        if (screen_consume_dirty(&chip8.chip8_disp)) {
-            draw_screen(renderer, &chip8.chip8_disp);
+        /* Beep follows ST: on while non-zero. */
+        const bool st_nonzero = (chip8.chip8_regs.ST > 0);
+        if (st_nonzero != beeping) {
+            beeping = st_nonzero;
+            if (beeper) beep_set(beeper, beeping);
         }
 
-        /* Small sleep to keep CPU usage in check. */
-        SDL_Delay(1);
+        /* Uploads dirty rows, one scaled blit; under vsync present every frame. */
+        display_update(display, &chip8.chip8_disp, force_redraw || vsync);
+        force_redraw = false;
+
+        /* Waiting for a key (or halted) with both timers at zero: no frame can
+           change anything until input arrives, so sleep until the next event.
+           The emulated clock simply pauses; cycle counts stay exact. */
+        const Chip8Idle idle = chip8_idle_state(&chip8);
+        if (running && !rewinding && !replaying && !vsync &&
+            (idle == CHIP8_IDLE_KEY || idle == CHIP8_IDLE_HALT) &&
+            chip8.chip8_regs.DT == 0 && chip8.chip8_regs.ST == 0) {
+            SDL_WaitEventTimeout(NULL, 250);
+            deadline_ns = SDL_GetTicksNS();
+        }
+
+        const uint64_t now_ns = SDL_GetTicksNS();
+        if (now_ns > deadline_ns + NS_PER_FRAME) {
+            /* Fell behind: count the skipped periods and re-anchor instead of bursting. */
+            missed += (now_ns - deadline_ns) / NS_PER_FRAME;
+            deadline_ns = now_ns + NS_PER_FRAME;
+        } else {
+            if (!vsync && now_ns < deadline_ns) SDL_DelayPrecise(deadline_ns - now_ns);
+            deadline_ns += NS_PER_FRAME;
+        }
     }
 
+    SDL_Log("frames=%llu missed=%llu", (unsigned long long)frames, (unsigned long long)missed);
+#ifdef CHIP8_PROFILE
+    prof_report(&chip8.chip8_prof, &chip8.chip8_mem, stderr, 20);
+#endif
+
     /* Stop beep (if any) before shutdown. */
     if (beeper) beep_set(beeper, false);
     beep_destroy(beeper);
 
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    display_destroy(display);
     SDL_Quit();
+    if (record_path) {
+        record_log.end_cycle = cycle;
+        Chip8Status ws = input_log_save(&record_log, record_path);
+        if (ws != CHIP8_OK) {
+            fprintf(stderr, "Failed to save recording: %s (%s)\n", record_path, chip8_status_str(ws));
+        } else {
+            SDL_Log("recorded %zu input events over %llu cycles to %s",
+                    record_log.count, (unsigned long long)cycle, record_path);
+        }
+        input_log_free(&record_log);
+    }
+    if (replay_path) input_log_free(&replay_log);
+    rewind_destroy(rewind);
+    chip8_destroy(&chip8);
     return 0;
 }
@@ -1,14 +1,44 @@
 #include "mem.h"
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
-/* Compile-time guard: font must fit into memory at FONT_START_ADDR */
+/* Page refcounts are shared between forks that may run on different threads. */
+#if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+  typedef volatile long RefCount;
+  #define REF_LOAD(r)  (*(r))
+  #define REF_SET(r, v) (*(r) = (v))
+  #define REF_INC(r)   ((void)_InterlockedIncrement(r))
+  #define REF_DEC(r)   (_InterlockedDecrement(r))          /* returns new value */
+#else
+  #include <stdatomic.h>
+  typedef atomic_long RefCount;
+  #define REF_LOAD(r)  atomic_load_explicit((r), memory_order_acquire)
+  #define REF_SET(r, v) atomic_init((r), (v))
+  #define REF_INC(r)   ((void)atomic_fetch_add_explicit((r), 1, memory_order_relaxed))
+  #define REF_DEC(r)   (atomic_fetch_sub_explicit((r), 1, memory_order_acq_rel) - 1)
+#endif
+
+struct MemPage {
+    RefCount refs;                  /* unused for the static pages */
+    uint8_t  bytes[MEM_PAGE_SIZE];
+};
+
+/* Compile-time guards: pages tile memory, the font fits into page 0 and the
+ * SCHIP big font into page 1 */
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
-_Static_assert(FONT_START_ADDR + 80u <= MEMORY_SIZE, "fontset overflows memory");
+_Static_assert(MEMORY_SIZE % MEM_PAGE_SIZE == 0, "pages must tile memory");
+_Static_assert(MEMORY_SIZE == 0x10000, "every uint16_t address is in RAM (XO-CHIP)");
+_Static_assert(FONT_START_ADDR + 80u <= MEM_PAGE_SIZE, "fontset must fit into page 0");
+_Static_assert(BIG_FONT_START_ADDR == MEM_PAGE_SIZE && 100u <= MEM_PAGE_SIZE, "big font must fill the start of page 1");
 #endif
 
-/* Built-in font data (0-F) */
-static const uint8_t fontset[80] = {
+/* Shared, never-freed pages: all zeroes, page 0 with the built-in font (0-F)
+ * and page 1 with the SCHIP 8x10 font (0-9) */
+static MemPage zero_page;
+static MemPage font_page = { .bytes = {
+    [FONT_START_ADDR] =
     0xF0, 0x90, 0x90, 0x90, 0xF0, /* 0 */
     0x20, 0x60, 0x20, 0x20, 0x70, /* 1 */
     0xF0, 0x10, 0xF0, 0x80, 0xF0, /* 2 */
@@ -25,45 +55,164 @@ static const uint8_t fontset[80] = {
     0xE0, 0x90, 0x90, 0x90, 0xE0, /* D */
     0xF0, 0x80, 0xF0, 0x80, 0xF0, /* E */
     0xF0, 0x80, 0xF0, 0x80, 0x80  /* F */
-};
+} };
+static MemPage big_font_page = { .bytes = {
+    0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C, /* 0 */
+    0x18, 0x38, 0x58, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, /* 1 */
+    0x3E, 0x7F, 0xC3, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xFF, 0xFF, /* 2 */
+    0x3C, 0x7E, 0xC3, 0x03, 0x0E, 0x0E, 0x03, 0xC3, 0x7E, 0x3C, /* 3 */
+    0x06, 0x0E, 0x1E, 0x36, 0x66, 0xC6, 0xFF, 0xFF, 0x06, 0x06, /* 4 */
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFE, 0x03, 0xC3, 0x7E, 0x3C, /* 5 */
+    0x3E, 0x7C, 0xC0, 0xC0, 0xFC, 0xFE, 0xC3, 0xC3, 0x7E, 0x3C, /* 6 */
+    0xFF, 0xFF, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x60, 0x60, /* 7 */
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7E, 0x7E, 0xC3, 0xC3, 0x7E, 0x3C, /* 8 */
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7F, 0x3F, 0x03, 0x03, 0x3E, 0x7C  /* 9 */
+} };
+
+static inline bool memory_range_in_bounds(uint16_t addr, size_t len) {
+    return len <= (size_t)MEMORY_SIZE - addr;   /* every uint16_t address is in RAM */
+}
+
+static inline void memory_notify(Memory* m, uint16_t addr, size_t len) {
+    if (m->on_write) m->on_write(m->on_write_ctx, addr, len);
+}
+
+/* ---------- page refcounting ---------- */
+
+static inline bool page_is_static(const MemPage* p) {
+    return p == &zero_page || p == &font_page || p == &big_font_page;
+}
 
-static inline bool memory_addr_in_bounds(uint16_t addr) {
-    return addr >= 0 && addr < MEMORY_SIZE;
+static inline void page_set(Memory* m, size_t i, MemPage* p) {
+    m->pages[i] = p;
+    m->bytes[i] = p->bytes;
+}
+
+static void page_unref(MemPage* p) {
+    if (page_is_static(p)) return;
+    if (REF_DEC(&p->refs) == 0) free(p);
+}
+
+/* Make page `i` private to `m` so it can be written in place. */
+static Chip8Status page_own(Memory* m, size_t i) {
+    MemPage* p = m->pages[i];
+    if (!page_is_static(p) && REF_LOAD(&p->refs) == 1) return CHIP8_OK;
+
+    MemPage* copy = (MemPage*)malloc(sizeof(MemPage));
+    if (!copy) {
+        CHIP8_LOG_ERROR("Out of memory duplicating RAM page %u", (unsigned)i);
+        return CHIP8_ERR_OUT_OF_MEMORY;
+    }
+    REF_SET(&copy->refs, 1);
+    memcpy(copy->bytes, p->bytes, MEM_PAGE_SIZE);
+    page_set(m, i, copy);
+    page_unref(p);
+    return CHIP8_OK;
+}
+
+/* ---------- lifecycle ---------- */
+
+void memory_release(Memory* m) {
+    assert(m);
+    for (size_t i = 0; i < MEM_PAGE_COUNT; ++i) {
+        if (m->pages[i]) page_unref(m->pages[i]);
+        page_set(m, i, &zero_page);
+    }
 }
 
 void memory_reset(Memory* m) {
     assert(m);
-    memset(m->memory, 0, MEMORY_SIZE);
+    memory_release(m);
+    memory_notify(m, 0, MEMORY_SIZE);
 }
 
 void memory_init(Memory* m) {
     assert(m);
-    memory_reset(m);
-    /* In case static assertion is not available, keep a debug assert too */
-    assert((uint32_t)FONT_START_ADDR + (uint32_t)sizeof(fontset) <= (uint32_t)MEMORY_SIZE);
-    memcpy(&m->memory[FONT_START_ADDR], fontset, sizeof(fontset));
+    for (size_t i = 0; i < MEM_PAGE_COUNT; ++i) page_set(m, i, &zero_page);
+    page_set(m, 0, &font_page);
+    page_set(m, BIG_FONT_START_ADDR >> MEM_PAGE_SHIFT, &big_font_page);
+    memory_notify(m, 0, MEMORY_SIZE);
+}
+
+void memory_fork(Memory* dst, const Memory* src) {
+    assert(dst && src);
+    for (size_t i = 0; i < MEM_PAGE_COUNT; ++i) {
+        MemPage* p = src->pages[i];
+        if (!page_is_static(p)) REF_INC(&p->refs);
+        page_set(dst, i, p);
+    }
+    dst->on_write     = NULL;
+    dst->on_write_ctx = NULL;
+}
+
+void memory_set_write_hook(Memory* m, MemoryWriteHook hook, void* ctx) {
+    assert(m);
+    m->on_write     = hook;
+    m->on_write_ctx = ctx;
 }
 
+/* ---------- access ---------- */
+
+/* Single-byte access cannot go out of bounds: RAM spans all 16-bit addresses. */
 Chip8Status memory_read(const Memory* m, uint16_t addr, uint8_t* out_value) {
     CHIP8_CHECK_ARG(m);
     CHIP8_CHECK_ARG(out_value);
-    if (!memory_addr_in_bounds(addr)) {
-        CHIP8_LOG_ERROR("Read RAM address OOB: addr=%u, memory=%p",
-                        (unsigned)addr, m->memory);
-        return CHIP8_ERR_MEM_OOB;
-    }
-    *out_value = m->memory[addr];
+    *out_value = memory_peek(m, addr);
     return CHIP8_OK;
 }
 
 Chip8Status memory_write(Memory* m, uint16_t addr, uint8_t value) {
     CHIP8_CHECK_ARG(m);
-    if (!memory_addr_in_bounds(addr)) {
-        CHIP8_LOG_ERROR("Write RAM address OOB: addr=%u, memory=%p",
-                        (unsigned)addr, m->memory);
-        return CHIP8_ERR_MEM_OOB;
+    const size_t page = addr >> MEM_PAGE_SHIFT;
+    Chip8Status st = page_own(m, page);
+    if (st != CHIP8_OK) return st;
+
+    m->pages[page]->bytes[addr & MEM_PAGE_MASK] = value;
+    memory_notify(m, addr, 1);
+    return CHIP8_OK;
+}
+
+Chip8Status memory_read_block(const Memory* m, uint16_t addr, uint8_t* dst, size_t len) {
+    CHIP8_CHECK_ARG(m);
+    CHIP8_CHECK_ARG(dst);
+    if (!memory_range_in_bounds(addr, len)) return CHIP8_ERR_MEM_OOB;
+
+    size_t a = addr;
+    while (len > 0) {
+        const size_t off = a & MEM_PAGE_MASK;
+        size_t n = MEM_PAGE_SIZE - off;
+        if (n > len) n = len;
+        memcpy(dst, m->bytes[a >> MEM_PAGE_SHIFT] + off, n);
+        dst += n; a += n; len -= n;
     }
-    m->memory[addr] = value;
+    return CHIP8_OK;
+}
+
+Chip8Status memory_write_block(Memory* m, uint16_t addr, const uint8_t* src, size_t len) {
+    CHIP8_CHECK_ARG(m);
+    CHIP8_CHECK_ARG(src);
+    if (!memory_range_in_bounds(addr, len)) return CHIP8_ERR_MEM_OOB;
+
+    size_t a = addr, left = len;
+    bool changed = false;
+    while (left > 0) {
+        const size_t page = a >> MEM_PAGE_SHIFT;
+        const size_t off  = a & MEM_PAGE_MASK;
+        size_t n = MEM_PAGE_SIZE - off;
+        if (n > left) n = left;
+
+        if (memcmp(m->bytes[page] + off, src, n) != 0) {
+            Chip8Status st = page_own(m, page);
+            if (st != CHIP8_OK) {
+                if (changed) memory_notify(m, addr, len);
+                return st;
+            }
+            memcpy(m->pages[page]->bytes + off, src, n);
+            changed = true;
+        }
+        src += n; a += n; left -= n;
+    }
+    if (changed) memory_notify(m, addr, len);
     return CHIP8_OK;
 }
 
@@ -75,6 +224,5 @@ Chip8Status memory_load_rom(Memory* m, const uint8_t* data, size_t size) {
     if (size > capacity) {
         return CHIP8_ERR_ROM_TOO_LARGE;
     }
-    memcpy(&m->memory[PROGRAM_START_ADDRESS], data, size);
-    return CHIP8_OK;
+    return memory_write_block(m, PROGRAM_START_ADDRESS, data, size);
 }
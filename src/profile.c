@@ -0,0 +1,72 @@
+#include <stdlib.h>   // malloc, free, qsort
+#include <string.h>   // memset
+
+#include "profile.h"
+
+void prof_init(Profile* p) {
+    if (!p) return;
+    memset(p, 0, sizeof(*p));
+    p->dt_poll_pc = 0xFFFF;
+}
+
+typedef struct {
+    uint32_t id;      /* address or InstrKind */
+    uint64_t count;
+} ProfRow;
+
+/* Descending by count, then ascending by id so reports are stable. */
+static int row_cmp(const void* a, const void* b) {
+    const ProfRow* ra = (const ProfRow*)a;
+    const ProfRow* rb = (const ProfRow*)b;
+    if (ra->count != rb->count) return ra->count < rb->count ? 1 : -1;
+    return (ra->id > rb->id) - (ra->id < rb->id);
+}
+
+static double pct(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+void prof_report(const Profile* p, const Memory* m, FILE* out, size_t top_n) {
+    if (!p || !out) return;
+
+    fprintf(out, "== profile: %llu cycles ==\n", (unsigned long long)p->cycles);
+    fprintf(out, "waiting: Fx0A key %llu (%.1f%%), DT polling %llu (%.1f%%)\n",
+            (unsigned long long)p->key_wait_cycles, pct(p->key_wait_cycles, p->cycles),
+            (unsigned long long)p->dt_wait_cycles,  pct(p->dt_wait_cycles,  p->cycles));
+
+    ProfRow kinds[INSTR_KIND_COUNT];
+    size_t nk = 0;
+    for (uint32_t k = 0; k < INSTR_KIND_COUNT; ++k) {
+        if (p->kind_count[k]) kinds[nk++] = (ProfRow){ k, p->kind_count[k] };
+    }
+    qsort(kinds, nk, sizeof(ProfRow), row_cmp);
+
+    fprintf(out, "-- instruction kinds --\n");
+    for (size_t i = 0; i < nk; ++i) {
+        fprintf(out, "%12llu %6.2f%%  %s\n", (unsigned long long)kinds[i].count,
+                pct(kinds[i].count, p->cycles), instr_kind_name((InstrKind)kinds[i].id));
+    }
+
+    ProfRow* pcs = (ProfRow*)malloc(sizeof(ProfRow) * MEMORY_SIZE);
+    if (!pcs) return;
+    size_t np = 0;
+    for (uint32_t a = 0; a < MEMORY_SIZE; ++a) {
+        if (p->pc_count[a]) pcs[np++] = (ProfRow){ a, p->pc_count[a] };
+    }
+    qsort(pcs, np, sizeof(ProfRow), row_cmp);
+    if (top_n > np) top_n = np;
+
+    fprintf(out, "-- hot spots (top %zu of %zu addresses) --\n", top_n, np);
+    for (size_t i = 0; i < top_n; ++i) {
+        const uint16_t a = (uint16_t)pcs[i].id;
+        uint16_t op = 0;
+        if (m && (size_t)a + 1u < MEMORY_SIZE) {
+            op = (uint16_t)((memory_peek(m, a) << 8) | memory_peek(m, (uint16_t)(a + 1)));
+        }
+        char text[INSTR_DISASM_MAX];
+        instr_disasm(op, text, sizeof(text));
+        fprintf(out, "0x%03X %12llu %6.2f%%  %04X  %s\n", a, (unsigned long long)pcs[i].count,
+                pct(pcs[i].count, p->cycles), op, text);
+    }
+    free(pcs);
+}
@@ -0,0 +1,56 @@
+#include "quirks.h"
+#include <stddef.h>   // NULL, size_t
+#include <string.h>   // strcmp
+
+static const QuirksProfile profiles[CHIP8_QUIRKS_COUNT] = {
+    /*                          name       vf_reset shift_vy index              jump_vx display_wait */
+    [CHIP8_QUIRKS_DEFAULT] = { "default", true,    false,   QUIRK_INDEX_INC,   false,  false },
+    [CHIP8_QUIRKS_VIP]     = { "vip",     true,    true,    QUIRK_INDEX_INC,   false,  true  },
+    [CHIP8_QUIRKS_CHIP48]  = { "chip48",  false,   false,   QUIRK_INDEX_INC_X, true,   false },
+    [CHIP8_QUIRKS_SCHIP]   = { "schip",   false,   false,   QUIRK_INDEX_KEEP,  true,   false },
+    [CHIP8_QUIRKS_XOCHIP]  = { "xochip",  false,   true,    QUIRK_INDEX_INC,   false,  false },
+};
+
+const QuirksProfile* quirks_profile(Chip8Quirks q) {
+    return &profiles[((unsigned)q < CHIP8_QUIRKS_COUNT) ? q : CHIP8_QUIRKS_DEFAULT];
+}
+
+bool quirks_from_name(const char* name, Chip8Quirks* out) {
+    if (!name || !out) return false;
+    for (size_t i = 0; i < CHIP8_QUIRKS_COUNT; ++i) {
+        if (strcmp(name, profiles[i].name) == 0) {
+            *out = (Chip8Quirks)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ROM database, keyed by input_log_rom_hash() (FNV-1a of RAM 0x200..end right
+ * after loading). Only ROMs whose target is documented are listed: their
+ * sources in ROM/SOURCES were written for the HP-48 (CHIP-48), and IBM is
+ * the COSMAC VIP logo test. */
+static const struct {
+    uint64_t    hash;
+    Chip8Quirks quirks;
+    const char* title;
+} rom_db[] = {
+    { 0xb95f69f3e8c4a652ull, CHIP8_QUIRKS_CHIP48, "Blinky" },
+    { 0x59f2b1f2f4c71a0cull, CHIP8_QUIRKS_CHIP48, "Brix" },
+    { 0x39d17a609d7840bcull, CHIP8_QUIRKS_CHIP48, "Breakout" },
+    { 0xc233f016752df5d2ull, CHIP8_QUIRKS_CHIP48, "Pong" },
+    { 0x2a8ec622284f3718ull, CHIP8_QUIRKS_CHIP48, "Pong 2" },
+    { 0x62f1a1f8b0ff908full, CHIP8_QUIRKS_CHIP48, "Syzygy" },
+    { 0xf6a51128371fd911ull, CHIP8_QUIRKS_VIP,    "IBM logo" },
+};
+
+bool quirks_lookup_rom(uint64_t rom_hash, Chip8Quirks* out) {
+    if (!out) return false;
+    for (size_t i = 0; i < sizeof(rom_db) / sizeof(rom_db[0]); ++i) {
+        if (rom_db[i].hash == rom_hash) {
+            *out = rom_db[i].quirks;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,239 @@
+#include <stdio.h>    // FILE, fopen, fread, fwrite
+#include <stdlib.h>   // malloc, realloc, free
+#include <string.h>   // memcmp, memset
+
+#include "replay.h"
+#include "timer.h"
+
+static const uint8_t LOG_MAGIC[4] = { 'C', '8', 'I', 'R' };
+
+#define LOG_HEADER_SIZE  (4u + 2u + 1u + 1u + 8u + 8u + 4u + 8u + 4u)
+#define EVENT_MAX_SIZE   (10u + 1u)   /* LEB128 u64 + key byte */
+#define EVENT_DOWN_FLAG  0x10u
+
+/* ---------- log ---------- */
+
+void input_log_init(InputLog* log, uint64_t seed, uint64_t rom_hash, Chip8Quirks quirks,
+                    uint32_t cycles_per_frame) {
+    if (!log) return;
+    memset(log, 0, sizeof(*log));
+    log->seed             = seed;
+    log->rom_hash         = rom_hash;
+    log->quirks           = quirks;
+    log->cycles_per_frame = cycles_per_frame;
+}
+
+void input_log_free(InputLog* log) {
+    if (!log) return;
+    free(log->events);
+    log->events = NULL;
+    log->count = log->cap = 0;
+}
+
+Chip8Status input_log_append(InputLog* log, uint64_t cycle, uint8_t key, bool down) {
+    CHIP8_CHECK_ARG(log);
+    if (key >= NUM_KEYS) return CHIP8_ERR_UNKNOWN_KEY_PRESSED;
+    if (log->count && cycle < log->events[log->count - 1].cycle) return CHIP8_ERR_REPLAY_INVALID;
+
+    if (log->count == log->cap) {
+        size_t cap = log->cap ? log->cap * 2 : 64;
+        InputEvent* ev = (InputEvent*)realloc(log->events, cap * sizeof(InputEvent));
+        if (!ev) return CHIP8_ERR_OUT_OF_MEMORY;
+        log->events = ev;
+        log->cap    = cap;
+    }
+    log->events[log->count++] = (InputEvent){ cycle, key, down };
+    if (cycle > log->end_cycle) log->end_cycle = cycle;
+    return CHIP8_OK;
+}
+
+uint64_t input_log_rom_hash(const Memory* m) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    if (!m) return h;
+    for (size_t a = PROGRAM_START_ADDRESS; a < MEMORY_SIZE; ++a) {
+        h ^= memory_peek(m, (uint16_t)a);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/* ---------- file I/O ---------- */
+
+static size_t put_le(uint8_t* p, uint64_t v, size_t n) {
+    for (size_t i = 0; i < n; ++i) p[i] = (uint8_t)(v >> (8 * i));
+    return n;
+}
+
+static uint64_t get_le(const uint8_t* p, size_t n) {
+    uint64_t v = 0;
+    for (size_t i = n; i-- > 0;) v = (v << 8) | p[i];
+    return v;
+}
+
+static FILE* open_file(const char* path, const char* mode) {
+    FILE* fp = NULL;
+#ifdef _MSC_VER
+    if (fopen_s(&fp, path, mode) != 0) fp = NULL;
+#else
+    fp = fopen(path, mode);
+#endif
+    if (!fp) CHIP8_LOG_ERROR("Failed to open: %s", path);
+    return fp;
+}
+
+Chip8Status input_log_save(const InputLog* log, const char* path) {
+    CHIP8_CHECK_ARG(log);
+    CHIP8_CHECK_ARG(path);
+    if (log->count > UINT32_MAX) return CHIP8_ERR_REPLAY_INVALID;
+
+    uint8_t* buf = (uint8_t*)malloc(LOG_HEADER_SIZE + log->count * EVENT_MAX_SIZE);
+    if (!buf) return CHIP8_ERR_OUT_OF_MEMORY;
+
+    size_t o = 0;
+    memcpy(buf, LOG_MAGIC, sizeof(LOG_MAGIC)); o += sizeof(LOG_MAGIC);
+    o += put_le(buf + o, INPUT_LOG_VERSION, 2);
+    o += put_le(buf + o, (uint64_t)log->quirks, 1);
+    o += put_le(buf + o, 0, 1);
+    o += put_le(buf + o, log->seed, 8);
+    o += put_le(buf + o, log->rom_hash, 8);
+    o += put_le(buf + o, log->cycles_per_frame, 4);
+    o += put_le(buf + o, log->end_cycle, 8);
+    o += put_le(buf + o, log->count, 4);
+
+    uint64_t prev = 0;
+    for (size_t i = 0; i < log->count; ++i) {
+        const InputEvent* e = &log->events[i];
+        uint64_t d = e->cycle - prev;
+        prev = e->cycle;
+        while (d >= 0x80) { buf[o++] = (uint8_t)(d | 0x80); d >>= 7; }
+        buf[o++] = (uint8_t)d;
+        buf[o++] = (uint8_t)(e->key | (e->down ? EVENT_DOWN_FLAG : 0u));
+    }
+
+    Chip8Status st = CHIP8_OK;
+    FILE* fp = open_file(path, "wb");
+    if (!fp) {
+        st = CHIP8_ERR_FILE_OPEN;
+    } else {
+        if (fwrite(buf, 1, o, fp) != o) st = CHIP8_ERR_FILE_IO;
+        if (fclose(fp) != 0) st = CHIP8_ERR_FILE_IO;
+    }
+    free(buf);
+    return st;
+}
+
+static Chip8Status parse_log(InputLog* log, const uint8_t* buf, size_t len) {
+    if (len < LOG_HEADER_SIZE || memcmp(buf, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) return CHIP8_ERR_REPLAY_INVALID;
+    if (get_le(buf + 4, 2) != INPUT_LOG_VERSION) return CHIP8_ERR_REPLAY_INVALID;
+
+    const uint8_t quirks = buf[6];
+    if (quirks >= CHIP8_QUIRKS_COUNT) return CHIP8_ERR_REPLAY_INVALID;
+
+    input_log_init(log, get_le(buf + 8, 8), get_le(buf + 16, 8), (Chip8Quirks)quirks, (uint32_t)get_le(buf + 24, 4));
+    const uint64_t end_cycle = get_le(buf + 28, 8);
+    const uint32_t count     = (uint32_t)get_le(buf + 36, 4);
+    if (log->cycles_per_frame == 0) return CHIP8_ERR_REPLAY_INVALID;
+
+    size_t r = LOG_HEADER_SIZE;
+    uint64_t cycle = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t d = 0;
+        unsigned shift = 0;
+        uint8_t b;
+        do {
+            if (r >= len || shift > 63) return CHIP8_ERR_REPLAY_INVALID;
+            b = buf[r++];
+            d |= (uint64_t)(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        if (r >= len) return CHIP8_ERR_REPLAY_INVALID;
+        const uint8_t kv = buf[r++];
+        if ((kv & ~(EVENT_DOWN_FLAG | 0x0Fu)) != 0) return CHIP8_ERR_REPLAY_INVALID;
+
+        cycle += d;
+        Chip8Status st = input_log_append(log, cycle, (uint8_t)(kv & 0x0F), (kv & EVENT_DOWN_FLAG) != 0);
+        if (st != CHIP8_OK) return st;
+    }
+    if (r != len || end_cycle < cycle) return CHIP8_ERR_REPLAY_INVALID;
+    log->end_cycle = end_cycle;
+    return CHIP8_OK;
+}
+
+Chip8Status input_log_load(InputLog* log, const char* path) {
+    CHIP8_CHECK_ARG(log);
+    CHIP8_CHECK_ARG(path);
+    memset(log, 0, sizeof(*log));
+
+    FILE* fp = open_file(path, "rb");
+    if (!fp) return CHIP8_ERR_FILE_OPEN;
+
+    size_t cap = 4096, len = 0;
+    uint8_t* buf = (uint8_t*)malloc(cap);
+    Chip8Status st = buf ? CHIP8_OK : CHIP8_ERR_OUT_OF_MEMORY;
+    while (st == CHIP8_OK) {
+        if (len == cap) {
+            uint8_t* nb = (uint8_t*)realloc(buf, cap * 2);
+            if (!nb) { st = CHIP8_ERR_OUT_OF_MEMORY; break; }
+            buf = nb;
+            cap *= 2;
+        }
+        size_t n = fread(buf + len, 1, cap - len, fp);
+        len += n;
+        if (n == 0) {
+            if (ferror(fp)) st = CHIP8_ERR_FILE_IO;
+            break;
+        }
+    }
+    fclose(fp);
+
+    if (st == CHIP8_OK) st = parse_log(log, buf, len);
+    free(buf);
+    if (st != CHIP8_OK) input_log_free(log);
+    return st;
+}
+
+/* ---------- replay ---------- */
+
+void input_player_init(InputPlayer* p, const InputLog* log) {
+    if (!p) return;
+    p->log  = log;
+    p->next = 0;
+}
+
+void input_player_apply(InputPlayer* p, Keyboard* kbd, uint64_t cycle) {
+    if (!p || !p->log || !kbd) return;
+    while (p->next < p->log->count && p->log->events[p->next].cycle <= cycle) {
+        const InputEvent* e = &p->log->events[p->next++];
+        if (e->down) keyboard_press(kbd, e->key);
+        else         keyboard_release(kbd, e->key);
+    }
+}
+
+uint64_t input_player_until_next(const InputPlayer* p, uint64_t cycle) {
+    if (!p || !p->log || p->next >= p->log->count) return UINT64_MAX;
+    const uint64_t at = p->log->events[p->next].cycle;
+    return at > cycle ? at - cycle : 0;
+}
+
+Chip8Status input_player_run_frame(InputPlayer* p, struct Chip8* c8, uint64_t* cycle) {
+    CHIP8_CHECK_ARG(p);
+    CHIP8_CHECK_ARG(p->log);
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(cycle);
+
+    uint32_t left = p->log->cycles_per_frame;
+    while (left > 0) {
+        input_player_apply(p, &c8->chip8_kbd, *cycle);
+
+        uint64_t budget = input_player_until_next(p, *cycle);
+        if (budget > left) budget = left;
+
+        uint32_t ran = 0;
+        Chip8Status st = chip8_run_blocks(c8, (uint32_t)budget, &ran);
+        *cycle += ran;
+        left   -= ran;
+        if (st != CHIP8_OK) return st;
+    }
+    regs_tick_frame(&c8->chip8_regs);
+    return CHIP8_OK;
+}
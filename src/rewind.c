@@ -0,0 +1,312 @@
+#include <stdlib.h>   // malloc, calloc, free
+#include <string.h>   // memcpy, memcmp
+
+#include "rewind.h"
+
+/* Flat per-frame image, host byte order (never leaves the process). */
+enum {
+    IMG_RAM       = 0,
+    IMG_V         = IMG_RAM + MEMORY_SIZE,
+    IMG_I         = IMG_V + NUM_REGS,
+    IMG_PC        = IMG_I + 2,
+    IMG_SP        = IMG_PC + 2,
+    IMG_DT        = IMG_SP + 1,
+    IMG_ST        = IMG_DT + 1,
+    IMG_RPL       = IMG_ST + 1,
+    IMG_RNG       = IMG_RPL + NUM_REGS,
+    IMG_STACK     = IMG_RNG + 8,
+    IMG_ROWS      = IMG_STACK + STACK_DEPTH * 2,
+    IMG_ROWS_R    = IMG_ROWS + HIRES_HEIGHT * 8,
+    IMG_ROWS2     = IMG_ROWS_R + HIRES_HEIGHT * 8,
+    IMG_ROWS2_R   = IMG_ROWS2 + HIRES_HEIGHT * 8,
+    IMG_HIRES     = IMG_ROWS2_R + HIRES_HEIGHT * 8,
+    IMG_PLANES    = IMG_HIRES + 1,
+    IMG_AUDIO     = IMG_PLANES + 1,
+    IMG_PITCH     = IMG_AUDIO + AUDIO_PATTERN_BYTES,
+    IMG_HAS_AUDIO = IMG_PITCH + 1,
+    IMG_VBLANK    = IMG_HAS_AUDIO + 1,
+    IMG_TIMER     = IMG_VBLANK + 1,
+    IMG_BEEP      = IMG_TIMER + 8,
+    IMG_SIZE      = IMG_BEEP + 1
+};
+
+/* Worst case for one encoded record: a (skip, len) varint pair per 4 bytes. */
+#define REC_MAX_SIZE ((size_t)IMG_SIZE + ((size_t)IMG_SIZE / 4u + 1u) * 6u)
+
+/* A literal run ends once this many unchanged bytes follow it. */
+#define ZERO_RUN_BREAK 3u
+
+/* Smallest ring accepted; typical records are tens of bytes. */
+#define RING_MIN_SIZE 4096u
+
+/* Every frame is charged at least this much of the budget (for its index entry). */
+#define BYTES_PER_ENTRY_BUDGET 32u
+
+typedef struct {
+    size_t off;
+    size_t len;
+} RewindEntry;
+
+struct RewindBuffer {
+    uint8_t*     ring;
+    size_t       ring_cap;
+    size_t       head;          /* next write offset in ring */
+    size_t       used;          /* bytes held by live records */
+
+    RewindEntry* entries;       /* FIFO of records, oldest at entries[first] */
+    size_t       entry_cap;
+    size_t       first;
+    size_t       count;
+
+    bool         have_base;     /* cur holds the newest recorded frame */
+    uint8_t      cur[IMG_SIZE];
+    uint8_t      next[IMG_SIZE];
+    uint8_t      enc[REC_MAX_SIZE];
+};
+
+/* ---------- image capture / restore ---------- */
+
+static void image_capture(const struct Chip8* c8, uint8_t* img) {
+    const Registers* r = &c8->chip8_regs;
+    memory_read_block(&c8->chip8_mem, 0, img + IMG_RAM, MEMORY_SIZE);
+    memcpy(img + IMG_V,   r->V, NUM_REGS);
+    memcpy(img + IMG_I,   &r->I, 2);
+    memcpy(img + IMG_PC,  &r->PC, 2);
+    img[IMG_SP] = r->SP;
+    img[IMG_DT] = r->DT;
+    img[IMG_ST] = r->ST;
+    memcpy(img + IMG_RPL,   r->RPL, NUM_REGS);
+    memcpy(img + IMG_RNG,   &r->rng.state, 8);
+    memcpy(img + IMG_STACK, c8->chip8_stack.stack, STACK_DEPTH * 2);
+    memcpy(img + IMG_ROWS,   c8->chip8_disp.rows, HIRES_HEIGHT * 8);
+    memcpy(img + IMG_ROWS_R, c8->chip8_disp.rows_right, HIRES_HEIGHT * 8);
+    memcpy(img + IMG_ROWS2,   c8->chip8_disp.rows2, HIRES_HEIGHT * 8);
+    memcpy(img + IMG_ROWS2_R, c8->chip8_disp.rows2_right, HIRES_HEIGHT * 8);
+    img[IMG_HIRES]  = c8->chip8_disp.hires ? 1u : 0u;
+    img[IMG_PLANES] = c8->chip8_disp.planes;
+    memcpy(img + IMG_AUDIO, r->pattern, AUDIO_PATTERN_BYTES);
+    img[IMG_PITCH]     = r->pitch;
+    img[IMG_HAS_AUDIO] = r->has_pattern ? 1u : 0u;
+    img[IMG_VBLANK]    = r->vblank_wait ? 1u : 0u;
+    memcpy(img + IMG_TIMER, &c8->chip8_timer.acc_ns, 8);
+    img[IMG_BEEP] = c8->chip8_timer.prev_st_nonzero ? 1u : 0u;
+}
+
+static Chip8Status image_restore(struct Chip8* c8, const uint8_t* img) {
+    /* Unchanged RAM pages are skipped (and stay shared with forks). */
+    Chip8Status st = memory_write_block(&c8->chip8_mem, 0, img + IMG_RAM, MEMORY_SIZE);
+    if (st != CHIP8_OK) return st;
+
+    Registers* r = &c8->chip8_regs;
+    memcpy(r->V,  img + IMG_V, NUM_REGS);
+    memcpy(&r->I,  img + IMG_I, 2);
+    memcpy(&r->PC, img + IMG_PC, 2);
+    r->SP = img[IMG_SP];
+    r->DT = img[IMG_DT];
+    r->ST = img[IMG_ST];
+    memcpy(r->RPL, img + IMG_RPL, NUM_REGS);
+    memcpy(&r->rng.state, img + IMG_RNG, 8);
+    memcpy(c8->chip8_stack.stack, img + IMG_STACK, STACK_DEPTH * 2);
+    memcpy(c8->chip8_disp.rows, img + IMG_ROWS, HIRES_HEIGHT * 8);
+    memcpy(c8->chip8_disp.rows_right, img + IMG_ROWS_R, HIRES_HEIGHT * 8);
+    memcpy(c8->chip8_disp.rows2, img + IMG_ROWS2, HIRES_HEIGHT * 8);
+    memcpy(c8->chip8_disp.rows2_right, img + IMG_ROWS2_R, HIRES_HEIGHT * 8);
+    c8->chip8_disp.hires  = img[IMG_HIRES] != 0;
+    c8->chip8_disp.planes = img[IMG_PLANES];
+    memcpy(r->pattern, img + IMG_AUDIO, AUDIO_PATTERN_BYTES);
+    r->pitch       = img[IMG_PITCH];
+    r->has_pattern = img[IMG_HAS_AUDIO] != 0;
+    r->vblank_wait = img[IMG_VBLANK] != 0;
+    c8->chip8_disp.dirty_rows = ~0ull;   /* frontends repaint everything */
+    memcpy(&c8->chip8_timer.acc_ns, img + IMG_TIMER, 8);
+    c8->chip8_timer.prev_st_nonzero = img[IMG_BEEP] != 0;
+    return CHIP8_OK;
+}
+
+/* ---------- XOR delta coding ---------- */
+
+static size_t put_varint(uint8_t* p, size_t v) {
+    size_t n = 0;
+    while (v >= 0x80) { p[n++] = (uint8_t)(v | 0x80); v >>= 7; }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t get_varint(const uint8_t* p, size_t* v) {
+    size_t n = 0, shift = 0, out = 0;
+    uint8_t b;
+    do {
+        b = p[n++];
+        out |= (size_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    *v = out;
+    return n;
+}
+
+/* Encode a ^ b as (skip, literal length, literal bytes) tokens; trailing
+ * unchanged bytes are implicit. Returns the encoded size. */
+static size_t delta_encode(const uint8_t* a, const uint8_t* b, uint8_t* out) {
+    size_t o = 0, i = 0, last = 0;
+    while (i < IMG_SIZE) {
+        /* unchanged bytes dominate: skip them a word at a time */
+        if (i + 8 <= IMG_SIZE && memcmp(a + i, b + i, 8) == 0) { i += 8; continue; }
+        if (a[i] == b[i]) { ++i; continue; }
+
+        size_t start = i, end = i + 1, same = 0;
+        for (size_t j = end; j < IMG_SIZE && same < ZERO_RUN_BREAK; ++j) {
+            if (a[j] != b[j]) { end = j + 1; same = 0; }
+            else ++same;
+        }
+
+        o += put_varint(out + o, start - last);
+        o += put_varint(out + o, end - start);
+        for (size_t k = start; k < end; ++k) out[o++] = (uint8_t)(a[k] ^ b[k]);
+        last = i = end;
+    }
+    return o;
+}
+
+static void delta_apply(uint8_t* img, const uint8_t* rec, size_t len) {
+    size_t r = 0, pos = 0;
+    while (r < len) {
+        size_t skip, n;
+        r += get_varint(rec + r, &skip);
+        r += get_varint(rec + r, &n);
+        pos += skip;
+        for (size_t k = 0; k < n; ++k) img[pos + k] ^= rec[r + k];
+        pos += n;
+        r   += n;
+    }
+}
+
+/* ---------- ring ---------- */
+
+static inline RewindEntry* entry_at(RewindBuffer* rw, size_t i) {
+    return &rw->entries[(rw->first + i) % rw->entry_cap];
+}
+
+static void drop_oldest(RewindBuffer* rw) {
+    rw->used -= rw->entries[rw->first].len;
+    rw->first = (rw->first + 1) % rw->entry_cap;
+    rw->count--;
+}
+
+/* Reserve `len` contiguous ring bytes, evicting the oldest records in the way. */
+static size_t ring_reserve(RewindBuffer* rw, size_t len) {
+    if (rw->count == rw->entry_cap) drop_oldest(rw);
+
+    if (rw->head + len > rw->ring_cap) {
+        /* Wrap: everything stored past the old head predates the records at 0. */
+        while (rw->count && rw->entries[rw->first].off >= rw->head) drop_oldest(rw);
+        rw->head = 0;
+    }
+    while (rw->count) {
+        const RewindEntry* e = &rw->entries[rw->first];
+        if (e->off < rw->head || e->off >= rw->head + len) break;
+        drop_oldest(rw);
+    }
+
+    const size_t off = rw->head;
+    rw->head += len;
+    return off;
+}
+
+/* ---------- public API ---------- */
+
+Chip8Status rewind_init(RewindBuffer** out_rw, size_t capacity_bytes) {
+    CHIP8_CHECK_ARG(out_rw);
+    *out_rw = NULL;
+
+    const size_t entry_cap = capacity_bytes / BYTES_PER_ENTRY_BUDGET;
+    const size_t ring_cap  = capacity_bytes - entry_cap * sizeof(RewindEntry);
+    if (entry_cap < 2 || capacity_bytes < RING_MIN_SIZE + entry_cap * sizeof(RewindEntry)) {
+        return CHIP8_ERR_BUFFER_TOO_SMALL;
+    }
+
+    RewindBuffer* rw = (RewindBuffer*)calloc(1, sizeof(RewindBuffer));
+    if (!rw) return CHIP8_ERR_OUT_OF_MEMORY;
+    rw->ring    = (uint8_t*)malloc(ring_cap);
+    rw->entries = (RewindEntry*)malloc(entry_cap * sizeof(RewindEntry));
+    if (!rw->ring || !rw->entries) {
+        rewind_destroy(rw);
+        return CHIP8_ERR_OUT_OF_MEMORY;
+    }
+    rw->ring_cap  = ring_cap;
+    rw->entry_cap = entry_cap;
+    *out_rw = rw;
+    return CHIP8_OK;
+}
+
+void rewind_destroy(RewindBuffer* rw) {
+    if (!rw) return;
+    free(rw->ring);
+    free(rw->entries);
+    free(rw);
+}
+
+void rewind_clear(RewindBuffer* rw) {
+    if (!rw) return;
+    rw->head = rw->used = rw->first = rw->count = 0;
+    rw->have_base = false;
+}
+
+Chip8Status rewind_record(RewindBuffer* rw, const struct Chip8* c8) {
+    CHIP8_CHECK_ARG(rw);
+    CHIP8_CHECK_ARG(c8);
+
+    if (!rw->have_base) {
+        image_capture(c8, rw->cur);
+        rw->have_base = true;
+        return CHIP8_OK;
+    }
+
+    image_capture(c8, rw->next);
+    const size_t len = delta_encode(rw->cur, rw->next, rw->enc);
+    if (len > rw->ring_cap) {
+        /* Too different from the last frame to store (e.g. most of 64 KB of
+         * RAM rewritten): start a new history from this frame. */
+        rw->head = rw->used = rw->first = rw->count = 0;
+        memcpy(rw->cur, rw->next, IMG_SIZE);
+        return CHIP8_OK;
+    }
+    const size_t off = ring_reserve(rw, len);
+    memcpy(rw->ring + off, rw->enc, len);
+
+    RewindEntry* e = entry_at(rw, rw->count);
+    e->off = off;
+    e->len = len;
+    rw->count++;
+    rw->used += len;
+
+    memcpy(rw->cur, rw->next, IMG_SIZE);
+    return CHIP8_OK;
+}
+
+Chip8Status rewind_step_back(RewindBuffer* rw, struct Chip8* c8) {
+    CHIP8_CHECK_ARG(rw);
+    CHIP8_CHECK_ARG(c8);
+    if (rw->count == 0) return CHIP8_ERR_REWIND_EMPTY;
+
+    /* cur ^ delta(newest) = the frame before it. */
+    const RewindEntry* e = entry_at(rw, rw->count - 1);
+    memcpy(rw->next, rw->cur, IMG_SIZE);
+    delta_apply(rw->next, rw->ring + e->off, e->len);
+
+    Chip8Status st = image_restore(c8, rw->next);
+    if (st != CHIP8_OK) return st;
+
+    rw->head = e->off;   /* the newest record is always the last one written */
+    rw->used -= e->len;
+    rw->count--;
+    memcpy(rw->cur, rw->next, IMG_SIZE);
+    return CHIP8_OK;
+}
+
+size_t rewind_frames(const RewindBuffer* rw) {
+    return rw ? rw->count : 0;
+}
+
+size_t rewind_bytes_used(const RewindBuffer* rw) {
+    return rw ? rw->used : 0;
+}
@@ -0,0 +1,10 @@
+#include "rng.h"
+
+void rng_seed(Rng* r, uint64_t seed) {
+    if (!r) return;
+    /* PCG reference seeding: step, mix in the seed, step again. */
+    r->state = 0u;
+    (void)rng_next(r);
+    r->state += seed;
+    (void)rng_next(r);
+}
@@ -0,0 +1,322 @@
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcpy, memset
+
+#include "chip8.h"
+
+/*
+ * Save-state blob, all integers little-endian:
+ *
+ *   "C8ST" u16 version u16 reserved u64 base_hash
+ *   V[16] u16 I u16 PC u8 SP u8 DT u8 ST u64 rng
+ *   u16 stack[SP]
+ *   u16 key bitmask
+ *   u64 timer acc_ns u8 timer prev_st_nonzero
+ *   u8 flags (bit 0: SCHIP hi-res, bit 1: XO-CHIP pattern loaded,
+ *   bit 2: display-wait idle until the next tick) u8 RPL[16]
+ *   u8 plane mask u8 pitch u8 pattern[16]
+ *   per plane (1, then 2): u64 non-blank row mask over the current
+ *   resolution's rows, then per non-blank row one u64 (lo-res) or two,
+ *   left half first (hi-res)
+ *   u16 run_count, then run_count x { u16 addr, u16 len, u8 bytes[len] }
+ */
+
+static const uint8_t STATE_MAGIC[4] = { 'C', '8', 'S', 'T' };
+
+/* Runs closer than this are merged: a new run header costs 4 bytes. */
+#define RUN_MERGE_GAP 4u
+/* Longest run a u16 length can describe. */
+#define RUN_MAX_LEN   0xFFFFu
+
+#define FLAG_HIRES    0x01u
+#define FLAG_PATTERN  0x02u
+#define FLAG_VBLANK   0x04u
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+_Static_assert(HIRES_HEIGHT <= 64, "row mask holds one bit per row");
+_Static_assert(NUM_KEYS <= 16, "key mask holds one bit per key");
+#endif
+
+/* ---------- byte writer / reader ---------- */
+
+typedef struct {
+    uint8_t* p;
+    size_t   cap;
+    size_t   len;
+    bool     ok;
+} Writer;
+
+static void put_bytes(Writer* w, const void* src, size_t n) {
+    if (!w->ok || w->cap - w->len < n) { w->ok = false; return; }
+    memcpy(w->p + w->len, src, n);
+    w->len += n;
+}
+
+static void put_u8(Writer* w, uint8_t v) { put_bytes(w, &v, 1); }
+
+static void put_u16(Writer* w, uint16_t v) {
+    const uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+    put_bytes(w, b, 2);
+}
+
+static void put_u64(Writer* w, uint64_t v) {
+    uint8_t b[8];
+    for (int i = 0; i < 8; ++i) b[i] = (uint8_t)(v >> (8 * i));
+    put_bytes(w, b, 8);
+}
+
+typedef struct {
+    const uint8_t* p;
+    size_t         len;
+    size_t         pos;
+    bool           ok;
+} Reader;
+
+static const uint8_t* get_bytes(Reader* r, size_t n) {
+    if (!r->ok || r->len - r->pos < n) { r->ok = false; return NULL; }
+    const uint8_t* src = r->p + r->pos;
+    r->pos += n;
+    return src;
+}
+
+static uint8_t get_u8(Reader* r) {
+    const uint8_t* b = get_bytes(r, 1);
+    return b ? b[0] : 0;
+}
+
+static uint16_t get_u16(Reader* r) {
+    const uint8_t* b = get_bytes(r, 2);
+    return b ? (uint16_t)(b[0] | (b[1] << 8)) : 0;
+}
+
+static uint64_t get_u64(Reader* r) {
+    const uint8_t* b = get_bytes(r, 8);
+    uint64_t v = 0;
+    if (b) for (int i = 7; i >= 0; --i) v = (v << 8) | b[i];
+    return v;
+}
+
+/* FNV-1a over the base image (all zeroes when base == NULL). */
+static uint64_t base_hash(const uint8_t* base) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < MEMORY_SIZE; ++i) {
+        h ^= base ? base[i] : 0u;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static inline uint8_t base_at(const uint8_t* base, size_t i) {
+    return base ? base[i] : 0u;
+}
+
+/* ---------- save ---------- */
+
+/* Encode RAM as runs of bytes that differ from the base image. */
+static void put_ram_delta(Writer* w, const Memory* ram, const uint8_t* base) {
+    const size_t count_at = w->len;
+    uint16_t runs = 0;
+    put_u16(w, 0);   /* patched below */
+
+    size_t i = 0;
+    while (i < MEMORY_SIZE) {
+        if (memory_peek(ram, (uint16_t)i) == base_at(base, i)) { ++i; continue; }
+
+        /* extend while differing bytes keep appearing within RUN_MERGE_GAP */
+        size_t start = i, end = i + 1, gap = 0;
+        for (size_t j = end; j < MEMORY_SIZE && gap <= RUN_MERGE_GAP && j - start < RUN_MAX_LEN; ++j) {
+            if (memory_peek(ram, (uint16_t)j) != base_at(base, j)) { end = j + 1; gap = 0; }
+            else ++gap;
+        }
+
+        put_u16(w, (uint16_t)start);
+        put_u16(w, (uint16_t)(end - start));
+        if (w->ok && w->cap - w->len >= end - start) {
+            memory_read_block(ram, (uint16_t)start, w->p + w->len, end - start);
+            w->len += end - start;
+        } else {
+            w->ok = false;
+        }
+        ++runs;
+        i = end;
+    }
+
+    if (w->ok) {
+        w->p[count_at]     = (uint8_t)runs;
+        w->p[count_at + 1] = (uint8_t)(runs >> 8);
+    }
+}
+
+/* One bitplane: non-blank row mask, then the non-blank rows. */
+static void put_plane(Writer* w, const uint64_t* left, const uint64_t* right, uint8_t height, bool hires) {
+    uint64_t lit = 0;
+    for (size_t y = 0; y < height; ++y) {
+        if (left[y] | (hires ? right[y] : 0u)) lit |= 1ull << y;
+    }
+    put_u64(w, lit);
+    for (size_t y = 0; y < height; ++y) {
+        if (!((lit >> y) & 1u)) continue;
+        put_u64(w, left[y]);
+        if (hires) put_u64(w, right[y]);
+    }
+}
+
+Chip8Status chip8_save_state(const struct Chip8* c8, const uint8_t* base,
+                             uint8_t* buf, size_t cap, size_t* out_len) {
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(buf);
+    CHIP8_CHECK_ARG(out_len);
+
+    const Registers* regs = &c8->chip8_regs;
+    if (regs->SP > STACK_DEPTH) return CHIP8_ERR_STACK_OVERFLOW;
+
+    Writer w = { buf, cap, 0, true };
+
+    put_bytes(&w, STATE_MAGIC, sizeof(STATE_MAGIC));
+    put_u16(&w, CHIP8_STATE_VERSION);
+    put_u16(&w, 0);
+    put_u64(&w, base_hash(base));
+
+    put_bytes(&w, regs->V, NUM_REGS);
+    put_u16(&w, regs->I);
+    put_u16(&w, regs->PC);
+    put_u8 (&w, regs->SP);
+    put_u8 (&w, regs->DT);
+    put_u8 (&w, regs->ST);
+    put_u64(&w, regs->rng.state);
+
+    for (uint8_t i = 0; i < regs->SP; ++i) put_u16(&w, c8->chip8_stack.stack[i]);
+
+    uint16_t keys = 0;
+    for (uint8_t k = 0; k < NUM_KEYS; ++k) {
+        if (c8->chip8_kbd.state[k]) keys |= (uint16_t)(1u << k);
+    }
+    put_u16(&w, keys);
+
+    put_u64(&w, c8->chip8_timer.acc_ns);
+    put_u8 (&w, c8->chip8_timer.prev_st_nonzero ? 1u : 0u);
+
+    const Screen* scr = &c8->chip8_disp;
+    put_u8   (&w, (uint8_t)((scr->hires ? FLAG_HIRES : 0u) | (regs->has_pattern ? FLAG_PATTERN : 0u) |
+                        (regs->vblank_wait ? FLAG_VBLANK : 0u)));
+    put_bytes(&w, regs->RPL, NUM_REGS);
+    put_u8   (&w, scr->planes);
+    put_u8   (&w, regs->pitch);
+    put_bytes(&w, regs->pattern, AUDIO_PATTERN_BYTES);
+
+    const uint8_t height = screen_height(scr);
+    put_plane(&w, scr->rows,  scr->rows_right,  height, scr->hires);
+    put_plane(&w, scr->rows2, scr->rows2_right, height, scr->hires);
+
+    put_ram_delta(&w, &c8->chip8_mem, base);
+
+    if (!w.ok) return CHIP8_ERR_BUFFER_TOO_SMALL;
+    *out_len = w.len;
+    return CHIP8_OK;
+}
+
+/* ---------- load ---------- */
+
+static bool get_plane(Reader* r, uint64_t* left, uint64_t* right, uint8_t height, bool hires) {
+    const uint64_t lit = get_u64(r);
+    if (height < 64 && (lit >> height) != 0) return false;
+    for (size_t y = 0; y < height; ++y) {
+        if (!((lit >> y) & 1u)) continue;
+        left[y] = get_u64(r);
+        if (hires) right[y] = get_u64(r);
+    }
+    return r->ok;
+}
+
+Chip8Status chip8_load_state(struct Chip8* c8, const uint8_t* base,
+                             const uint8_t* buf, size_t len) {
+    CHIP8_CHECK_ARG(c8);
+    CHIP8_CHECK_ARG(buf);
+
+    Reader r = { buf, len, 0, true };
+
+    const uint8_t* magic = get_bytes(&r, sizeof(STATE_MAGIC));
+    if (!magic || memcmp(magic, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0) return CHIP8_ERR_STATE_INVALID;
+    if (get_u16(&r) != CHIP8_STATE_VERSION) return CHIP8_ERR_STATE_INVALID;
+    (void)get_u16(&r);
+    const uint64_t hash = get_u64(&r);
+    if (!r.ok) return CHIP8_ERR_STATE_INVALID;
+    if (hash != base_hash(base)) return CHIP8_ERR_STATE_BASE_MISMATCH;
+
+    /* Decode everything into temporaries first so errors leave c8 untouched. */
+    Registers regs = c8->chip8_regs;
+    const uint8_t* v = get_bytes(&r, NUM_REGS);
+    if (v) memcpy(regs.V, v, NUM_REGS);
+    regs.I         = get_u16(&r);
+    regs.PC        = get_u16(&r);
+    regs.SP        = get_u8(&r);
+    regs.DT        = get_u8(&r);
+    regs.ST        = get_u8(&r);
+    regs.rng.state = get_u64(&r);
+    if (!r.ok || regs.SP > STACK_DEPTH) return CHIP8_ERR_STATE_INVALID;
+
+    Stack stack;
+    memset(&stack, 0, sizeof(stack));
+    for (uint8_t i = 0; i < regs.SP; ++i) stack.stack[i] = get_u16(&r);
+
+    Keyboard kbd;
+    const uint16_t keys = get_u16(&r);
+    for (uint8_t k = 0; k < NUM_KEYS; ++k) kbd.state[k] = (uint8_t)((keys >> k) & 1u);
+
+    TimerState timer;
+    timer.acc_ns          = get_u64(&r);
+    timer.prev_st_nonzero = get_u8(&r) != 0;
+
+    const uint8_t flags = get_u8(&r);
+    const uint8_t* rpl = get_bytes(&r, NUM_REGS);
+    if (rpl) memcpy(regs.RPL, rpl, NUM_REGS);
+    const uint8_t planes = get_u8(&r);
+    regs.pitch = get_u8(&r);
+    const uint8_t* pattern = get_bytes(&r, AUDIO_PATTERN_BYTES);
+    if (pattern) memcpy(regs.pattern, pattern, AUDIO_PATTERN_BYTES);
+    regs.has_pattern = (flags & FLAG_PATTERN) != 0;
+    regs.vblank_wait = (flags & FLAG_VBLANK) != 0;
+    if (!r.ok || (flags & ~(FLAG_HIRES | FLAG_PATTERN | FLAG_VBLANK)) != 0 || planes >= (1u << SCREEN_PLANES)) {
+        return CHIP8_ERR_STATE_INVALID;
+    }
+
+    Screen scr;
+    screen_init(&scr);
+    scr.hires  = (flags & FLAG_HIRES) != 0;
+    scr.planes = planes;
+    const uint8_t height = screen_height(&scr);
+    if (!get_plane(&r, scr.rows,  scr.rows_right,  height, scr.hires) ||
+        !get_plane(&r, scr.rows2, scr.rows2_right, height, scr.hires)) {
+        return CHIP8_ERR_STATE_INVALID;
+    }
+
+    /* 64 KB: too big for the stack on every platform we target. */
+    uint8_t* ram = (uint8_t*)malloc(MEMORY_SIZE);
+    if (!ram) return CHIP8_ERR_OUT_OF_MEMORY;
+    if (base) memcpy(ram, base, MEMORY_SIZE);
+    else      memset(ram, 0, MEMORY_SIZE);
+
+    const uint16_t runs = get_u16(&r);
+    for (uint16_t i = 0; i < runs && r.ok; ++i) {
+        const uint16_t addr = get_u16(&r);
+        const uint16_t n    = get_u16(&r);
+        if ((size_t)addr + n > MEMORY_SIZE) { r.ok = false; break; }
+        const uint8_t* bytes = get_bytes(&r, n);
+        if (bytes) memcpy(&ram[addr], bytes, n);
+    }
+    if (!r.ok || r.pos != len) {
+        free(ram);
+        return CHIP8_ERR_STATE_INVALID;
+    }
+
+    /* Commit. Unchanged RAM pages stay shared with any fork. */
+    Chip8Status st = memory_write_block(&c8->chip8_mem, 0, ram, MEMORY_SIZE);
+    free(ram);
+    if (st != CHIP8_OK) return st;
+    c8->chip8_regs  = regs;
+    c8->chip8_stack = stack;
+    c8->chip8_kbd   = kbd;
+    c8->chip8_timer = timer;
+    c8->chip8_disp  = scr;
+    c8->chip8_disp.dirty_rows = ~0ull;   /* frontends must repaint everything */
+    return CHIP8_OK;
+}
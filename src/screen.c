@@ -1,38 +1,145 @@
 #include "screen.h"
-#include <string.h> // memset
+#include <string.h> // memset, memmove
 
-// Map (x, y) to linear index in row-major order with wrapping.
-static inline size_t idx_wrap(uint8_t x, uint8_t y) {
-    uint8_t _x = (uint8_t)(x % DISPLAY_WIDTH);
-    uint8_t _y = (uint8_t)(y % DISPLAY_HEIGHT);
-    return (size_t)_y * DISPLAY_WIDTH + (size_t)_x;
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+_Static_assert(DISPLAY_WIDTH == 64, "packed rows assume a 64-pixel-wide display");
+_Static_assert(HIRES_WIDTH == 128, "hi-res rows are two 64-bit words");
+_Static_assert(DISPLAY_HEIGHT <= HIRES_HEIGHT, "lo-res rows are a prefix of the hi-res ones");
+_Static_assert(HIRES_HEIGHT <= 64, "dirty_rows holds one bit per row");
+_Static_assert(SCREEN_PLANES == 2, "planes are rows/rows_right and rows2/rows2_right");
+#endif
+
+// Dirty mask covering the first h rows.
+#define ROWS_MASK(h) ((h) >= 64 ? ~0ull : ((1ull << (h)) - 1u))
+
+// Bit mask for column x within a packed row word (x already wrapped to 0..63).
+static inline uint64_t col_mask(uint8_t x) {
+    return 0x8000000000000000ull >> x;
+}
+
+// Rotate right; x-wrap of a sprite row is a rotation of the 64-bit row word.
+static inline uint64_t rotr64(uint64_t v, unsigned r) {
+    r &= 63u;
+    return r ? (v >> r) | (v << (64u - r)) : v;
+}
+
+// Word holding pixel (x, y) of the current resolution, plus its bit mask.
+static inline uint64_t* pixel_word(Screen* s, uint8_t x, uint8_t y, uint64_t* out_mask) {
+    const uint8_t _x = (uint8_t)(x % screen_width(s));
+    const uint8_t _y = (uint8_t)(y % screen_height(s));
+    *out_mask = col_mask((uint8_t)(_x & 63u));
+    return (_x < 64u) ? &s->rows[_y] : &s->rows_right[_y];
+}
+
+// Word arrays of plane p (0 = plane 1, 1 = plane 2).
+static inline uint64_t* plane_left(Screen* s, unsigned p) {
+    return p ? s->rows2 : s->rows;
+}
+
+static inline uint64_t* plane_right(Screen* s, unsigned p) {
+    return p ? s->rows2_right : s->rows_right;
+}
+
+static inline bool plane_selected(const Screen* s, unsigned p) {
+    return (s->planes >> p) & 1u;
+}
+
+// XOR a sprite row (top-aligned in `bits`) into hi-res row y at column x;
+// the 128-bit row is the word pair (L, R). Returns the collisions.
+static inline uint64_t xor_hires_row(uint64_t* L, uint64_t* R, unsigned x, uint8_t y, uint64_t bits) {
+    uint64_t l = bits, r = 0;
+    x %= HIRES_WIDTH;
+    if (x >= 64u) { r = l; l = 0; x -= 64u; }
+    if (x) {
+        const uint64_t nl = (l >> x) | (r << (64u - x));
+        r = (r >> x) | (l << (64u - x));
+        l = nl;
+    }
+    const uint64_t hit = (L[y] & l) | (R[y] & r);
+    L[y] ^= l;
+    R[y] ^= r;
+    return hit;
+}
+
+// XOR a sprite row into lo-res row y of L at column x. Returns the collisions.
+static inline uint64_t xor_lores_row(uint64_t* L, unsigned x, uint8_t y, uint64_t bits) {
+    const uint64_t b = rotr64(bits, x % DISPLAY_WIDTH);
+    const uint64_t hit = L[y] & b;
+    L[y] ^= b;
+    return hit;
 }
 
 void screen_init(Screen* s) {
     if (!s) return;
-    memset(s->pixels, 0, sizeof(s->pixels));
-    s->dirty = true;
+    memset(s, 0, sizeof(*s));
+    s->planes = 1u;
+    s->dirty_rows = ROWS_MASK(DISPLAY_HEIGHT);
 }
 
 void screen_clear(Screen* s) {
     if (!s) return;
-    memset(s->pixels, 0, sizeof(s->pixels));
-    s->dirty = true;
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        memset(plane_left(s, p), 0, sizeof(s->rows));
+        memset(plane_right(s, p), 0, sizeof(s->rows_right));
+    }
+    s->dirty_rows = ROWS_MASK(screen_height(s));
+}
+
+void screen_set_hires(Screen* s, bool hires) {
+    if (!s) return;
+    s->hires = hires;
+    memset(s->rows, 0, sizeof(s->rows));
+    memset(s->rows_right, 0, sizeof(s->rows_right));
+    memset(s->rows2, 0, sizeof(s->rows2));
+    memset(s->rows2_right, 0, sizeof(s->rows2_right));
+    s->dirty_rows = ROWS_MASK(screen_height(s));
+}
+
+void screen_select_planes(Screen* s, uint8_t mask) {
+    if (!s) return;
+    s->planes = (uint8_t)(mask & ((1u << SCREEN_PLANES) - 1u));
+}
+
+uint8_t screen_plane_count(const Screen* s) {
+    if (!s) return 0;
+    return (uint8_t)((s->planes & 1u) + ((s->planes >> 1) & 1u));
+}
+
+uint8_t screen_width(const Screen* s) {
+    return (s && s->hires) ? HIRES_WIDTH : DISPLAY_WIDTH;
+}
+
+uint8_t screen_height(const Screen* s) {
+    return (s && s->hires) ? HIRES_HEIGHT : DISPLAY_HEIGHT;
 }
 
 uint8_t screen_get_pixel(const Screen* s, uint8_t x, uint8_t y) {
     if (!s) return 0;
-    return s->pixels[idx_wrap(x, y)] ? 1u : 0u;
+    uint64_t mask;
+    const uint64_t* word = pixel_word((Screen*)s, x, y, &mask);
+    return (*word & mask) ? 1u : 0u;
+}
+
+uint8_t screen_get_color(const Screen* s, uint8_t x, uint8_t y) {
+    if (!s) return 0;
+    const uint8_t _x = (uint8_t)(x % screen_width(s));
+    const uint8_t _y = (uint8_t)(y % screen_height(s));
+    const uint64_t mask = col_mask((uint8_t)(_x & 63u));
+    const uint64_t p1 = (_x < 64u) ? s->rows[_y]  : s->rows_right[_y];
+    const uint64_t p2 = (_x < 64u) ? s->rows2[_y] : s->rows2_right[_y];
+    return (uint8_t)(((p1 & mask) ? 1u : 0u) | ((p2 & mask) ? 2u : 0u));
 }
 
 Chip8Status screen_set_pixel(Screen* s, uint8_t x, uint8_t y, uint8_t val) {
     CHIP8_CHECK_ARG(s);
-    size_t i = idx_wrap(x, y);
-    uint8_t newv = val ? 1u : 0u;
+    uint64_t  mask;
+    uint64_t* row = pixel_word(s, x, y, &mask);
+    bool      cur = (*row & mask) != 0;
 
-    if (s->pixels[i] != newv) {
-        s->pixels[i] = newv;
-        s->dirty = true;
+    if (cur != (val != 0)) {
+        *row ^= mask;
+        s->dirty_rows |= 1ull << (y % screen_height(s));
         return CHIP8_OK;
     }
 
@@ -41,42 +148,249 @@ Chip8Status screen_set_pixel(Screen* s, uint8_t x, uint8_t y, uint8_t val) {
 
 bool screen_toggle_pixel(Screen* s, uint8_t x, uint8_t y) {
     if (!s) return false;
-    size_t i = idx_wrap(x, y);
-    uint8_t before = s->pixels[i];
-    s->pixels[i] ^= 1u;
-    s->dirty = true;
-    
+    uint64_t  mask;
+    uint64_t* row    = pixel_word(s, x, y, &mask);
+    bool      before = (*row & mask) != 0;
+    *row ^= mask;
+    s->dirty_rows |= 1ull << (y % screen_height(s));
+
     // Collision if a lit pixel got turned off due to XOR. (used in Dxyn instr)
-    return (before == 1u && s->pixels[i] == 0u);
+    return before;
+}
+
+// One plane's image of an n-row, 8-wide sprite.
+static uint64_t draw_plane(Screen* s, unsigned p, uint8_t x, uint8_t y, const uint8_t* sprite, uint8_t n) {
+    uint64_t* L = plane_left(s, p);
+    uint64_t hit = 0;
+
+    if (s->hires) {
+        uint64_t* R = plane_right(s, p);
+        for (uint8_t row = 0; row < n; ++row) {
+            if (!sprite[row]) continue;
+            const uint8_t _y = (uint8_t)((y + row) % HIRES_HEIGHT);
+            hit |= xor_hires_row(L, R, x, _y, (uint64_t)sprite[row] << 56);
+            s->dirty_rows |= 1ull << _y;
+        }
+        return hit;
+    }
+
+    for (uint8_t row = 0; row < n; ++row) {
+        if (!sprite[row]) continue;
+        // Sprite byte in the top 8 bits, rotated into place (wraps on x).
+        const uint8_t _y = (uint8_t)((uint8_t)(y + row) % DISPLAY_HEIGHT);
+        hit |= xor_lores_row(L, x, _y, (uint64_t)sprite[row] << 56);
+        s->dirty_rows |= 1ull << _y;
+    }
+    return hit;
+}
+
+// One plane's image of a 16x16 sprite.
+static uint64_t draw16_plane(Screen* s, unsigned p, uint8_t x, uint8_t y, const uint8_t* sprite) {
+    uint64_t* L = plane_left(s, p);
+    uint64_t* R = plane_right(s, p);
+    uint64_t hit = 0;
+
+    const uint8_t h = screen_height(s);
+    for (uint8_t row = 0; row < 16u; ++row) {
+        const uint16_t line = (uint16_t)((sprite[2 * row] << 8) | sprite[2 * row + 1]);
+        if (!line) continue;
+        const uint64_t bits = (uint64_t)line << 48;
+        const uint8_t  _y   = (uint8_t)((y + row) % h);
+        hit |= s->hires ? xor_hires_row(L, R, x, _y, bits) : xor_lores_row(L, x, _y, bits);
+        s->dirty_rows |= 1ull << _y;
+    }
+    return hit;
 }
 
 bool screen_draw_sprite(Screen* s, uint8_t x, uint8_t y, const uint8_t* sprite, uint8_t n) {
     if (!s || !sprite) return false;
-    bool collision = false;
+    uint64_t hit = 0;
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        hit |= draw_plane(s, p, x, y, sprite, n);
+        sprite += n;   // the next plane's image follows
+    }
+    return hit != 0;
+}
+
+bool screen_draw_sprite16(Screen* s, uint8_t x, uint8_t y, const uint8_t* sprite) {
+    if (!s || !sprite) return false;
+    uint64_t hit = 0;
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        hit |= draw16_plane(s, p, x, y, sprite);
+        sprite += 32;
+    }
+    return hit != 0;
+}
 
-    for (uint8_t row = 0; row < n; ++row) {
-        uint8_t bits = sprite[row];
-        uint8_t _y = (uint8_t)(y + row);
-        for (uint8_t col = 0; col < 8; ++col) {
-            if ((bits & (uint8_t)(0x80u >> col)) == 0) continue;
-
-            uint8_t _x = (uint8_t)(x + col);
-            if (screen_toggle_pixel(s, _x, _y)) {
-                collision = true;
+void screen_scroll_up(Screen* s, uint8_t n) {
+    if (!s || n == 0) return;
+    const uint8_t h = screen_height(s);
+    if (n >= h) { screen_clear(s); return; }
+
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        uint64_t* L = plane_left(s, p);
+        uint64_t* R = plane_right(s, p);
+        memmove(&L[0], &L[n], (size_t)(h - n) * sizeof(uint64_t));
+        memset(&L[h - n], 0, (size_t)n * sizeof(uint64_t));
+        if (s->hires) {
+            memmove(&R[0], &R[n], (size_t)(h - n) * sizeof(uint64_t));
+            memset(&R[h - n], 0, (size_t)n * sizeof(uint64_t));
+        }
+    }
+    s->dirty_rows = ROWS_MASK(h);
+}
+
+void screen_scroll_down(Screen* s, uint8_t n) {
+    if (!s || n == 0) return;
+    const uint8_t h = screen_height(s);
+    if (n >= h) { screen_clear(s); return; }
+
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        uint64_t* L = plane_left(s, p);
+        uint64_t* R = plane_right(s, p);
+        memmove(&L[n], &L[0], (size_t)(h - n) * sizeof(uint64_t));
+        memset(&L[0], 0, (size_t)n * sizeof(uint64_t));
+        if (s->hires) {
+            memmove(&R[n], &R[0], (size_t)(h - n) * sizeof(uint64_t));
+            memset(&R[0], 0, (size_t)n * sizeof(uint64_t));
+        }
+    }
+    s->dirty_rows = ROWS_MASK(h);
+}
+
+void screen_scroll_left(Screen* s, uint8_t n) {
+    if (!s || n == 0) return;
+    if (n >= screen_width(s)) { screen_clear(s); return; }
+
+    const uint8_t h = screen_height(s);
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        uint64_t* L = plane_left(s, p);
+        uint64_t* R = plane_right(s, p);
+        if (!s->hires) {
+            for (uint8_t y = 0; y < h; ++y) L[y] <<= n;
+        } else if (n < 64u) {
+            for (uint8_t y = 0; y < h; ++y) {
+                L[y] = (L[y] << n) | (R[y] >> (64u - n));
+                R[y] <<= n;
+            }
+        } else {
+            for (uint8_t y = 0; y < h; ++y) {
+                L[y] = R[y] << (n - 64u);
+                R[y] = 0;
+            }
+        }
+    }
+    s->dirty_rows = ROWS_MASK(h);
+}
+
+void screen_scroll_right(Screen* s, uint8_t n) {
+    if (!s || n == 0) return;
+    if (n >= screen_width(s)) { screen_clear(s); return; }
+
+    const uint8_t h = screen_height(s);
+    for (unsigned p = 0; p < SCREEN_PLANES; ++p) {
+        if (!plane_selected(s, p)) continue;
+        uint64_t* L = plane_left(s, p);
+        uint64_t* R = plane_right(s, p);
+        if (!s->hires) {
+            for (uint8_t y = 0; y < h; ++y) L[y] >>= n;
+        } else if (n < 64u) {
+            for (uint8_t y = 0; y < h; ++y) {
+                R[y] = (R[y] >> n) | (L[y] << (64u - n));
+                L[y] >>= n;
+            }
+        } else {
+            for (uint8_t y = 0; y < h; ++y) {
+                R[y] = L[y] >> (n - 64u);
+                L[y] = 0;
             }
         }
     }
-    
-    return collision;
+    s->dirty_rows = ROWS_MASK(h);
 }
 
-const uint8_t* screen_pixels(const Screen* s) {
-    return s ? s->pixels : NULL;
+const uint64_t* screen_rows(const Screen* s) {
+    return s ? s->rows : NULL;
+}
+
+const uint64_t* screen_rows_right(const Screen* s) {
+    return s ? s->rows_right : NULL;
+}
+
+const uint64_t* screen_rows2(const Screen* s) {
+    return s ? s->rows2 : NULL;
+}
+
+const uint64_t* screen_rows2_right(const Screen* s) {
+    return s ? s->rows2_right : NULL;
+}
+
+const uint8_t* screen_pixels(const Screen* s, uint8_t* out) {
+    if (!s || !out) return NULL;
+    const size_t w = screen_width(s), h = screen_height(s);
+    for (size_t y = 0; y < h; ++y) {
+        for (size_t x = 0; x < w; ++x) {
+            const uint64_t r1 = (x < 64u) ? s->rows[y]  : s->rows_right[y];
+            const uint64_t r2 = (x < 64u) ? s->rows2[y] : s->rows2_right[y];
+            const unsigned b  = 63u - (x & 63u);
+            out[y * w + x] = (uint8_t)(((r1 >> b) & 1u) | (((r2 >> b) & 1u) << 1));
+        }
+    }
+    return out;
+}
+
+static inline uint64_t hash_word(uint64_t h, uint64_t r) {
+    for (unsigned b = 0; b < 64u; b += 8u) { // byte order fixed: MSB first
+        h ^= (uint8_t)(r >> (56u - b));
+        h *= 0x100000001b3ull;               // FNV prime
+    }
+    return h;
+}
+
+// Plane 2 is only hashed when something is lit in it.
+static uint64_t hash_plane2(const Screen* s, uint64_t h) {
+    uint64_t any = 0;
+    for (size_t y = 0; y < HIRES_HEIGHT; ++y) any |= s->rows2[y] | s->rows2_right[y];
+    if (!any) return h;
+
+    h ^= 0x02u;                                  // plane marker
+    h *= 0x100000001b3ull;
+    const size_t height = screen_height(s);
+    for (size_t y = 0; y < height; ++y) {
+        h = hash_word(h, s->rows2[y]);
+        if (s->hires) h = hash_word(h, s->rows2_right[y]);
+    }
+    return h;
+}
+
+uint64_t screen_hash(const Screen* s) {
+    uint64_t h = 0xcbf29ce484222325ull;          // FNV-1a offset basis
+    if (!s) return h;
+    if (!s->hires) {
+        for (size_t y = 0; y < DISPLAY_HEIGHT; ++y) h = hash_word(h, s->rows[y]);
+        return hash_plane2(s, h);
+    }
+    h ^= 0x01u;                                  // mode byte: a blank hi-res screen differs from lo-res
+    h *= 0x100000001b3ull;
+    for (size_t y = 0; y < HIRES_HEIGHT; ++y) {
+        h = hash_word(h, s->rows[y]);
+        h = hash_word(h, s->rows_right[y]);
+    }
+    return hash_plane2(s, h);
 }
 
 bool screen_consume_dirty(Screen* s) {
-    if (!s) return false;
-    bool was_dirty = s->dirty;
-    s->dirty = false;
-    return was_dirty;
+    return screen_consume_dirty_rows(s) != 0;
+}
+
+uint64_t screen_consume_dirty_rows(Screen* s) {
+    if (!s) return 0;
+    uint64_t rows = s->dirty_rows;
+    s->dirty_rows = 0;
+    return rows;
 }
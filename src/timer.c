@@ -1,32 +1,46 @@
 #include "timer.h"
+#include <string.h>   // memset
+
+void timer_state_init(TimerState* ts)
+{
+    if (!ts) return;
+    memset(ts, 0, sizeof(*ts));
+}
 
 bool regs_tick_timers(Registers* regs,
+                      TimerState* ts,
                       uint64_t elapsed_ns,
                       bool* out_start_beep,
                       bool* out_stop_beep)
 {
-    if (!regs) return false;
-    static uint64_t acc_ns = 0;
-    static bool prev_st_nonzero = false; // to active 'beep' at first frame
+    if (!regs || !ts) return false;
 
     if (out_start_beep) *out_start_beep = false;
     if (out_stop_beep)  *out_stop_beep  = false;
 
-    acc_ns += elapsed_ns;
+    ts->acc_ns += elapsed_ns;
     const uint64_t step_ns = 1000000000ull / 60ull;
 
-    while (acc_ns >= step_ns) {
-        acc_ns -= step_ns;
-        if (regs->DT > 0) regs->DT--;
-        if (regs->ST > 0) regs->ST--;
+    while (ts->acc_ns >= step_ns) {
+        ts->acc_ns -= step_ns;
+        regs_tick_frame(regs);
     }
 
     bool cur_st_nonzero = (regs->ST > 0);
+    bool prev_st_nonzero = ts->prev_st_nonzero; // false initially: beep starts on first call
 
     if (!prev_st_nonzero && cur_st_nonzero && out_start_beep) *out_start_beep = true;
     if ( prev_st_nonzero && !cur_st_nonzero && out_stop_beep)  *out_stop_beep  = true;
 
     bool changed = (prev_st_nonzero != cur_st_nonzero);
-    prev_st_nonzero = cur_st_nonzero;
+    ts->prev_st_nonzero = cur_st_nonzero;
     return changed;
 }
+
+void regs_tick_frame(Registers* regs)
+{
+    if (!regs) return;
+    if (regs->DT > 0) regs->DT--;
+    if (regs->ST > 0) regs->ST--;
+    regs->vblank_wait = false;
+}
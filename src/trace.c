@@ -0,0 +1,328 @@
+#include <stdatomic.h>
+#include <stdio.h>    // FILE, fopen, fwrite, fread, fseek
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcmp, memcpy
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #include <sched.h>   // sched_yield
+  #include <time.h>    // nanosleep
+#endif
+
+#include "trace.h"
+
+static const uint8_t TRACE_MAGIC[4] = { 'C', '8', 'T', 'R' };
+
+#define TRACE_DEFAULT_CAPACITY (1u << 20)
+#define TRACE_WRITE_CHUNK      4096u   /* records per fwrite */
+
+_Static_assert(sizeof(TraceRecord) == TRACE_RECORD_SIZE, "TraceRecord must match the file record");
+
+struct TraceRing {
+    TraceRecord* buf;
+    size_t       mask;
+    bool         drop_when_full;
+
+    /* producer (emulator thread) */
+    _Atomic size_t head;
+    size_t         tail_seen;     /* last tail read, so most pushes skip the atomic load */
+    uint64_t       dropped;
+    uint64_t       stalls;
+
+    /* consumer (writer thread) */
+    _Atomic size_t tail;
+    _Atomic bool   stop;
+    FILE*          fp;
+    uint64_t       written;
+    Chip8Status    error;
+
+#ifdef _WIN32
+    HANDLE         thread;
+#else
+    pthread_t      thread;
+#endif
+};
+
+/* ---------- platform ---------- */
+
+static void pause_ms(unsigned ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts = { 0, (long)ms * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void yield_cpu(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/* ---------- file I/O ---------- */
+
+static size_t put_le(uint8_t* p, uint64_t v, size_t n) {
+    for (size_t i = 0; i < n; ++i) p[i] = (uint8_t)(v >> (8 * i));
+    return n;
+}
+
+static uint64_t get_le(const uint8_t* p, size_t n) {
+    uint64_t v = 0;
+    for (size_t i = n; i-- > 0;) v = (v << 8) | p[i];
+    return v;
+}
+
+static FILE* open_file(const char* path, const char* mode) {
+    FILE* fp = NULL;
+#ifdef _MSC_VER
+    if (fopen_s(&fp, path, mode) != 0) fp = NULL;
+#else
+    fp = fopen(path, mode);
+#endif
+    if (!fp) CHIP8_LOG_ERROR("Failed to open: %s", path);
+    return fp;
+}
+
+static void put_header(uint8_t* h, uint64_t rom_hash, uint64_t records, uint64_t dropped) {
+    size_t o = 0;
+    memcpy(h, TRACE_MAGIC, sizeof(TRACE_MAGIC)); o += sizeof(TRACE_MAGIC);
+    o += put_le(h + o, TRACE_VERSION, 2);
+    o += put_le(h + o, TRACE_RECORD_SIZE, 2);
+    o += put_le(h + o, rom_hash, 8);
+    o += put_le(h + o, records, 8);
+    o += put_le(h + o, dropped, 8);
+}
+
+/* On little-endian hosts TraceRecord already has the file layout. */
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  #define TRACE_RAW_RECORDS 1
+#else
+  #define TRACE_RAW_RECORDS 0
+#endif
+
+#if !TRACE_RAW_RECORDS
+static void put_record(uint8_t* p, const TraceRecord* r) {
+    size_t o = 0;
+    o += put_le(p + o, r->cycle, 8);
+    o += put_le(p + o, r->pc, 2);
+    o += put_le(p + o, r->op, 2);
+    o += put_le(p + o, r->i, 2);
+    p[o++] = r->vx;
+    p[o++] = r->vf;
+}
+#endif
+
+/* Write records [from, to) of the ring (ring positions, not indices). */
+static void write_records(TraceRing* t, size_t from, size_t to) {
+#if !TRACE_RAW_RECORDS
+    uint8_t out[TRACE_WRITE_CHUNK * TRACE_RECORD_SIZE];
+#endif
+    while (from != to && t->error == CHIP8_OK) {
+        /* up to the end of the buffer at most, so the chunk is contiguous */
+        const size_t at = from & t->mask;
+        size_t n = to - from;
+        if (n > t->mask + 1 - at)    n = t->mask + 1 - at;
+        if (n > TRACE_WRITE_CHUNK)   n = TRACE_WRITE_CHUNK;
+#if TRACE_RAW_RECORDS
+        const void* out = &t->buf[at];
+#else
+        for (size_t k = 0; k < n; ++k) put_record(out + k * TRACE_RECORD_SIZE, &t->buf[at + k]);
+#endif
+        if (fwrite(out, TRACE_RECORD_SIZE, n, t->fp) != n) t->error = CHIP8_ERR_FILE_IO;
+        else t->written += n;
+        from += n;
+        atomic_store_explicit(&t->tail, from, memory_order_release);
+    }
+}
+
+/* ---------- writer thread ---------- */
+
+static void drain(TraceRing* t) {
+    for (;;) {
+        const bool   stop = atomic_load_explicit(&t->stop, memory_order_acquire);
+        const size_t head = atomic_load_explicit(&t->head, memory_order_acquire);
+        const size_t tail = atomic_load_explicit(&t->tail, memory_order_relaxed);
+        if (head != tail) {
+            write_records(t, tail, head);
+            if (t->error != CHIP8_OK) {
+                /* keep consuming so a waiting producer is never stuck */
+                atomic_store_explicit(&t->tail, head, memory_order_release);
+            }
+        } else if (stop) {
+            return;   /* head was read after stop: nothing can follow */
+        } else {
+            pause_ms(1);
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI writer_main(LPVOID arg) { drain((TraceRing*)arg); return 0; }
+#else
+static void* writer_main(void* arg) { drain((TraceRing*)arg); return NULL; }
+#endif
+
+/* ---------- ring ---------- */
+
+Chip8Status trace_open(TraceRing** out, const char* path, size_t capacity, uint64_t rom_hash,
+                       bool drop_when_full) {
+    CHIP8_CHECK_ARG(out);
+    CHIP8_CHECK_ARG(path);
+    *out = NULL;
+
+    size_t cap = TRACE_BATCH;
+    if (capacity == 0) capacity = TRACE_DEFAULT_CAPACITY;
+    while (cap < capacity) cap <<= 1;
+
+    TraceRing* t = (TraceRing*)calloc(1, sizeof(*t));
+    if (!t) return CHIP8_ERR_OUT_OF_MEMORY;
+    t->buf = (TraceRecord*)malloc(cap * sizeof(TraceRecord));
+    if (!t->buf) {
+        free(t);
+        return CHIP8_ERR_OUT_OF_MEMORY;
+    }
+    t->mask = cap - 1;
+    t->drop_when_full = drop_when_full;
+    t->error = CHIP8_OK;
+    atomic_init(&t->head, 0);
+    atomic_init(&t->tail, 0);
+    atomic_init(&t->stop, false);
+
+    uint8_t h[TRACE_HEADER_SIZE];
+    put_header(h, rom_hash, 0, 0);
+    t->fp = open_file(path, "wb");
+    Chip8Status st = t->fp ? CHIP8_OK : CHIP8_ERR_FILE_OPEN;
+    if (st == CHIP8_OK && fwrite(h, 1, sizeof(h), t->fp) != sizeof(h)) st = CHIP8_ERR_FILE_IO;
+
+    if (st == CHIP8_OK) {
+#ifdef _WIN32
+        t->thread = CreateThread(NULL, 0, writer_main, t, 0, NULL);
+        if (!t->thread) st = CHIP8_ERR_OUT_OF_MEMORY;
+#else
+        if (pthread_create(&t->thread, NULL, writer_main, t) != 0) st = CHIP8_ERR_OUT_OF_MEMORY;
+#endif
+    }
+    if (st != CHIP8_OK) {
+        if (t->fp) fclose(t->fp);
+        free(t->buf);
+        free(t);
+        return st;
+    }
+    *out = t;
+    return CHIP8_OK;
+}
+
+void trace_writer_flush(TraceWriter* w) {
+    if (!w || w->count == 0) return;
+    TraceRing* t = w->ring;
+    if (!t) {
+        w->count = 0;
+        return;
+    }
+
+    const size_t cap  = t->mask + 1;
+    size_t       head = atomic_load_explicit(&t->head, memory_order_relaxed);
+    uint32_t     n    = w->count;
+
+    if (head + n - t->tail_seen > cap) {
+        t->tail_seen = atomic_load_explicit(&t->tail, memory_order_acquire);
+        if (head + n - t->tail_seen > cap) {
+            if (t->drop_when_full) {
+                t->dropped += n;
+                w->count = 0;
+                return;
+            }
+            ++t->stalls;
+            do {
+                yield_cpu();
+                t->tail_seen = atomic_load_explicit(&t->tail, memory_order_acquire);
+            } while (head + n - t->tail_seen > cap);
+        }
+    }
+
+    /* at most two copies: up to the end of the buffer, then from its start */
+    const size_t at    = head & t->mask;
+    const size_t first = (n < cap - at) ? n : cap - at;
+    memcpy(&t->buf[at], w->batch, first * sizeof(TraceRecord));
+    memcpy(&t->buf[0], w->batch + first, (n - first) * sizeof(TraceRecord));
+    atomic_store_explicit(&t->head, head + n, memory_order_release);
+    w->count = 0;
+}
+
+Chip8Status trace_close(TraceRing* t, TraceStats* stats) {
+    CHIP8_CHECK_ARG(t);
+
+    atomic_store_explicit(&t->stop, true, memory_order_release);
+#ifdef _WIN32
+    WaitForSingleObject(t->thread, INFINITE);
+    CloseHandle(t->thread);
+#else
+    pthread_join(t->thread, NULL);
+#endif
+
+    /* the counts are a convenience: a stream that cannot seek keeps zeros */
+    Chip8Status st = t->error;
+    uint8_t h[TRACE_HEADER_SIZE];
+    put_header(h, 0, t->written, t->dropped);
+    if (fseek(t->fp, 16, SEEK_SET) == 0 && fwrite(h + 16, 1, 16, t->fp) != 16 && st == CHIP8_OK) {
+        st = CHIP8_ERR_FILE_IO;
+    }
+    if (fclose(t->fp) != 0 && st == CHIP8_OK) st = CHIP8_ERR_FILE_IO;
+
+    if (stats) {
+        stats->records = t->written;
+        stats->dropped = t->dropped;
+        stats->stalls  = t->stalls;
+    }
+    free(t->buf);
+    free(t);
+    return st;
+}
+
+/* ---------- reading ---------- */
+
+Chip8Status trace_read_header(FILE* fp, TraceHeader* out) {
+    CHIP8_CHECK_ARG(fp);
+    CHIP8_CHECK_ARG(out);
+
+    uint8_t h[TRACE_HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), fp) != sizeof(h)) return CHIP8_ERR_TRACE_INVALID;
+    if (memcmp(h, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || get_le(h + 4, 2) != TRACE_VERSION ||
+        get_le(h + 6, 2) != TRACE_RECORD_SIZE) {
+        return CHIP8_ERR_TRACE_INVALID;
+    }
+    out->rom_hash = get_le(h + 8, 8);
+    out->records  = get_le(h + 16, 8);
+    out->dropped  = get_le(h + 24, 8);
+    return CHIP8_OK;
+}
+
+size_t trace_read(FILE* fp, TraceRecord* out, size_t max) {
+    if (!fp || !out) return 0;
+    uint8_t in[256 * TRACE_RECORD_SIZE];
+    size_t total = 0;
+    while (total < max) {
+        size_t want = max - total;
+        if (want > 256) want = 256;
+        const size_t n = fread(in, TRACE_RECORD_SIZE, want, fp);   /* a torn last record is ignored */
+        for (size_t k = 0; k < n; ++k) {
+            const uint8_t* p = in + k * TRACE_RECORD_SIZE;
+            TraceRecord* r = &out[total + k];
+            r->cycle = get_le(p, 8);
+            r->pc    = (uint16_t)get_le(p + 8, 2);
+            r->op    = (uint16_t)get_le(p + 10, 2);
+            r->i     = (uint16_t)get_le(p + 12, 2);
+            r->vx    = p[14];
+            r->vf    = p[15];
+        }
+        total += n;
+        if (n < want) break;
+    }
+    return total;
+}
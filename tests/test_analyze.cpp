@@ -0,0 +1,138 @@
+// tests/test_analyze.cpp
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "analyze.h"
+#include "chip8.h"
+#include "mem.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+static void write_words(Memory& m, uint16_t at, const uint16_t* ops, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(CHIP8_OK, memory_write(&m, (uint16_t)(at + 2 * i),     (uint8_t)(ops[i] >> 8)));
+        ASSERT_EQ(CHIP8_OK, memory_write(&m, (uint16_t)(at + 2 * i + 1), (uint8_t)(ops[i] & 0xFF)));
+    }
+}
+
+/* Calls, skips, a long load, data and an indirect jump. */
+static const uint16_t kProg[] = {
+    0xA220,          // 0x200: LD I, 0x220      (data)
+    0x2210,          // 0x202: CALL 0x210
+    0x3000,          // 0x204: SE V0, 0
+    0xF000, 0x1234,  // 0x206: LD I, long 0x1234 (skipped as a whole)
+    0x120E,          // 0x20A: JP 0x20E
+    0x0000,          // 0x20C: never reached
+    0xB300,          // 0x20E: JP V0, 0x300     (indirect)
+    0x6001,          // 0x210: LD V0, 1
+    0x00EE,          // 0x212: RET
+};
+
+TEST(Analyze, MarksReachableCodeAndData) {
+    static Memory m;
+    memory_init(&m);
+    write_words(m, PROGRAM_START_ADDRESS, kProg, sizeof(kProg) / sizeof(kProg[0]));
+
+    static RomAnalysis a;
+    ASSERT_EQ(CHIP8_OK, rom_analyze(&m, PROGRAM_START_ADDRESS, &a));
+
+    EXPECT_EQ(8u, a.instr_count);
+    EXPECT_EQ(18u, a.code_bytes);
+    EXPECT_EQ(1u, a.indirect_count);
+    EXPECT_EQ(0u, a.unknown_count);
+
+    EXPECT_TRUE(a.flags[0x206] & ANALYZE_CODE);
+    EXPECT_TRUE(a.flags[0x209] & ANALYZE_OPERAND);       // F000's address word
+    EXPECT_FALSE(a.flags[0x20C] & (ANALYZE_CODE | ANALYZE_OPERAND));
+    EXPECT_TRUE(a.flags[0x210] & ANALYZE_CALL);
+    EXPECT_TRUE(a.flags[0x20A] & ANALYZE_JUMP);          // skip outcome past the 4-byte op
+    EXPECT_TRUE(a.flags[0x20E] & ANALYZE_INDIRECT);
+    EXPECT_TRUE(a.flags[0x220] & ANALYZE_DATA_REF);
+    EXPECT_FALSE(a.flags[0x300] & ANALYZE_CODE);          // behind the indirect jump
+
+    rom_analysis_free(&a);
+    memory_release(&m);
+}
+
+TEST(Analyze, BuildsBlocksWithSuccessors) {
+    static Memory m;
+    memory_init(&m);
+    write_words(m, PROGRAM_START_ADDRESS, kProg, sizeof(kProg) / sizeof(kProg[0]));
+
+    static RomAnalysis a;
+    ASSERT_EQ(CHIP8_OK, rom_analyze(&m, PROGRAM_START_ADDRESS, &a));
+
+    // 0x200 (call), 0x204 (skip), 0x206, 0x20A (jump), 0x20E (indirect), 0x210 (ret)
+    ASSERT_EQ(6u, a.block_count);
+
+    const long entry = rom_analysis_find_block(&a, 0x200);
+    ASSERT_GE(entry, 0);
+    EXPECT_EQ(2u, a.blocks[entry].instrs);
+    EXPECT_EQ(BLOCK_END_CALL, a.blocks[entry].end);
+    ASSERT_EQ(2u, a.blocks[entry].nsucc);
+    EXPECT_EQ(0x210, a.blocks[entry].succ[0]);
+    EXPECT_EQ(0x204, a.blocks[entry].succ[1]);
+
+    const long skip = rom_analysis_find_block(&a, 0x204);
+    ASSERT_GE(skip, 0);
+    EXPECT_EQ(BLOCK_END_BRANCH, a.blocks[skip].end);
+    EXPECT_EQ(0x206, a.blocks[skip].succ[0]);
+    EXPECT_EQ(0x20A, a.blocks[skip].succ[1]);
+
+    const long fall = rom_analysis_find_block(&a, 0x206);
+    ASSERT_GE(fall, 0);
+    EXPECT_EQ(BLOCK_END_FALL, a.blocks[fall].end);
+    EXPECT_EQ(0x20A, a.blocks[fall].succ[0]);
+
+    EXPECT_EQ(BLOCK_END_INDIRECT, a.blocks[rom_analysis_find_block(&a, 0x20E)].end);
+    EXPECT_EQ(BLOCK_END_RET, a.blocks[rom_analysis_find_block(&a, 0x210)].end);
+    EXPECT_EQ(-1, rom_analysis_find_block(&a, 0x202));
+
+    rom_analysis_free(&a);
+    memory_release(&m);
+}
+
+TEST(Analyze, StopsAtUnknownOpcodesAndRamEnd) {
+    static Memory m;
+    memory_init(&m);
+    const uint16_t prog[] = { 0x6001, 0xE000 };          // LD V0, 1; undecodable
+    write_words(m, PROGRAM_START_ADDRESS, prog, 2);
+    const uint16_t tail[] = { 0x7001 };                  // ADD at the last word: nothing follows
+    write_words(m, (uint16_t)(MEMORY_SIZE - 2), tail, 1);
+
+    static RomAnalysis a;
+    ASSERT_EQ(CHIP8_OK, rom_analyze(&m, PROGRAM_START_ADDRESS, &a));
+    EXPECT_EQ(1u, a.unknown_count);
+    EXPECT_TRUE(a.flags[0x202] & ANALYZE_UNKNOWN);
+    EXPECT_EQ(BLOCK_END_STOP, a.blocks[0].end);
+    rom_analysis_free(&a);
+
+    ASSERT_EQ(CHIP8_OK, rom_analyze(&m, (uint16_t)(MEMORY_SIZE - 2), &a));
+    EXPECT_EQ(1u, a.instr_count);
+    EXPECT_FALSE(a.flags[0] & ANALYZE_CODE);             // no wrap to 0x0000
+    rom_analysis_free(&a);
+    memory_release(&m);
+}
+
+TEST(Analyze, PredecodeFillsTheDecodeCache) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    write_words(c8.chip8_mem, PROGRAM_START_ADDRESS, kProg, sizeof(kProg) / sizeof(kProg[0]));
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+
+    static RomAnalysis a;
+    ASSERT_EQ(CHIP8_OK, rom_analyze(&c8.chip8_mem, PROGRAM_START_ADDRESS, &a));
+    EXPECT_EQ(8u, chip8_predecode(&c8, &a));
+    EXPECT_NE(nullptr, c8.chip8_icache.slots[0x210 >> 1].fn);
+    EXPECT_EQ(nullptr, c8.chip8_icache.slots[0x20C >> 1].fn);
+    EXPECT_NE(0, c8.chip8_icache.block_len[0x200 >> 1]);
+
+    // Pre-decoded slots stay coherent with RAM writes.
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x211, 0x05));   // LD V0, 5
+    for (int i = 0; i < 4; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&c8));
+    EXPECT_EQ(5, c8.chip8_regs.V[0]);
+
+    rom_analysis_free(&a);
+    chip8_destroy(&c8);
+}
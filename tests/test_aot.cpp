@@ -0,0 +1,132 @@
+// tests/test_aot.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "aot.h"
+#include "chip8.h"
+#include "mem.h"
+#include "replay.h"
+#include "screen.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+/* A hand-translated module for one unit: 0x200: ADD V1, 1; ADD V1, 1; JP 0x200. */
+static const uint8_t kImage[] = { 0x71, 0x01, 0x71, 0x01, 0x12, 0x00 };
+static const AotUnit kUnits[] = { { 0x200, 6, 3 } };
+static uint16_t g_entry[AOT_SPAN];
+static uint16_t g_owner[AOT_SPAN];
+static int g_runs;
+
+static uint32_t hand_run(struct Chip8* c8, const uint32_t budget) {
+    Registers* const r = &c8->chip8_regs;
+    uint32_t left = budget;
+    ++g_runs;
+    while (left >= 3 && c8->chip8_aot_state[0] == AOT_UNIT_LIVE) {
+        left -= 3;
+        r->V[1] = (uint8_t)(r->V[1] + 2);
+        r->PC = 0x200;
+    }
+    return budget - left;
+}
+
+static const AotModule kModule = {
+    "hand", 0, CHIP8_QUIRKS_DEFAULT, kImage, sizeof(kImage), kUnits, 1, g_entry, g_owner, hand_run,
+};
+
+static void load_hand(struct Chip8& c8) {
+    g_entry[0x200] = 1;
+    for (uint16_t a = 0x200; a < 0x206; ++a) g_owner[a] = 1;
+    g_runs = 0;
+
+    chip8_init(&c8);
+    ASSERT_EQ(CHIP8_OK, memory_load_rom(&c8.chip8_mem, kImage, sizeof(kImage)));
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    chip8_set_aot(&c8, &kModule);
+}
+
+TEST(Aot, RunsUnitsWholeWithinBudget) {
+    static struct Chip8 c8;
+    load_hand(c8);
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 31, &ran));
+    EXPECT_EQ(31u, ran);
+    EXPECT_EQ(21, c8.chip8_regs.V[1]);          // 10 native passes, then one interpreted ADD
+    EXPECT_EQ(0x202, c8.chip8_regs.PC);
+    chip8_destroy(&c8);
+}
+
+#ifndef CHIP8_PROFILE   /* profiler builds always interpret */
+TEST(Aot, WritesUnderAUnitAreVerifiedOnEntry) {
+    static struct Chip8 c8;
+    load_hand(c8);
+    uint32_t ran = 0;
+
+    // rewriting the same byte keeps the unit native after one check
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x203, 0x01));
+    EXPECT_EQ(AOT_UNIT_UNVERIFIED, c8.chip8_aot_state[0]);
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 6, &ran));
+    EXPECT_EQ(AOT_UNIT_LIVE, c8.chip8_aot_state[0]);
+    EXPECT_EQ(1, g_runs);
+    EXPECT_EQ(4, c8.chip8_regs.V[1]);
+
+    // patched code is interpreted: ADD V1, 5
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x203, 0x05));
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 6, &ran));
+    EXPECT_EQ(AOT_UNIT_STALE, c8.chip8_aot_state[0]);
+    EXPECT_EQ(1, g_runs);
+    EXPECT_EQ(16, c8.chip8_regs.V[1]);
+
+    // restoring the original bytes brings it back
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x203, 0x01));
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 6, &ran));
+    EXPECT_EQ(2, g_runs);
+    EXPECT_EQ(20, c8.chip8_regs.V[1]);
+    chip8_destroy(&c8);
+}
+#endif
+
+TEST(Aot, OtherQuirksProfileInterprets) {
+    static struct Chip8 c8;
+    load_hand(c8);
+    chip8_set_quirks(&c8, CHIP8_QUIRKS_VIP);
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 30, &ran));
+    EXPECT_EQ(0, g_runs);
+    EXPECT_EQ(20, c8.chip8_regs.V[1]);
+    chip8_destroy(&c8);
+}
+
+#ifdef CHIP8_AOT_GAMES
+/* Every translated ROM must match the interpreter frame for frame. */
+TEST(Aot, CorpusMatchesInterpreter) {
+    ASSERT_GT(aot_games.count, 0u);
+    static struct Chip8 interp, native;
+
+    for (size_t i = 0; i < aot_games.count; ++i) {
+        const AotModule* mod = aot_games.modules[i];
+        SCOPED_TRACE(mod->name);
+        for (struct Chip8* c8 : { &interp, &native }) {
+            chip8_init(c8);
+            ASSERT_EQ(CHIP8_OK, memory_load_rom(&c8->chip8_mem, mod->image, mod->image_size));
+            chip8_set_quirks(c8, mod->quirks);
+        }
+        EXPECT_EQ(mod, aot_find(&aot_games, input_log_rom_hash(&native.chip8_mem)));
+        chip8_set_aot(&native, mod);
+
+        uint32_t ran = 0;
+        for (int frame = 0; frame < 600; ++frame) {
+            ASSERT_EQ(chip8_run_frame(&interp, 1000, &ran), chip8_run_frame(&native, 1000, &ran));
+            ASSERT_EQ(interp.chip8_regs.PC, native.chip8_regs.PC) << "frame " << frame;
+            ASSERT_EQ(interp.chip8_regs.I, native.chip8_regs.I) << "frame " << frame;
+            ASSERT_EQ(0, memcmp(interp.chip8_regs.V, native.chip8_regs.V, sizeof(interp.chip8_regs.V)));
+        }
+        EXPECT_EQ(screen_hash(&interp.chip8_disp), screen_hash(&native.chip8_disp));
+        chip8_destroy(&interp);
+        chip8_destroy(&native);
+    }
+}
+#endif
@@ -0,0 +1,296 @@
+// tests/test_chip8.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "chip8.h"
+#include "instr.h"
+#include "icache.h"
+#include "mem.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+/* Load a big-endian opcode sequence at PROGRAM_START_ADDRESS and point PC at it. */
+static void load_program(struct Chip8& c8, const uint16_t* ops, size_t count) {
+    chip8_init(&c8);
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t a = (uint16_t)(PROGRAM_START_ADDRESS + 2 * i);
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, a,     (uint8_t)(ops[i] >> 8)));
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, a + 1, (uint8_t)(ops[i] & 0xFF)));
+    }
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+}
+
+TEST(Chip8, DecodeExtractsOperands) {
+    Instr in{};
+    instr_decode(0xD12F, &in);
+    EXPECT_NE(nullptr, in.fn);
+    EXPECT_EQ(0xD12F, in.op);
+    EXPECT_EQ(0x1, in.x);
+    EXPECT_EQ(0x2, in.y);
+    EXPECT_EQ(0x2F, in.kk);
+    EXPECT_EQ(0xF, in.n);
+    EXPECT_EQ(0x12F, in.nnn);
+}
+
+TEST(Chip8, StepRunsStraightLineCode) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = { 0x6105, 0x7103, 0xA321 }; // LD V1,5; ADD V1,3; LD I,0x321
+    load_program(c8, prog, 3);
+
+    for (int i = 0; i < 3; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&c8));
+    EXPECT_EQ(8, c8.chip8_regs.V[1]);
+    EXPECT_EQ(0x321, c8.chip8_regs.I);
+    EXPECT_EQ(PROGRAM_START_ADDRESS + 6, c8.chip8_regs.PC);
+}
+
+/* Code that rewrites an already-executed instruction must see the new opcode. */
+TEST(Chip8, SelfModifyingWriteInvalidatesDecodeCache) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = {
+        0x6001,          // 0x200: LD V0, 1
+        0x6177,          // 0x202: LD V1, 0x77
+        0xA200,          // 0x204: LD I, 0x200
+        0xF155,          // 0x206: LD [I], V0..V1  -> rewrites 0x200 as 0x0177 (SYS)
+        0x1200,          // 0x208: JP 0x200
+    };
+    load_program(c8, prog, 5);
+
+    for (int i = 0; i < 5; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&c8));
+    ASSERT_EQ(0x200, c8.chip8_regs.PC);
+
+    c8.chip8_regs.V[0] = 0xAA;
+    ASSERT_EQ(CHIP8_OK, chip8_step(&c8));     // now SYS 0x177: a no-op
+    EXPECT_EQ(0xAA, c8.chip8_regs.V[0]);      // stale "LD V0, 1" would reset it
+}
+
+TEST(Chip8, OddPCExecutesWithoutCache) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x301, 0x6A));
+    ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x302, 0x42));
+    c8.chip8_regs.PC = 0x301;
+
+    ASSERT_EQ(CHIP8_OK, chip8_step(&c8));
+    EXPECT_EQ(0x42, c8.chip8_regs.V[0xA]);
+    EXPECT_EQ(0x303, c8.chip8_regs.PC);
+}
+
+TEST(Chip8, StepAtEndOfMemoryIsOOB) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    c8.chip8_regs.PC = MEMORY_SIZE - 1;
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, chip8_step(&c8));
+}
+
+/* ---------- run-block mode ---------- */
+
+TEST(Chip8, RunBlocksMatchesSingleStepping) {
+    static struct Chip8 a, b;
+    const uint16_t prog[] = {
+        0x6105,          // 0x200: LD V1, 5
+        0x7103,          // 0x202: ADD V1, 3
+        0x8214,          // 0x204: ADD V2, V1
+        0x3250,          // 0x206: SE V2, 0x50
+        0x1200,          // 0x208: JP 0x200
+        0x6FAA,          // 0x20A: LD VF, 0xAA
+        0x120A,          // 0x20C: JP 0x20A
+    };
+    load_program(a, prog, 7);
+    load_program(b, prog, 7);
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&a, 1000, &ran));
+    EXPECT_EQ(1000u, ran);
+    for (int i = 0; i < 1000; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&b));
+
+    EXPECT_EQ(0, memcmp(a.chip8_regs.V, b.chip8_regs.V, sizeof(a.chip8_regs.V)));
+    EXPECT_EQ(b.chip8_regs.PC, a.chip8_regs.PC);
+    EXPECT_EQ(0xAA, a.chip8_regs.V[0xF]);
+}
+
+TEST(Chip8, RunBlocksHonoursCycleBudget) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = { 0x7101, 0x7101, 0x7101, 0x7101, 0x1200 };
+    load_program(c8, prog, 5);
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 2, &ran));
+    EXPECT_EQ(2u, ran);
+    EXPECT_EQ(2, c8.chip8_regs.V[1]);
+    EXPECT_EQ(0x204, c8.chip8_regs.PC);
+
+    // resuming mid-block builds a new block from the current PC
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 3, &ran));
+    EXPECT_EQ(3u, ran);
+    EXPECT_EQ(4, c8.chip8_regs.V[1]);
+    EXPECT_EQ(0x200, c8.chip8_regs.PC);
+}
+
+TEST(Chip8, RunBlocksSeesSelfModifiedCode) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = {
+        0x6001,          // 0x200: LD V0, 1
+        0x6177,          // 0x202: LD V1, 0x77
+        0xA202,          // 0x204: LD I, 0x202
+        0xF155,          // 0x206: LD [I], V0..V1 -> rewrites 0x202 as 0x0177 (SYS)
+        0x1200,          // 0x208: JP 0x200
+    };
+    load_program(c8, prog, 5);
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 5, &ran));
+    ASSERT_EQ(0x200, c8.chip8_regs.PC);
+
+    c8.chip8_regs.V[1] = 0x55;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 2, &ran));
+    EXPECT_EQ(0x55, c8.chip8_regs.V[1]);   // stale block would reload 0x77
+}
+
+TEST(Chip8, RunFrameTicksTimersExactlyOnce) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = { 0x7101, 0x1200 };  // ADD V1,1; JP 0x200
+    load_program(c8, prog, 2);
+    c8.chip8_regs.DT = 10;
+    c8.chip8_regs.ST = 1;
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    EXPECT_EQ(12u, ran);
+    EXPECT_EQ(6, c8.chip8_regs.V[1]);
+    EXPECT_EQ(9, c8.chip8_regs.DT);
+    EXPECT_EQ(0, c8.chip8_regs.ST);
+
+    ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    EXPECT_EQ(8, c8.chip8_regs.DT);
+    EXPECT_EQ(0, c8.chip8_regs.ST);   // stays at zero
+}
+
+/* Forks share RAM copy-on-write but diverge independently, decode cache included. */
+TEST(Chip8, ForkDivergesIndependently) {
+    static struct Chip8 parent, child;
+    const uint16_t prog[] = {
+        0xA300,          // 0x200: LD I, 0x300
+        0x7001,          // 0x202: ADD V0, 1
+        0xF055,          // 0x204: LD [I], V0
+        0x1200,          // 0x206: JP 0x200
+    };
+    load_program(parent, prog, 4);
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&parent, 8, &ran));   // two passes, cache warm
+
+    chip8_fork(&child, &parent);
+    EXPECT_EQ(parent.chip8_regs.PC, child.chip8_regs.PC);
+
+    // Patch the child's loop into ADD V0, 2; the parent must keep adding 1.
+    ASSERT_EQ(CHIP8_OK, memory_write(&child.chip8_mem, 0x203, 0x02));
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&parent, 40, &ran));
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&child, 40, &ran));
+
+    EXPECT_EQ(0x01, memory_peek(&parent.chip8_mem, 0x203));
+    EXPECT_EQ(12, parent.chip8_regs.V[0]);
+    EXPECT_EQ(22, child.chip8_regs.V[0]);
+    EXPECT_EQ(12, memory_peek(&parent.chip8_mem, 0x300));
+    EXPECT_EQ(22, memory_peek(&child.chip8_mem, 0x300));
+
+    chip8_destroy(&child);
+    chip8_destroy(&parent);
+}
+
+TEST(Chip8, IdleStateClassifiesWaitLoops) {
+    static struct Chip8 c8;
+    const uint16_t prog[] = {
+        0xF107, 0x3100, 0x1200,   // 0x200: LD V1,DT; SE V1,0; JP 0x200
+        0xF20A,                   // 0x206: LD V2,K
+        0x1208,                   // 0x208: JP 0x208
+        0x7001,                   // 0x20A: ADD V0,1
+    };
+    load_program(c8, prog, 6);
+
+    c8.chip8_regs.DT = 3;
+    EXPECT_EQ(CHIP8_IDLE_TIMER, chip8_idle_state(&c8));
+    c8.chip8_regs.DT = 0;   // SE takes the exit
+    EXPECT_EQ(CHIP8_IDLE_NONE, chip8_idle_state(&c8));
+
+    c8.chip8_regs.PC = 0x206;
+    EXPECT_EQ(CHIP8_IDLE_KEY, chip8_idle_state(&c8));
+    ASSERT_EQ(CHIP8_OK, keyboard_press(&c8.chip8_kbd, 0x4));
+    EXPECT_EQ(CHIP8_IDLE_NONE, chip8_idle_state(&c8));
+
+    c8.chip8_regs.PC = 0x208;
+    EXPECT_EQ(CHIP8_IDLE_HALT, chip8_idle_state(&c8));
+    c8.chip8_regs.PC = 0x20A;
+    EXPECT_EQ(CHIP8_IDLE_NONE, chip8_idle_state(&c8));
+    chip8_destroy(&c8);
+}
+
+TEST(Chip8, IdleSkipMatchesPlainExecution) {
+    static struct Chip8 fast, slow;
+    const uint16_t prog[] = {
+        0x6005, 0xF015,           // 0x200: LD V0,5; LD DT,V0
+        0xF107, 0x3100, 0x1204,   // 0x204: LD V1,DT; SE V1,0; JP 0x204
+        0x62AA, 0xF30A,           // 0x20A: LD V2,0xAA; LD V3,K
+        0x7401, 0x1210,           // 0x20E: ADD V4,1; JP 0x210
+    };
+    load_program(fast, prog, 9);
+    load_program(slow, prog, 9);
+    slow.chip8_skip_idle = false;
+
+    for (int frame = 0; frame < 30; ++frame) {
+        if (frame == 12) {
+            ASSERT_EQ(CHIP8_OK, keyboard_press(&fast.chip8_kbd, 0x7));
+            ASSERT_EQ(CHIP8_OK, keyboard_press(&slow.chip8_kbd, 0x7));
+        }
+        uint32_t ran_fast = 0, ran_slow = 0;
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&fast, 7, &ran_fast));   // 7: loops end mid-frame
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&slow, 7, &ran_slow));
+        ASSERT_EQ(ran_slow, ran_fast);
+        ASSERT_EQ(slow.chip8_regs.PC, fast.chip8_regs.PC) << "frame " << frame;
+        ASSERT_EQ(slow.chip8_regs.DT, fast.chip8_regs.DT);
+        ASSERT_EQ(0, std::memcmp(slow.chip8_regs.V, fast.chip8_regs.V, NUM_REGS)) << "frame " << frame;
+    }
+    EXPECT_EQ(0x210, fast.chip8_regs.PC);
+    EXPECT_EQ(0x7, fast.chip8_regs.V[3]);
+    EXPECT_EQ(1, fast.chip8_regs.V[4]);
+    EXPECT_GT(fast.chip8_idle_cycles, 100u);
+    EXPECT_EQ(0u, slow.chip8_idle_cycles);
+    chip8_destroy(&fast);
+    chip8_destroy(&slow);
+}
+
+TEST(Chip8, RunBlocksHandlesLongLoadsAndHighCode) {
+    static struct Chip8 a, b;
+    const uint16_t prog[] = {
+        0xF000, 0x2000,  // 0x200: LD I, long 0x2000
+        0x6012,          // 0x204: LD V0, 0x12
+        0x3012,          // 0x206: SE V0, 0x12 -> skips all of the next F000 nnnn
+        0xF000, 0xDEAD,  // 0x208
+        0x0000,          // 0x20C: (skipped to here) SYS: no-op
+        0x2300,          // 0x20E: CALL 0x300
+        0x120E,          // 0x210: JP 0x20E (loop)
+    };
+    load_program(a, prog, sizeof(prog) / sizeof(prog[0]));
+    load_program(b, prog, sizeof(prog) / sizeof(prog[0]));
+    // 0x300: LD V1, 0x77; JP via B: V0 + 0xFEE = 0x1000, outside the decode cache
+    const uint16_t tramp[] = { 0x6177, 0xBFEE };
+    const uint16_t high[]  = { 0x7201, 0x00EE };   // 0x1000: ADD V2, 1; RET
+    for (struct Chip8* c : { &a, &b }) {
+        for (size_t i = 0; i < 2; ++i) {
+            ASSERT_EQ(CHIP8_OK, memory_write(&c->chip8_mem, 0x300 + 2 * i,     (uint8_t)(tramp[i] >> 8)));
+            ASSERT_EQ(CHIP8_OK, memory_write(&c->chip8_mem, 0x300 + 2 * i + 1, (uint8_t)(tramp[i] & 0xFF)));
+            ASSERT_EQ(CHIP8_OK, memory_write(&c->chip8_mem, 0x1000 + 2 * i,     (uint8_t)(high[i] >> 8)));
+            ASSERT_EQ(CHIP8_OK, memory_write(&c->chip8_mem, 0x1000 + 2 * i + 1, (uint8_t)(high[i] & 0xFF)));
+        }
+    }
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&a, 200, &ran));
+    EXPECT_EQ(200u, ran);
+    for (int i = 0; i < 200; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&b));
+
+    EXPECT_EQ(0x2000, a.chip8_regs.I);
+    EXPECT_EQ(b.chip8_regs.PC, a.chip8_regs.PC);
+    EXPECT_EQ(0, memcmp(a.chip8_regs.V, b.chip8_regs.V, sizeof(a.chip8_regs.V)));
+    EXPECT_GT(a.chip8_regs.V[2], 0);
+}
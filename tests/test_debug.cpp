@@ -0,0 +1,228 @@
+// tests/test_debug.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "chip8.h"
+#include "debug.h"
+#include "regs.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+#include "test_util.h"
+
+/* 0x200: count V1 up; every 256th pass falls through to a store of V0..V3 at 0x300. */
+static const uint16_t kProg[] = {
+    0x7101,   // 0x200: ADD V1, 1
+    0x7203,   // 0x202: ADD V2, 3
+    0x3100,   // 0x204: SE  V1, 0
+    0x1200,   // 0x206: JP  0x200
+    0x7301,   // 0x208: ADD V3, 1
+    0xA300,   // 0x20A: LD  I, 0x300
+    0xF355,   // 0x20C: LD  [I], V0..V3
+    0x1200,   // 0x20E: JP  0x200
+};
+
+TEST(Debug, BreakpointsNotHitLeaveTheRunUnchanged) {
+    static struct Chip8 plain, debugged;
+    static Debugger d;
+    load_program(plain, kProg, 0);
+    load_program(debugged, kProg, 0);
+    debug_init(&d);
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x210, nullptr));   // never reached
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x202, nullptr));
+    const DebugCond never = { 1, DEBUG_CMP_GT, 0x100 };
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x202, &never));   // replaces the unconditional one
+    EXPECT_EQ(2u, d.break_count);
+
+    for (int chunk = 0; chunk < 100; ++chunk) {
+        uint32_t a = 0, b = 0;
+        DebugEvent ev;
+        ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&plain, 997, &a));
+        ASSERT_EQ(CHIP8_OK, debug_run(&d, &debugged, 997, &b, &ev));
+        ASSERT_EQ(a, b);
+        ASSERT_EQ(DEBUG_STOP_NONE, ev.reason);
+    }
+    EXPECT_EQ(plain.chip8_regs.PC, debugged.chip8_regs.PC);
+    EXPECT_EQ(0, memcmp(plain.chip8_regs.V, debugged.chip8_regs.V, sizeof(plain.chip8_regs.V)));
+    uint8_t x = 0, y = 0;
+    ASSERT_EQ(CHIP8_OK, memory_read(&plain.chip8_mem, 0x303, &x));
+    ASSERT_EQ(CHIP8_OK, memory_read(&debugged.chip8_mem, 0x303, &y));
+    EXPECT_EQ(x, y);
+    chip8_destroy(&plain);
+    chip8_destroy(&debugged);
+}
+
+TEST(Debug, StopsBeforeTheBreakpointAndResumesPastIt) {
+    static struct Chip8 c8;
+    static Debugger d;
+    load_program(c8, kProg, 0);
+    debug_init(&d);
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x208, nullptr));
+
+    uint32_t ran = 0;
+    DebugEvent ev;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 100000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_BREAK, ev.reason);
+    EXPECT_EQ(0x208, ev.pc);
+    EXPECT_EQ(0x208, c8.chip8_regs.PC);
+    EXPECT_EQ(0, c8.chip8_regs.V[3]);          // not executed yet
+    EXPECT_EQ(255u * 4u + 3u, ran);
+
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 100000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_BREAK, ev.reason);
+    EXPECT_EQ(1, c8.chip8_regs.V[3]);
+    EXPECT_EQ(4u + 256u * 4u - 1u, ran);       // the store pass, then 256 counting passes
+
+    EXPECT_TRUE(debug_clear_break(&d, 0x208));
+    EXPECT_FALSE(debug_clear_break(&d, 0x208));
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 10000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_NONE, ev.reason);
+    EXPECT_EQ(10000u, ran);
+    chip8_destroy(&c8);
+}
+
+TEST(Debug, ConditionalBreakpoint) {
+    static struct Chip8 c8;
+    static Debugger d;
+    load_program(c8, kProg, 0);
+    debug_init(&d);
+    const DebugCond cond = { 1, DEBUG_CMP_EQ, 5 };   // V1 == 5
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x202, &cond));
+
+    uint32_t ran = 0;
+    DebugEvent ev;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 100000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_BREAK, ev.reason);
+    EXPECT_EQ(5, c8.chip8_regs.V[1]);
+    EXPECT_EQ(12, c8.chip8_regs.V[2]);
+    EXPECT_EQ(4u * 4u + 1u, ran);
+
+    const DebugCond on_i = { DEBUG_REG_I, DEBUG_CMP_GE, 0x300 };
+    EXPECT_FALSE(debug_cond_holds(&c8, &on_i));
+    c8.chip8_regs.I = 0x300;
+    EXPECT_TRUE(debug_cond_holds(&c8, &on_i));
+    chip8_destroy(&c8);
+}
+
+TEST(Debug, WatchpointsStopBeforeTheAccess) {
+    static struct Chip8 c8;
+    static Debugger d;
+    load_program(c8, kProg, 0);
+    debug_init(&d);
+    ASSERT_EQ(CHIP8_OK, debug_watch(&d, 0x302, 1, DEBUG_WATCH_READ, true));
+
+    uint32_t ran = 0;
+    DebugEvent ev;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 5000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_NONE, ev.reason);        // Fx55 writes, it does not read
+
+    ASSERT_EQ(CHIP8_OK, debug_watch(&d, 0x302, 2, DEBUG_WATCH_WRITE, true));
+    EXPECT_EQ(2u, d.watch_count);
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 5000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_WATCH_WRITE, ev.reason);
+    EXPECT_EQ(0x20C, ev.pc);
+    EXPECT_EQ(0x302, ev.addr);
+    EXPECT_EQ(0x20C, c8.chip8_regs.PC);
+    uint8_t v = 0xAA;
+    ASSERT_EQ(CHIP8_OK, memory_read(&c8.chip8_mem, 0x303, &v));
+    const uint8_t before = v;
+
+    // resuming executes the store
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 1, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_NONE, ev.reason);
+    ASSERT_EQ(CHIP8_OK, memory_read(&c8.chip8_mem, 0x303, &v));
+    EXPECT_EQ(c8.chip8_regs.V[3], v);
+    EXPECT_NE(before, v);
+
+    ASSERT_EQ(CHIP8_OK, debug_watch(&d, 0x300, 4, DEBUG_WATCH_READ | DEBUG_WATCH_WRITE, false));
+    EXPECT_EQ(0u, d.watch_count);
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, debug_watch(&d, 0xFFFF, 2, DEBUG_WATCH_READ, true));
+    chip8_destroy(&c8);
+}
+
+TEST(Debug, SpriteReadsAreWatched) {
+    static struct Chip8 c8;
+    static Debugger d;
+    const uint16_t prog[] = {
+        0xA400,   // 0x200: LD  I, 0x400
+        0xD015,   // 0x202: DRW V0, V1, 5   (reads 0x400..0x404)
+        0x1204,   // 0x204: JP  0x204
+    };
+    load_program(c8, prog, 0);
+    debug_init(&d);
+    ASSERT_EQ(CHIP8_OK, debug_watch(&d, 0x404, 1, DEBUG_WATCH_READ, true));
+
+    uint32_t ran = 0;
+    DebugEvent ev;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 1000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_WATCH_READ, ev.reason);
+    EXPECT_EQ(0x202, ev.pc);
+    EXPECT_EQ(0x404, ev.addr);
+    EXPECT_EQ(1u, ran);
+
+    // past the draw, the halt loop is fast-forwarded as in chip8_run_blocks
+    ASSERT_EQ(CHIP8_OK, debug_watch(&d, 0x404, 1, DEBUG_WATCH_READ, false));
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x300, nullptr));
+    const uint64_t idle = c8.chip8_idle_cycles;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 1000000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_NONE, ev.reason);
+    EXPECT_EQ(1000000u, ran);
+    EXPECT_GT(c8.chip8_idle_cycles - idle, 900000u);
+    chip8_destroy(&c8);
+}
+
+/* 0x200: a five-instruction block ending in JP back to its start. */
+static const uint16_t kBlock[] = {
+    0x6001,   // 0x200: LD V0, 1
+    0x6102,   // 0x202: LD V1, 2
+    0x6203,   // 0x204: LD V2, 3
+    0x6304,   // 0x206: LD V3, 4
+    0x1200,   // 0x208: JP 0x200
+};
+
+TEST(Debug, OddBitsInsideABlockStopNothing) {
+    static struct Chip8 plain, marked;
+    static uint64_t map[DEBUG_MAP_WORDS];
+    load_program(plain, kBlock, 0);
+    load_program(marked, kBlock, 0);
+    std::memset(map, 0, sizeof(map));
+    map[0x203 >> 6] |= 1ull << (0x203 & 63u);   // no instruction starts there
+
+    uint32_t a = 0, b = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&plain, 1003, &a));
+    ASSERT_EQ(CHIP8_OK, chip8_run_until(&marked, 1003, map, &b));
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(plain.chip8_regs.PC, marked.chip8_regs.PC);
+
+    static Debugger d;
+    debug_init(&d);
+    EXPECT_EQ(CHIP8_ERR_DEBUG_ODD_ADDR, debug_set_break(&d, 0x203, nullptr));
+    EXPECT_EQ(0u, d.break_count);
+    EXPECT_FALSE(debug_has_break(&d, 0x203));
+    chip8_destroy(&plain);
+    chip8_destroy(&marked);
+}
+
+TEST(Debug, BreakpointJustPastTheBlockIsNotReached) {
+    static struct Chip8 c8;
+    static Debugger d;
+    load_program(c8, kBlock, 0);
+    debug_init(&d);
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x20A, nullptr));
+
+    uint32_t ran = 0;
+    DebugEvent ev;
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 1003, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_NONE, ev.reason);
+    EXPECT_EQ(1003u, ran);
+    EXPECT_EQ(0x206, c8.chip8_regs.PC);   // 200 passes, then three instructions
+
+    // the block's last instruction stops it
+    ASSERT_EQ(CHIP8_OK, debug_set_break(&d, 0x208, nullptr));
+    ASSERT_EQ(CHIP8_OK, debug_run(&d, &c8, 1000, &ran, &ev));
+    EXPECT_EQ(DEBUG_STOP_BREAK, ev.reason);
+    EXPECT_EQ(0x208, c8.chip8_regs.PC);
+    EXPECT_EQ(1u, ran);
+    chip8_destroy(&c8);
+}
@@ -0,0 +1,87 @@
+// tests/test_disasm.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include "disasm.h"
+#include "instr.h"
+#include "mem.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+static std::string dis(uint16_t op) {
+    char buf[INSTR_DISASM_MAX];
+    const size_t n = instr_disasm(op, buf, sizeof(buf));
+    EXPECT_EQ(std::strlen(buf), n);
+    return buf;
+}
+
+TEST(Disasm, FormatsOperands) {
+    EXPECT_EQ("CLS",               dis(0x00E0));
+    EXPECT_EQ("SYS 0x123",         dis(0x0123));
+    EXPECT_EQ("JP 0x2DE",          dis(0x12DE));
+    EXPECT_EQ("LD V3, 0x2A",       dis(0x632A));
+    EXPECT_EQ("SNE VA, VB",        dis(0x9AB0));
+    EXPECT_EQ("SHL V1, V2",        dis(0x812E));
+    EXPECT_EQ("DRW V1, V2, 15",    dis(0xD12F));
+    EXPECT_EQ("LD [I], V3-V5",     dis(0x5352));
+    EXPECT_EQ("LD VF, [I]",        dis(0xFF65));
+    EXPECT_EQ("SCD 4",             dis(0x00C4));
+    EXPECT_EQ("PLANE 3",           dis(0xF301));
+    EXPECT_EQ("DW 0x8128",         dis(0x8128));
+}
+
+TEST(Disasm, EveryOpcodeFitsAndMatchesItsKind) {
+    char buf[INSTR_DISASM_MAX];
+    for (uint32_t op = 0; op <= 0xFFFF; ++op) {
+        const size_t n = instr_disasm((uint16_t)op, buf, sizeof(buf));
+        ASSERT_LT(n, sizeof(buf)) << std::hex << op;
+        // the mnemonic word is the kind's, e.g. "LD" for "LD Vx, byte"
+        const char* name = instr_kind_name(instr_kind((uint16_t)op));
+        if (std::strcmp(name, "???") != 0) {
+            const size_t word = std::strcspn(name, " ");
+            ASSERT_EQ(0, std::strncmp(name, buf, word)) << std::hex << op;
+        }
+    }
+}
+
+TEST(Disasm, TruncatesLikeSnprintf) {
+    char buf[6];
+    EXPECT_EQ(11u, instr_disasm(0x632A, buf, sizeof(buf)));
+    EXPECT_STREQ("LD V3", buf);
+    EXPECT_EQ(11u, instr_disasm(0x632A, nullptr, 0));
+}
+
+TEST(Disasm, ListsRangeWithLongLoadsAndTrailingByte) {
+    static Memory m;
+    memory_init(&m);
+    const uint8_t prog[] = { 0x00, 0xE0, 0xF0, 0x00, 0x12, 0x34, 0x12, 0x00, 0xAB };
+    for (size_t i = 0; i < sizeof(prog); ++i) {
+        ASSERT_EQ(CHIP8_OK, memory_write(&m, (uint16_t)(PROGRAM_START_ADDRESS + i), prog[i]));
+    }
+
+    char buf[512];
+    size_t next = 0;
+    const size_t n = disasm_range(&m, PROGRAM_START_ADDRESS, sizeof(prog), buf, sizeof(buf), &next);
+    EXPECT_EQ(std::strlen(buf), n);
+    EXPECT_EQ(PROGRAM_START_ADDRESS + sizeof(prog), next);
+    EXPECT_STREQ("0x200: 00E0       CLS\n"
+                 "0x202: F000 1234  LD I, 0x1234\n"
+                 "0x206: 1200       JP 0x200\n"
+                 "0x208: AB         DB 0xAB\n", buf);
+
+    // a short buffer stops at a line boundary and says where to resume
+    char small[40];
+    disasm_range(&m, PROGRAM_START_ADDRESS, sizeof(prog), small, sizeof(small), &next);
+    EXPECT_STREQ("0x200: 00E0       CLS\n", small);
+    EXPECT_EQ(0x202u, next);
+
+    char line[DISASM_LINE_MAX];
+    size_t len = 0;
+    EXPECT_EQ(4u, disasm_line(&m, 0x202, line, &len));
+    EXPECT_STREQ("0x202: F000 1234  LD I, 0x1234", line);
+    EXPECT_EQ(std::strlen(line), len);
+    memory_release(&m);
+}
@@ -1,5 +1,6 @@
 // tests/test_instr.cpp
 #include <gtest/gtest.h>
+#include <cstring>
 
 extern "C" {
 #include "instr.h"
@@ -9,6 +10,7 @@ extern "C" {
 #include "chip8_status.h"
 #include "config.h"
 #include "keyboard.h"
+#include "rng.h"
 }
 
 static void prestep_and_exec(uint16_t opcode,
@@ -209,14 +211,34 @@ TEST(Instr, RandomMasked) {
     Keyboard kbd{};
     Registers r{}; r.PC = 0x200;
 
-    srand(12345);
-    // Compute expected using same expression
-    uint8_t expected = (uint8_t)((rand() & 0xFF) & 0x3C);
+    rng_seed(&r.rng, 12345);
+    // Compute expected from a copy of the same per-instance generator
+    Rng copy = r.rng;
+    uint8_t expected = (uint8_t)((rng_next(&copy) & 0xFF) & 0x3C);
 
-    // reset seed so exec sees the same next rand()
-    srand(12345);
     prestep_and_exec(0xC13C, r, m, s, stk, kbd); // RND V1, 0x3C
     EXPECT_EQ(expected, r.V[1]);
+    EXPECT_EQ(copy.state, r.rng.state);          // consumed exactly one draw
+}
+
+/* Same seed -> same sequence; the libc rand() state is never touched. */
+TEST(Instr, RandomIsPerInstanceAndSeedable) {
+    Memory m{};  memory_init(&m);
+    Screen s{};  screen_init(&s);
+    Stack  stk{};
+    Keyboard kbd{};
+    Registers a{}, b{}, c{};
+    rng_seed(&a.rng, 7); rng_seed(&b.rng, 7); rng_seed(&c.rng, 8);
+
+    bool differs = false;
+    for (int i = 0; i < 32; ++i) {
+        prestep_and_exec(0xC1FF, a, m, s, stk, kbd);
+        prestep_and_exec(0xC1FF, b, m, s, stk, kbd);
+        prestep_and_exec(0xC1FF, c, m, s, stk, kbd);
+        ASSERT_EQ(a.V[1], b.V[1]) << "draw " << i;
+        differs = differs || (a.V[1] != c.V[1]);
+    }
+    EXPECT_TRUE(differs);
 }
 
 /* ---------- Fx07 / Fx15 / Fx18 ---------- */
@@ -308,6 +330,25 @@ TEST(Instr, BulkStoreAndLoadWithIIncrement) {
     EXPECT_EQ((uint16_t)(0x360 + 8), r.I); // I advanced another 4
 }
 
+TEST(Instr, BulkStoreOutOfRangeStoresNothing) {
+    Memory m{};  memory_init(&m);
+    Screen s{};  screen_init(&s);
+    Stack  stk{};
+    Keyboard kbd{};
+    Registers r{}; r.PC = 0x200;
+    for (int i = 0; i < NUM_REGS; ++i) r.V[i] = (uint8_t)(0x40 + i);
+    r.I = (uint16_t)(MEMORY_SIZE - 2);
+
+    prestep_and_exec(0xF355, r, m, s, stk, kbd);   // V0..V3 would run past the end
+    EXPECT_EQ(0, memory_peek(&m, MEMORY_SIZE - 2));
+    EXPECT_EQ(0, memory_peek(&m, MEMORY_SIZE - 1));
+    EXPECT_EQ((uint16_t)(MEMORY_SIZE - 2), r.I);
+
+    prestep_and_exec(0xF365, r, m, s, stk, kbd);
+    EXPECT_EQ(0x40, r.V[0]);
+    EXPECT_EQ((uint16_t)(MEMORY_SIZE - 2), r.I);
+}
+
 /* ---------- Fx0A: wait for key ---------- */
 TEST(Instr, Fx0A_WaitsWhenNoKey) {
     Memory m{}; memory_init(&m);
@@ -333,3 +374,189 @@ TEST(Instr, Fx0A_StoresKeyAndProceeds) {
     EXPECT_EQ(0x202, r.PC);
     EXPECT_EQ(0x0C, r.V[0]);
 }
+
+/* ---------- SUPER-CHIP ---------- */
+TEST(Instr, SCHIP_ModeSwitchAndBigSprite) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    prestep_and_exec(0x00FF, r, m, s, st, k);            // HIGH
+    EXPECT_TRUE(s.hires);
+    EXPECT_EQ(HIRES_WIDTH, screen_width(&s));
+
+    for (uint16_t a = 0x300; a < 0x320; ++a) ASSERT_EQ(CHIP8_OK, memory_write(&m, a, 0xFF));
+    r.I = 0x300; r.V[1] = 120; r.V[2] = 60;
+    prestep_and_exec(0xD120, r, m, s, st, k);            // DRW V1, V2, 0 -> 16x16
+    EXPECT_EQ(0, r.V[0xF]);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 127, 63));
+    EXPECT_EQ(1u, screen_get_pixel(&s, 7, 11));          // wrapped both ways
+    EXPECT_EQ(0u, screen_get_pixel(&s, 8, 11));
+    prestep_and_exec(0xD120, r, m, s, st, k);
+    EXPECT_EQ(1, r.V[0xF]);
+
+    prestep_and_exec(0x00FE, r, m, s, st, k);            // LOW
+    EXPECT_FALSE(s.hires);
+    EXPECT_EQ(0x208, r.PC);
+}
+
+TEST(Instr, SCHIP_ScrollOpcodes) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    const uint8_t dot[1] = {0x80};
+    (void)screen_draw_sprite(&s, 20, 3, dot, 1);
+    prestep_and_exec(0x00C2, r, m, s, st, k);            // SCD 2
+    prestep_and_exec(0x00FB, r, m, s, st, k);            // SCR (4 px)
+    EXPECT_EQ(1u, screen_get_pixel(&s, 24, 5));
+    prestep_and_exec(0x00FC, r, m, s, st, k);            // SCL (4 px)
+    prestep_and_exec(0x00FC, r, m, s, st, k);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 16, 5));
+    EXPECT_EQ(0u, screen_get_pixel(&s, 24, 5));
+}
+
+TEST(Instr, SCHIP_BigFontAndFlags) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    r.V[4] = 0x17;                                       // low nibble selects digit 7
+    prestep_and_exec(0xF430, r, m, s, st, k);            // LD HF, V4
+    EXPECT_EQ(BIG_FONT_START_ADDR + 7 * BIG_SPRITE_HEIGHT, r.I);
+    uint8_t glyph[BIG_SPRITE_HEIGHT] = {};
+    memory_read_block(&m, r.I, glyph, sizeof(glyph));
+    EXPECT_NE(0, glyph[0]);
+
+    for (uint8_t i = 0; i < 8; ++i) r.V[i] = (uint8_t)(0x10 + i);
+    prestep_and_exec(0xF575, r, m, s, st, k);            // LD R, V5: V0..V5
+    for (uint8_t i = 0; i < 8; ++i) r.V[i] = 0;
+    prestep_and_exec(0xF785, r, m, s, st, k);            // LD V7, R
+    EXPECT_EQ(0x10, r.V[0]);
+    EXPECT_EQ(0x15, r.V[5]);
+    EXPECT_EQ(0x00, r.V[6]);                             // never stored
+}
+
+TEST(Instr, SCHIP_ExitParksPC) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x240;
+
+    prestep_and_exec(0x00FD, r, m, s, st, k);
+    EXPECT_EQ(0x240, r.PC);
+}
+
+/* ---------- XO-CHIP ---------- */
+TEST(Instr, XO_LongLoadAndSkipOverIt) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    const uint8_t code[] = { 0xF0, 0x00, 0xBE, 0xEF };   // 0x200: LD I, long 0xBEEF
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&m, 0x200, code, sizeof(code)));
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&m, 0x302, code, sizeof(code)));
+
+    prestep_and_exec(0xF000, r, m, s, st, k);
+    EXPECT_EQ(0xBEEF, r.I);
+    EXPECT_EQ(0x204, r.PC);
+
+    // A taken skip steps over all four bytes of F000 nnnn, others over two.
+    r.PC = 0x300; r.V[1] = 7;
+    prestep_and_exec(0x3107, r, m, s, st, k);            // SE V1, 7 -> skips the long load
+    EXPECT_EQ(0x306, r.PC);
+    r.PC = 0x306;
+    prestep_and_exec(0x3107, r, m, s, st, k);            // next word is 0000
+    EXPECT_EQ(0x30A, r.PC);
+}
+
+TEST(Instr, XO_RangeStoreAndLoad) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    for (uint8_t i = 0; i < NUM_REGS; ++i) r.V[i] = (uint8_t)(0x40 + i);
+    r.I = 0xE000;                                        // above the classic 4 KB
+    prestep_and_exec(0x5242, r, m, s, st, k);            // LD [I], V2-V4
+    EXPECT_EQ(0xE000, r.I);                              // I unchanged
+    EXPECT_EQ(0x42, memory_peek(&m, 0xE000));
+    EXPECT_EQ(0x44, memory_peek(&m, 0xE002));
+
+    r.I = 0xE010;
+    prestep_and_exec(0x5422, r, m, s, st, k);            // LD [I], V4-V2: descending
+    EXPECT_EQ(0x44, memory_peek(&m, 0xE010));
+    EXPECT_EQ(0x42, memory_peek(&m, 0xE012));
+
+    r.I = 0xE000;
+    prestep_and_exec(0x5A83, r, m, s, st, k);            // LD VA-V8, [I]
+    EXPECT_EQ(0x42, r.V[0xA]);
+    EXPECT_EQ(0x43, r.V[0x9]);
+    EXPECT_EQ(0x44, r.V[0x8]);
+
+    r.I = 0xFFFF;                                        // range runs past RAM end: nothing happens
+    prestep_and_exec(0x5012, r, m, s, st, k);
+    EXPECT_EQ(0, memory_peek(&m, 0xFFFF));
+}
+
+TEST(Instr, XO_PlanesDrawScrollAndClear) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    const uint8_t sprite[2] = { 0x80, 0xC0 };            // plane 1 image, then plane 2's
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&m, 0x300, sprite, sizeof(sprite)));
+    r.I = 0x300; r.V[0] = 4; r.V[1] = 4;
+
+    prestep_and_exec(0xF301, r, m, s, st, k);            // PLANE 3
+    prestep_and_exec(0xD011, r, m, s, st, k);            // one row per plane
+    EXPECT_EQ(3u, screen_get_color(&s, 4, 4));
+    EXPECT_EQ(2u, screen_get_color(&s, 5, 4));
+    EXPECT_EQ(0, r.V[0xF]);
+
+    prestep_and_exec(0xF201, r, m, s, st, k);            // PLANE 2
+    prestep_and_exec(0x00D2, r, m, s, st, k);            // SCU 2: plane 2 only
+    EXPECT_EQ(1u, screen_get_color(&s, 4, 4));
+    EXPECT_EQ(2u, screen_get_color(&s, 4, 2));
+    prestep_and_exec(0x00E0, r, m, s, st, k);            // CLS clears plane 2 only
+    EXPECT_EQ(1u, screen_get_color(&s, 4, 4));
+    EXPECT_EQ(0u, screen_get_color(&s, 4, 2));
+
+    prestep_and_exec(0xF001, r, m, s, st, k);            // PLANE 0: drawing is a no-op
+    prestep_and_exec(0xD011, r, m, s, st, k);
+    EXPECT_EQ(1u, screen_get_color(&s, 4, 4));
+    EXPECT_EQ(0, r.V[0xF]);
+}
+
+TEST(Instr, XO_AudioPatternAndPitch) {
+    Memory m{}; memory_init(&m);
+    Screen s{}; screen_init(&s);
+    Stack  st{};
+    Keyboard k{};
+    Registers r{}; r.PC = 0x200;
+
+    uint8_t pattern[AUDIO_PATTERN_BYTES];
+    for (size_t i = 0; i < sizeof(pattern); ++i) pattern[i] = (uint8_t)(0xF0 ^ i);
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&m, 0x8000, pattern, sizeof(pattern)));
+
+    r.I = 0x8000;
+    prestep_and_exec(0xF002, r, m, s, st, k);            // AUDIO
+    EXPECT_TRUE(r.has_pattern);
+    EXPECT_EQ(0, memcmp(pattern, r.pattern, sizeof(pattern)));
+
+    r.V[6] = 112;
+    prestep_and_exec(0xF63A, r, m, s, st, k);            // PITCH V6
+    EXPECT_EQ(112, r.pitch);
+}
@@ -1,5 +1,7 @@
 // tests/test_mem.cpp
 #include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
 
 extern "C" {
 #include "mem.h"
@@ -12,8 +14,8 @@ TEST(Memory, InitClearsAndLoadsFont) {
     memory_init(&m);  // void API
 
     // 1) Region before program start is zeroed (spot checks)
-    EXPECT_EQ(0u, m.memory[0]);
-    EXPECT_EQ(0u, m.memory[PROGRAM_START_ADDRESS - 1]);
+    EXPECT_EQ(0u, memory_peek(&m, 0));
+    EXPECT_EQ(0u, memory_peek(&m, PROGRAM_START_ADDRESS - 1));
 
     // 2) Fontset content check: 16 glyphs × 5 bytes = 80 bytes
     static const uint8_t expected_font[80] = {
@@ -29,7 +31,7 @@ TEST(Memory, InitClearsAndLoadsFont) {
 
     ASSERT_GE(MEMORY_SIZE, FONT_START_ADDR + 80);
     for (int i = 0; i < 80; ++i) {
-        EXPECT_EQ(expected_font[i], m.memory[FONT_START_ADDR + i]) << "mismatch at font byte " << i;
+        EXPECT_EQ(expected_font[i], memory_peek(&m, FONT_START_ADDR + i)) << "mismatch at font byte " << i;
     }
 }
 
@@ -37,15 +39,15 @@ TEST(Memory, ResetClearsAllBytes) {
     Memory m{};
     memory_init(&m);
     // Dirty a few locations
-    m.memory[0] = 0xAA;
-    m.memory[FONT_START_ADDR] = 0xBB;
-    m.memory[PROGRAM_START_ADDRESS] = 0xCC;
+    ASSERT_EQ(CHIP8_OK, memory_write(&m, 0, 0xAA));
+    ASSERT_EQ(CHIP8_OK, memory_write(&m, FONT_START_ADDR, 0xBB));
+    ASSERT_EQ(CHIP8_OK, memory_write(&m, PROGRAM_START_ADDRESS, 0xCC));
 
     memory_reset(&m);
 
     // After reset, everything should be zero
     for (int i = 0; i < MEMORY_SIZE; ++i) {
-        EXPECT_EQ(0u, m.memory[i]) << "non-zero at " << i;
+        EXPECT_EQ(0u, memory_peek(&m, i)) << "non-zero at " << i;
     }
 }
 
@@ -63,17 +65,28 @@ TEST(Memory, ReadWriteInsideBounds) {
 TEST(Memory, ReadOOBReturnsError) {
     Memory m{}; memory_init(&m);
 
+    // Every 16-bit address is RAM; only a block running past the end is OOB.
     uint8_t v = 0xEE;
-    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_read(&m, MEMORY_SIZE, &v));  // exactly one past the end
-    EXPECT_EQ(0xEE, v); // API shall NOT change param on OOB
+    EXPECT_EQ(CHIP8_OK, memory_read(&m, 0xFFFF, &v));
+    EXPECT_EQ(0u, v);
+
+    uint8_t two[2] = { 0xEE, 0xEE };
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_read_block(&m, 0xFFFF, two, sizeof(two)));
+    EXPECT_EQ(0xEE, two[0]); // API shall NOT change param on OOB
 }
 
 TEST(Memory, WriteOOBReturnsError) {
     Memory m{}; memory_init(&m);
 
-    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_write(&m, MEMORY_SIZE, 0xFF));
-    // Neighboring last valid byte should remain unchanged (still zero)
-    EXPECT_EQ(0u, m.memory[MEMORY_SIZE - 1]);
+    EXPECT_EQ(CHIP8_OK, memory_write(&m, 0xFFFF, 0x5A));
+    EXPECT_EQ(0x5A, memory_peek(&m, 0xFFFF));
+
+    const uint8_t three[3] = { 0xFF, 0xFF, 0xFF };
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_write_block(&m, 0xFFFE, three, sizeof(three)));
+    // Neighboring last valid bytes should remain unchanged
+    EXPECT_EQ(0u, memory_peek(&m, MEMORY_SIZE - 2));
+    EXPECT_EQ(0x5A, memory_peek(&m, MEMORY_SIZE - 1));
+    memory_release(&m);
 }
 
 TEST(Memory, LoadRomOkAndTooLarge) {
@@ -84,7 +97,7 @@ TEST(Memory, LoadRomOkAndTooLarge) {
 
     // Verify payload placed at PROGRAM_START_ADDRESS
     for (size_t i = 0; i < sizeof(rom); ++i) {
-        EXPECT_EQ(rom[i], m.memory[PROGRAM_START_ADDRESS + i]) << "mismatch at rom byte " << i;
+        EXPECT_EQ(rom[i], memory_peek(&m, PROGRAM_START_ADDRESS + i)) << "mismatch at rom byte " << i;
     }
 
     // Oversized ROM should return error and not write past capacity
@@ -92,3 +105,83 @@ TEST(Memory, LoadRomOkAndTooLarge) {
     std::vector<uint8_t> big(too_big, 0xEE);
     EXPECT_EQ(CHIP8_ERR_ROM_TOO_LARGE, memory_load_rom(&m, big.data(), big.size()));
 }
+
+TEST(Memory, BlockReadWriteAcrossPages) {
+    Memory m{}; memory_init(&m);
+
+    uint8_t src[MEM_PAGE_SIZE + 10];
+    for (size_t i = 0; i < sizeof(src); ++i) src[i] = (uint8_t)(i * 7 + 1);
+    const uint16_t at = (uint16_t)(2 * MEM_PAGE_SIZE - 5);   // straddles three pages
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&m, at, src, sizeof(src)));
+
+    uint8_t back[sizeof(src)] = {};
+    ASSERT_EQ(CHIP8_OK, memory_read_block(&m, at, back, sizeof(back)));
+    EXPECT_EQ(0, memcmp(src, back, sizeof(src)));
+
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_write_block(&m, MEMORY_SIZE - 1, src, 2));
+    EXPECT_EQ(CHIP8_ERR_MEM_OOB, memory_read_block(&m, MEMORY_SIZE - 1, back, 2));
+    memory_release(&m);
+}
+
+static int g_hook_calls = 0;
+static void count_hook(void*, uint16_t, size_t) { ++g_hook_calls; }
+
+TEST(Memory, FastPathsAreAllOrNothing) {
+    Memory m{}; memory_init(&m);
+    memory_set_write_hook(&m, count_hook, nullptr);
+    g_hook_calls = 0;
+
+    const uint8_t src[4] = { 1, 2, 3, 4 };
+    const uint16_t at = (uint16_t)(MEM_PAGE_SIZE - 2);   // straddles two pages
+    ASSERT_TRUE(memory_store_fast(&m, at, src, sizeof(src)));
+    EXPECT_EQ(1, g_hook_calls);
+
+    // Same bytes again: no page copy, no invalidation.
+    ASSERT_TRUE(memory_store_fast(&m, 0x300, src, sizeof(src)));
+    ASSERT_TRUE(memory_store_fast(&m, 0x300, src, sizeof(src)));
+    EXPECT_EQ(2, g_hook_calls);
+
+    uint8_t back[4] = {};
+    ASSERT_TRUE(memory_load_fast(&m, at, back, sizeof(back)));
+    EXPECT_EQ(0, memcmp(src, back, sizeof(src)));
+
+    // Out of range: nothing read or written, not even the bytes that fit.
+    uint8_t keep[4] = { 0xEE, 0xEE, 0xEE, 0xEE };
+    EXPECT_FALSE(memory_load_fast(&m, MEMORY_SIZE - 2, keep, sizeof(keep)));
+    EXPECT_EQ(0xEE, keep[0]);
+    EXPECT_FALSE(memory_store_fast(&m, MEMORY_SIZE - 2, src, sizeof(src)));
+    EXPECT_EQ(0, memory_peek(&m, MEMORY_SIZE - 2));
+    EXPECT_EQ(2, g_hook_calls);
+    memory_release(&m);
+}
+
+TEST(Memory, ForkSharesPagesCopyOnWrite) {
+    Memory a{}; memory_init(&a);
+    ASSERT_EQ(CHIP8_OK, memory_write(&a, PROGRAM_START_ADDRESS, 0x11));
+
+    Memory b{};
+    memory_fork(&b, &a);
+    for (size_t i = 0; i < MEM_PAGE_COUNT; ++i) EXPECT_EQ(a.pages[i], b.pages[i]);
+    EXPECT_EQ(0x11, memory_peek(&b, PROGRAM_START_ADDRESS));
+
+    // Writing one side duplicates only the touched page.
+    ASSERT_EQ(CHIP8_OK, memory_write(&b, PROGRAM_START_ADDRESS, 0x22));
+    EXPECT_EQ(0x11, memory_peek(&a, PROGRAM_START_ADDRESS));
+    EXPECT_EQ(0x22, memory_peek(&b, PROGRAM_START_ADDRESS));
+    const size_t page = PROGRAM_START_ADDRESS >> MEM_PAGE_SHIFT;
+    for (size_t i = 0; i < MEM_PAGE_COUNT; ++i) {
+        if (i == page) EXPECT_NE(a.pages[i], b.pages[i]);
+        else           EXPECT_EQ(a.pages[i], b.pages[i]);
+    }
+
+    // A block write with identical contents keeps pages shared.
+    uint8_t same[MEM_PAGE_SIZE] = {};
+    ASSERT_EQ(CHIP8_OK, memory_write_block(&b, 3 * MEM_PAGE_SIZE, same, sizeof(same)));
+    EXPECT_EQ(a.pages[3], b.pages[3]);
+
+    // Parent released first: the fork still owns valid pages.
+    memory_release(&a);
+    EXPECT_EQ(0x22, memory_peek(&b, PROGRAM_START_ADDRESS));
+    EXPECT_EQ(0xF0, memory_peek(&b, FONT_START_ADDR));
+    memory_release(&b);
+}
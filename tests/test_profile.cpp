@@ -0,0 +1,132 @@
+// tests/test_profile.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+extern "C" {
+#include "chip8.h"
+#include "profile.h"
+#include "instr.h"
+#include "mem.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+static void record(Profile& p, uint16_t pc, uint16_t op, const Registers& regs, const Keyboard& kbd) {
+    Instr in{};
+    instr_decode(op, &in);
+    prof_record(&p, pc, &in, &regs, &kbd);
+}
+
+TEST(Profile, KindsShareDecode) {
+    EXPECT_EQ(INSTR_CLS, instr_kind(0x00E0));
+    EXPECT_EQ(INSTR_SYS, instr_kind(0x0123));
+    EXPECT_EQ(INSTR_SHL, instr_kind(0x812E));
+    EXPECT_EQ(INSTR_UNKNOWN, instr_kind(0x8128));
+    EXPECT_EQ(INSTR_UNKNOWN, instr_kind(0x5121));
+    EXPECT_EQ(INSTR_LD_KEY, instr_kind(0xF30A));
+    EXPECT_STREQ("LD Vx, DT", instr_kind_name(INSTR_LD_VX_DT));
+    EXPECT_STREQ("???", instr_kind_name(INSTR_KIND_COUNT));
+}
+
+TEST(Profile, CountsPerAddressAndKind) {
+    static Profile p;
+    prof_init(&p);
+    Registers regs{};
+    Keyboard kbd{};
+
+    for (int i = 0; i < 5; ++i) {
+        record(p, 0x200, 0x7001, regs, kbd);   // ADD V0, 1
+        record(p, 0x202, 0x1200, regs, kbd);   // JP 0x200
+    }
+    record(p, 0x300, 0x7105, regs, kbd);
+
+    EXPECT_EQ(11u, p.cycles);
+    EXPECT_EQ(5u, p.pc_count[0x200]);
+    EXPECT_EQ(5u, p.pc_count[0x202]);
+    EXPECT_EQ(6u, p.kind_count[INSTR_ADD_IMM]);
+    EXPECT_EQ(5u, p.kind_count[INSTR_JP]);
+}
+
+TEST(Profile, AccountsKeyAndDelayTimerWaits) {
+    static Profile p;
+    prof_init(&p);
+    Registers regs{};
+    Keyboard kbd{};
+
+    // Fx0A with nothing pressed waits; with a key down it does not.
+    record(p, 0x200, 0xF00A, regs, kbd);
+    record(p, 0x200, 0xF00A, regs, kbd);
+    keyboard_press(&kbd, 0x5);
+    record(p, 0x200, 0xF00A, regs, kbd);
+    EXPECT_EQ(2u, p.key_wait_cycles);
+
+    // Classic poll: LD V0, DT; SE V0, 0; JP back — 3 cycles per spin.
+    regs.DT = 4;
+    for (int spin = 0; spin < 4; ++spin) {
+        record(p, 0x210, 0xF007, regs, kbd);
+        record(p, 0x212, 0x3000, regs, kbd);
+        record(p, 0x214, 0x1210, regs, kbd);
+    }
+    EXPECT_EQ(9u, p.dt_wait_cycles);   // three gaps between four reads
+
+    regs.DT = 0;                        // loop exits; nothing more accrues
+    record(p, 0x210, 0xF007, regs, kbd);
+    regs.DT = 9;
+    record(p, 0x210, 0xF007, regs, kbd);
+    EXPECT_EQ(9u, p.dt_wait_cycles);
+}
+
+TEST(Profile, ReportListsHotSpotsWithDisassembly) {
+    static Profile p;
+    prof_init(&p);
+    Memory m{};
+    memory_init(&m);
+    ASSERT_EQ(CHIP8_OK, memory_write(&m, 0x2DE, 0x12));
+    ASSERT_EQ(CHIP8_OK, memory_write(&m, 0x2DF, 0xDE));
+    Registers regs{};
+    Keyboard kbd{};
+    for (int i = 0; i < 30; ++i) record(p, 0x2DE, 0x12DE, regs, kbd);
+    record(p, 0x200, 0x6001, regs, kbd);
+
+    FILE* f = std::tmpfile();
+    ASSERT_NE(nullptr, f);
+    prof_report(&p, &m, f, 1);
+    std::rewind(f);
+    std::string text;
+    char buf[256];
+    while (std::fgets(buf, sizeof(buf), f)) text += buf;
+    std::fclose(f);
+
+    EXPECT_NE(std::string::npos, text.find("31 cycles"));
+    EXPECT_NE(std::string::npos, text.find("0x2DE"));
+    EXPECT_NE(std::string::npos, text.find("12DE  JP 0x2DE"));
+    EXPECT_EQ(std::string::npos, text.find("0x200 "));   // only the top 1 address
+    memory_release(&m);
+}
+
+#ifdef CHIP8_PROFILE
+/* Block mode and single-stepping must attribute cycles identically. */
+TEST(Profile, InterpreterHooksMatchAcrossModes) {
+    static struct Chip8 a, b;
+    const uint16_t prog[] = { 0x6005, 0x7001, 0x4010, 0x1202, 0x1208 };
+    for (struct Chip8* c : { &a, &b }) {
+        chip8_init(c);
+        for (size_t i = 0; i < 5; ++i) {
+            memory_write(&c->chip8_mem, (uint16_t)(0x200 + 2 * i), (uint8_t)(prog[i] >> 8));
+            memory_write(&c->chip8_mem, (uint16_t)(0x201 + 2 * i), (uint8_t)prog[i]);
+        }
+        c->chip8_regs.PC = 0x200;
+    }
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&a, 100, &ran));
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(CHIP8_OK, chip8_step(&b));
+
+    EXPECT_EQ(100u, a.chip8_prof.cycles);
+    for (uint16_t pc = 0x200; pc < 0x20A; pc += 2) {
+        EXPECT_EQ(a.chip8_prof.pc_count[pc], b.chip8_prof.pc_count[pc]) << pc;
+    }
+    chip8_destroy(&a);
+    chip8_destroy(&b);
+}
+#endif
@@ -0,0 +1,141 @@
+// tests/test_quirks.cpp
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "chip8.h"
+#include "instr.h"
+#include "quirks.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+/* Decode `op` under `q` and run it with PC pre-incremented, as the core does. */
+static void exec_quirks(struct Chip8& c8, Chip8Quirks q, uint16_t op) {
+    Instr in;
+    instr_decode_quirks(op, q, &in);
+    c8.chip8_regs.PC = (uint16_t)(c8.chip8_regs.PC + 2);
+    in.fn(&in, &c8.chip8_regs, &c8.chip8_mem, &c8.chip8_disp, &c8.chip8_stack, &c8.chip8_kbd);
+}
+
+TEST(Quirks, NamesRoundTrip) {
+    for (int i = 0; i < CHIP8_QUIRKS_COUNT; ++i) {
+        Chip8Quirks q = CHIP8_QUIRKS_COUNT;
+        ASSERT_TRUE(quirks_from_name(quirks_profile((Chip8Quirks)i)->name, &q));
+        EXPECT_EQ(i, (int)q);
+    }
+    Chip8Quirks q = CHIP8_QUIRKS_VIP;
+    EXPECT_FALSE(quirks_from_name("cosmac", &q));
+    EXPECT_EQ(CHIP8_QUIRKS_VIP, q);
+    EXPECT_EQ(quirks_profile(CHIP8_QUIRKS_DEFAULT), quirks_profile(CHIP8_QUIRKS_COUNT));
+}
+
+TEST(Quirks, LogicOpsResetVFOnlyWhereAsked) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    c8.chip8_regs.V[1] = 0x0F; c8.chip8_regs.V[2] = 0xF0;
+
+    c8.chip8_regs.V[0xF] = 7;
+    exec_quirks(c8, CHIP8_QUIRKS_VIP, 0x8121);             // OR V1, V2
+    EXPECT_EQ(0, c8.chip8_regs.V[0xF]);
+    c8.chip8_regs.V[0xF] = 7;
+    exec_quirks(c8, CHIP8_QUIRKS_SCHIP, 0x8122);           // AND V1, V2
+    EXPECT_EQ(0xF0, c8.chip8_regs.V[1]);
+    EXPECT_EQ(7, c8.chip8_regs.V[0xF]);
+    chip8_destroy(&c8);
+}
+
+TEST(Quirks, ShiftsReadVyOnVipAndXoChip) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    c8.chip8_regs.V[1] = 0x80; c8.chip8_regs.V[2] = 0x03;
+
+    exec_quirks(c8, CHIP8_QUIRKS_VIP, 0x8126);             // SHR V1, V2
+    EXPECT_EQ(0x01, c8.chip8_regs.V[1]);
+    EXPECT_EQ(1, c8.chip8_regs.V[0xF]);
+
+    c8.chip8_regs.V[1] = 0x81;
+    exec_quirks(c8, CHIP8_QUIRKS_CHIP48, 0x812E);          // SHL V1 in place
+    EXPECT_EQ(0x02, c8.chip8_regs.V[1]);
+    EXPECT_EQ(1, c8.chip8_regs.V[0xF]);
+
+    c8.chip8_regs.V[2] = 0x40;
+    exec_quirks(c8, CHIP8_QUIRKS_XOCHIP, 0x8F2E);          // SHL VF, V2: the flag wins
+    EXPECT_EQ(0, c8.chip8_regs.V[0xF]);
+    chip8_destroy(&c8);
+}
+
+TEST(Quirks, LoadStoreAdvanceIPerProfile) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    const struct { Chip8Quirks q; uint16_t advance; } cases[] = {
+        { CHIP8_QUIRKS_VIP, 4 }, { CHIP8_QUIRKS_CHIP48, 3 }, { CHIP8_QUIRKS_SCHIP, 0 },
+    };
+    for (const auto& c : cases) {
+        c8.chip8_regs.I = 0x400;
+        exec_quirks(c8, c.q, 0xF355);                      // LD [I], V0..V3
+        EXPECT_EQ(0x400 + c.advance, c8.chip8_regs.I) << quirks_profile(c.q)->name;
+        c8.chip8_regs.I = 0x400;
+        exec_quirks(c8, c.q, 0xF365);                      // LD V0..V3, [I]
+        EXPECT_EQ(0x400 + c.advance, c8.chip8_regs.I) << quirks_profile(c.q)->name;
+    }
+    chip8_destroy(&c8);
+}
+
+TEST(Quirks, JumpOffsetRegister) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    c8.chip8_regs.V[0] = 0x10; c8.chip8_regs.V[3] = 0x20;
+
+    exec_quirks(c8, CHIP8_QUIRKS_VIP, 0xB300);
+    EXPECT_EQ(0x310, c8.chip8_regs.PC);
+    exec_quirks(c8, CHIP8_QUIRKS_SCHIP, 0xB300);
+    EXPECT_EQ(0x320, c8.chip8_regs.PC);
+    chip8_destroy(&c8);
+}
+
+TEST(Quirks, DisplayWaitIdlesUntilTheNextTick) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    const uint16_t prog[] = { 0xD001, 0x7101, 0x1200 };   // DRW; ADD V1, 1; JP 0x200
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x200 + 2 * i,     (uint8_t)(prog[i] >> 8)));
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, 0x200 + 2 * i + 1, (uint8_t)(prog[i] & 0xFF)));
+    }
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    chip8_set_quirks(&c8, CHIP8_QUIRKS_VIP);
+    EXPECT_EQ(CHIP8_QUIRKS_VIP, chip8_get_quirks(&c8));
+
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 100, &ran));
+    EXPECT_EQ(100u, ran);                                  // the budget idles out after the DRW
+    EXPECT_EQ(0, c8.chip8_regs.V[1]);
+    EXPECT_EQ(99u, c8.chip8_idle_cycles);
+
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 100, &ran));  // one loop iteration per frame
+    EXPECT_EQ(100u, ran);
+    EXPECT_EQ(1, c8.chip8_regs.V[1]);
+    EXPECT_EQ(CHIP8_IDLE_VBLANK, chip8_idle_state(&c8));
+
+    // chip8_step() honours the wait too, and switching profiles drops the cache.
+    const uint16_t pc = c8.chip8_regs.PC;
+    ASSERT_EQ(CHIP8_OK, chip8_step(&c8));
+    EXPECT_EQ(pc, c8.chip8_regs.PC);
+    chip8_set_quirks(&c8, CHIP8_QUIRKS_DEFAULT);
+    regs_tick_frame(&c8.chip8_regs);
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 30, &ran));
+    EXPECT_EQ(11, c8.chip8_regs.V[1]);
+    chip8_destroy(&c8);
+}
+
+TEST(Quirks, RomDatabaseLookup) {
+    Chip8Quirks q = CHIP8_QUIRKS_DEFAULT;
+    EXPECT_TRUE(quirks_lookup_rom(0xf6a51128371fd911ull, &q));   // IBM logo
+    EXPECT_EQ(CHIP8_QUIRKS_VIP, q);
+    EXPECT_FALSE(quirks_lookup_rom(0x0123456789abcdefull, &q));
+    EXPECT_EQ(CHIP8_QUIRKS_VIP, q);
+
+    static struct Chip8 c8;
+    chip8_init(&c8);   // blank program area: not listed
+    EXPECT_EQ(CHIP8_QUIRKS_DEFAULT, chip8_detect_quirks(&c8));
+    chip8_destroy(&c8);
+}
@@ -0,0 +1,180 @@
+// tests/test_replay.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+extern "C" {
+#include "chip8.h"
+#include "replay.h"
+#include "mem.h"
+#include "screen.h"
+#include "keyboard.h"
+#include "timer.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+#include "test_util.h"
+
+/* Waits for a key, draws its glyph, mixes in RNG, loops. */
+static const uint16_t kProg[] = {
+    0xF00A,          // 0x200: LD V0, K
+    0xF029,          // 0x202: LD F, V0
+    0xC207,          // 0x204: RND V2, 0x07
+    0xD125,          // 0x206: DRW V1, V2, 5
+    0x7106,          // 0x208: ADD V1, 6
+    0x1200,          // 0x20A: JP 0x200
+};
+
+TEST(Replay, RecordedSessionReplaysBitExactly) {
+    const uint32_t kCpf = 12;
+    static struct Chip8 live, again;
+    load_program(live, kProg, 99);
+    chip8_set_quirks(&live, CHIP8_QUIRKS_SCHIP);
+
+    InputLog log;
+    input_log_init(&log, 99, input_log_rom_hash(&live.chip8_mem), chip8_get_quirks(&live), kCpf);
+
+    // "Live" session: keys change between frames, like the SDL loop.
+    uint64_t cycle = 0;
+    for (int f = 0; f < 200; ++f) {
+        if (f % 7 == 3) {
+            uint8_t key = (uint8_t)(f % 16);
+            ASSERT_EQ(CHIP8_OK, input_log_append(&log, cycle, key, true));
+            keyboard_press(&live.chip8_kbd, key);
+        } else if (f % 7 == 5) {
+            uint8_t key = (uint8_t)((f - 2) % 16);
+            ASSERT_EQ(CHIP8_OK, input_log_append(&log, cycle, key, false));
+            keyboard_release(&live.chip8_kbd, key);
+        }
+        uint32_t ran = 0;
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&live, kCpf, &ran));
+        cycle += ran;
+    }
+    log.end_cycle = cycle;
+
+    const std::string path = temp_path("chip8_replay_roundtrip.c8ir");
+    ASSERT_EQ(CHIP8_OK, input_log_save(&log, path.c_str()));
+
+    InputLog loaded;
+    ASSERT_EQ(CHIP8_OK, input_log_load(&loaded, path.c_str()));
+    EXPECT_EQ(log.count, loaded.count);
+    EXPECT_EQ(99u, loaded.seed);
+    EXPECT_EQ(CHIP8_QUIRKS_SCHIP, loaded.quirks);
+    EXPECT_EQ(kCpf, loaded.cycles_per_frame);
+    EXPECT_EQ(cycle, loaded.end_cycle);
+
+    load_program(again, kProg, loaded.seed);
+    chip8_set_quirks(&again, loaded.quirks);
+    EXPECT_EQ(loaded.rom_hash, input_log_rom_hash(&again.chip8_mem));
+    InputPlayer player;
+    input_player_init(&player, &loaded);
+    uint64_t rc = 0;
+    while (rc < loaded.end_cycle) ASSERT_EQ(CHIP8_OK, input_player_run_frame(&player, &again, &rc));
+
+    EXPECT_EQ(cycle, rc);
+    EXPECT_EQ(screen_hash(&live.chip8_disp), screen_hash(&again.chip8_disp));
+    EXPECT_EQ(live.chip8_regs.PC, again.chip8_regs.PC);
+    EXPECT_EQ(live.chip8_regs.V[1], again.chip8_regs.V[1]);
+    EXPECT_EQ(live.chip8_regs.rng.state, again.chip8_regs.rng.state);
+
+    input_log_free(&log);
+    input_log_free(&loaded);
+    std::remove(path.c_str());
+    chip8_destroy(&live);
+    chip8_destroy(&again);
+}
+
+/* Events inside a frame land on their exact cycle, same as single-stepping. */
+TEST(Replay, MidFrameEventsApplyAtExactCycle) {
+    static struct Chip8 stepped, replayed;
+    load_program(stepped, kProg, 5);
+    load_program(replayed, kProg, 5);
+
+    InputLog log;
+    input_log_init(&log, 5, 0, CHIP8_QUIRKS_DEFAULT, 10);
+    ASSERT_EQ(CHIP8_OK, input_log_append(&log, 3,  0x7, true));
+    ASSERT_EQ(CHIP8_OK, input_log_append(&log, 4,  0x7, false));
+    ASSERT_EQ(CHIP8_OK, input_log_append(&log, 17, 0xC, true));
+    ASSERT_EQ(CHIP8_OK, input_log_append(&log, 29, 0xC, false));
+    EXPECT_EQ(CHIP8_ERR_REPLAY_INVALID, input_log_append(&log, 28, 0x1, true));
+    EXPECT_EQ(CHIP8_ERR_UNKNOWN_KEY_PRESSED, input_log_append(&log, 30, 0x10, true));
+
+    InputPlayer ref;
+    input_player_init(&ref, &log);
+    for (uint64_t c = 0; c < 40; ++c) {
+        input_player_apply(&ref, &stepped.chip8_kbd, c);
+        ASSERT_EQ(CHIP8_OK, chip8_step(&stepped));
+        if (c % 10 == 9) regs_tick_frame(&stepped.chip8_regs);
+    }
+
+    InputPlayer player;
+    input_player_init(&player, &log);
+    uint64_t rc = 0;
+    for (int f = 0; f < 4; ++f) ASSERT_EQ(CHIP8_OK, input_player_run_frame(&player, &replayed, &rc));
+
+    EXPECT_EQ(40u, rc);
+    EXPECT_EQ(screen_hash(&stepped.chip8_disp), screen_hash(&replayed.chip8_disp));
+    EXPECT_EQ(stepped.chip8_regs.PC, replayed.chip8_regs.PC);
+    EXPECT_EQ(stepped.chip8_regs.V[0], replayed.chip8_regs.V[0]);
+    EXPECT_EQ(stepped.chip8_regs.V[1], replayed.chip8_regs.V[1]);
+
+    input_log_free(&log);
+    chip8_destroy(&stepped);
+    chip8_destroy(&replayed);
+}
+
+TEST(Replay, RejectsMalformedFiles) {
+    InputLog log;
+    EXPECT_EQ(CHIP8_ERR_FILE_OPEN, input_log_load(&log, temp_path("does/not/exist.c8ir").c_str()));
+
+    InputLog good;
+    input_log_init(&good, 1, 2, CHIP8_QUIRKS_SCHIP, 12);
+    ASSERT_EQ(CHIP8_OK, input_log_append(&good, 500, 0x3, true));
+    const std::string path = temp_path("chip8_replay_bad.c8ir");
+    ASSERT_EQ(CHIP8_OK, input_log_save(&good, path.c_str()));
+
+    // Truncate the final event byte.
+    FILE* f = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(nullptr, f);
+    unsigned char buf[128];
+    size_t n = std::fread(buf, 1, sizeof(buf), f);
+    std::fclose(f);
+    f = std::fopen(path.c_str(), "wb");
+    std::fwrite(buf, 1, n - 1, f);
+    std::fclose(f);
+    EXPECT_EQ(CHIP8_ERR_REPLAY_INVALID, input_log_load(&log, path.c_str()));
+
+    // An unknown quirks profile.
+    f = std::fopen(path.c_str(), "wb");
+    buf[6] = (unsigned char)CHIP8_QUIRKS_COUNT;
+    std::fwrite(buf, 1, n, f);
+    std::fclose(f);
+    EXPECT_EQ(CHIP8_ERR_REPLAY_INVALID, input_log_load(&log, path.c_str()));
+    buf[6] = (unsigned char)CHIP8_QUIRKS_SCHIP;
+    f = std::fopen(path.c_str(), "wb");
+    std::fwrite(buf, 1, n, f);
+    std::fclose(f);
+    ASSERT_EQ(CHIP8_OK, input_log_load(&log, path.c_str()));
+    EXPECT_EQ(CHIP8_QUIRKS_SCHIP, log.quirks);
+    input_log_free(&log);
+
+    buf[0] = 'X';
+    f = std::fopen(path.c_str(), "wb");
+    std::fwrite(buf, 1, n, f);
+    std::fclose(f);
+    EXPECT_EQ(CHIP8_ERR_REPLAY_INVALID, input_log_load(&log, path.c_str()));
+
+    input_log_free(&good);
+    std::remove(path.c_str());
+}
+
+TEST(Replay, RomHashDistinguishesPrograms) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 0);
+    load_program(b, kProg, 0);
+    EXPECT_EQ(input_log_rom_hash(&a.chip8_mem), input_log_rom_hash(&b.chip8_mem));
+    ASSERT_EQ(CHIP8_OK, memory_write(&b.chip8_mem, 0x300, 1));
+    EXPECT_NE(input_log_rom_hash(&a.chip8_mem), input_log_rom_hash(&b.chip8_mem));
+    chip8_destroy(&a);
+    chip8_destroy(&b);
+}
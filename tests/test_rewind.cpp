@@ -0,0 +1,141 @@
+// tests/test_rewind.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "chip8.h"
+#include "rewind.h"
+#include "mem.h"
+#include "screen.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+#include "test_util.h"
+
+/* Draws a random digit each pass and stores a counter in RAM. */
+static const uint16_t kProg[] = {
+    0x7001,          // 0x200: ADD V0, 1
+    0xC30F,          // 0x202: RND V3, 0x0F
+    0xF329,          // 0x204: LD F, V3
+    0xD125,          // 0x206: DRW V1, V2, 5
+    0x7105,          // 0x208: ADD V1, 5
+    0xA400,          // 0x20A: LD I, 0x400
+    0xF055,          // 0x20C: LD [I], V0
+    0x1200,          // 0x20E: JP 0x200
+};
+
+struct Snapshot {
+    uint16_t pc;
+    uint8_t  v0, dt;
+    uint64_t rng, fb;
+    uint8_t  counter;
+};
+
+static Snapshot snap(const struct Chip8& c8) {
+    return Snapshot{ c8.chip8_regs.PC, c8.chip8_regs.V[0], c8.chip8_regs.DT,
+                     c8.chip8_regs.rng.state, screen_hash(&c8.chip8_disp),
+                     memory_peek(&c8.chip8_mem, 0x400) };
+}
+
+static void expect_same(const Snapshot& a, const Snapshot& b, int frame) {
+    EXPECT_EQ(a.pc, b.pc) << frame;
+    EXPECT_EQ(a.v0, b.v0) << frame;
+    EXPECT_EQ(a.dt, b.dt) << frame;
+    EXPECT_EQ(a.rng, b.rng) << frame;
+    EXPECT_EQ(a.fb, b.fb) << frame;
+    EXPECT_EQ(a.counter, b.counter) << frame;
+}
+
+TEST(Rewind, StepsBackThroughEveryRecordedFrame) {
+    static struct Chip8 c8;
+    load_program(c8, kProg, 7);
+    c8.chip8_regs.DT = 200;
+
+    RewindBuffer* rw = nullptr;
+    ASSERT_EQ(CHIP8_OK, rewind_init(&rw, 1u << 20));
+
+    std::vector<Snapshot> history;
+    for (int f = 0; f < 100; ++f) {
+        ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+        history.push_back(snap(c8));
+        uint32_t ran = 0;
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    }
+    ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+    EXPECT_EQ(100u, rewind_frames(rw));
+    EXPECT_LT(rewind_bytes_used(rw), 100u * 128u);   // deltas, not full frames
+
+    for (int f = 99; f >= 0; --f) {
+        ASSERT_EQ(CHIP8_OK, rewind_step_back(rw, &c8));
+        expect_same(history[f], snap(c8), f);
+    }
+    EXPECT_EQ(CHIP8_ERR_REWIND_EMPTY, rewind_step_back(rw, &c8));
+
+    // Rewound state resumes exactly as the original run did.
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    expect_same(history[1], snap(c8), 1);
+
+    rewind_destroy(rw);
+    chip8_destroy(&c8);
+}
+
+TEST(Rewind, FullRingDropsOldestFrames) {
+    static struct Chip8 c8;
+    load_program(c8, kProg, 7);
+
+    RewindBuffer* rw = nullptr;
+    ASSERT_EQ(CHIP8_ERR_BUFFER_TOO_SMALL, rewind_init(&rw, 64));
+    ASSERT_EQ(CHIP8_OK, rewind_init(&rw, 64u * 1024u));
+
+    std::vector<Snapshot> history;
+    for (int f = 0; f < 3000; ++f) {
+        ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+        history.push_back(snap(c8));
+        uint32_t ran = 0;
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    }
+    ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+
+    const size_t kept = rewind_frames(rw);
+    ASSERT_GT(kept, 10u);
+    ASSERT_LT(kept, 3000u);
+
+    for (size_t i = 0; i < kept; ++i) {
+        ASSERT_EQ(CHIP8_OK, rewind_step_back(rw, &c8));
+        expect_same(history[3000 - 1 - i], snap(c8), (int)i);
+    }
+    EXPECT_EQ(CHIP8_ERR_REWIND_EMPTY, rewind_step_back(rw, &c8));
+
+    rewind_destroy(rw);
+    chip8_destroy(&c8);
+}
+
+TEST(Rewind, RecordAfterRewindContinuesHistory) {
+    static struct Chip8 c8;
+    load_program(c8, kProg, 7);
+
+    RewindBuffer* rw = nullptr;
+    ASSERT_EQ(CHIP8_OK, rewind_init(&rw, 1u << 16));
+    uint32_t ran = 0;
+    for (int f = 0; f < 10; ++f) {
+        ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    }
+    for (int f = 0; f < 5; ++f) ASSERT_EQ(CHIP8_OK, rewind_step_back(rw, &c8));
+    EXPECT_EQ(4u, rewind_frames(rw));
+    const Snapshot branch = snap(c8);
+
+    ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    ASSERT_EQ(CHIP8_OK, rewind_record(rw, &c8));
+    EXPECT_EQ(5u, rewind_frames(rw));
+    ASSERT_EQ(CHIP8_OK, rewind_step_back(rw, &c8));
+    expect_same(branch, snap(c8), 0);
+
+    rewind_clear(rw);
+    EXPECT_EQ(0u, rewind_frames(rw));
+    EXPECT_EQ(CHIP8_ERR_REWIND_EMPTY, rewind_step_back(rw, &c8));
+    rewind_destroy(rw);
+    chip8_destroy(&c8);
+}
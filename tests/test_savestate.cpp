@@ -0,0 +1,173 @@
+// tests/test_savestate.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "chip8.h"
+#include "mem.h"
+#include "screen.h"
+#include "keyboard.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+#include "test_util.h"
+
+/* Counter loop that also draws, calls, writes RAM and uses the RNG. */
+static const uint16_t kProg[] = {
+    0x6000,          // 0x200: LD V0, 0
+    0xA300,          // 0x202: LD I, 0x300
+    0x2210,          // 0x204: CALL 0x210
+    0x7001,          // 0x206: ADD V0, 1
+    0xC1FF,          // 0x208: RND V1, 0xFF
+    0xF033,          // 0x20A: LD B, V0   -> writes 0x300..0x302
+    0x1202,          // 0x20C: JP 0x202
+    0x0000,          // 0x20E: pad
+    0xF029,          // 0x210: LD F, V0
+    0xD125,          // 0x212: DRW V1, V2, 5
+    0x00EE,          // 0x214: RET
+};
+
+static std::vector<uint8_t> ram_of(const struct Chip8& c8) {
+    std::vector<uint8_t> ram(MEMORY_SIZE);
+    memory_read_block(&c8.chip8_mem, 0, ram.data(), ram.size());
+    return ram;
+}
+
+static void run_frames(struct Chip8& c8, int frames) {
+    for (int f = 0; f < frames; ++f) {
+        uint32_t ran = 0;
+        ASSERT_EQ(CHIP8_OK, chip8_run_frame(&c8, 12, &ran));
+    }
+}
+
+TEST(SaveState, RoundTripResumesIdentically) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 42);
+    run_frames(a, 10);
+    a.chip8_regs.ST = 7;
+    keyboard_press(&a.chip8_kbd, 0xA);
+
+    /* Base = the freshly loaded image, so only mutated RAM is stored. */
+    static struct Chip8 fresh;
+    load_program(fresh, kProg, 42);
+    const std::vector<uint8_t> base_image = ram_of(fresh);
+    const uint8_t* base = base_image.data();
+
+    std::vector<uint8_t> buf(CHIP8_STATE_MAX_SIZE);
+    size_t len = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_save_state(&a, base, buf.data(), buf.size(), &len));
+    EXPECT_LT(len, 512u);
+
+    chip8_init(&b);
+    ASSERT_EQ(CHIP8_OK, chip8_load_state(&b, base, buf.data(), len));
+    EXPECT_EQ(0, memcmp(ram_of(a).data(), ram_of(b).data(), MEMORY_SIZE));
+    EXPECT_EQ(0, memcmp(a.chip8_regs.V, b.chip8_regs.V, NUM_REGS));
+    EXPECT_EQ(a.chip8_regs.PC, b.chip8_regs.PC);
+    EXPECT_EQ(a.chip8_regs.rng.state, b.chip8_regs.rng.state);
+    EXPECT_EQ(7, b.chip8_regs.ST);
+    EXPECT_EQ(1, b.chip8_kbd.state[0xA]);
+    EXPECT_EQ(screen_hash(&a.chip8_disp), screen_hash(&b.chip8_disp));
+
+    run_frames(a, 20);
+    run_frames(b, 20);
+    EXPECT_EQ(screen_hash(&a.chip8_disp), screen_hash(&b.chip8_disp));
+    EXPECT_EQ(a.chip8_regs.rng.state, b.chip8_regs.rng.state);
+    EXPECT_EQ(0, memcmp(ram_of(a).data(), ram_of(b).data(), MEMORY_SIZE));
+}
+
+TEST(SaveState, NullBaseStoresWholeImage) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 42);
+    run_frames(a, 3);
+
+    std::vector<uint8_t> buf(CHIP8_STATE_MAX_SIZE);
+    size_t len = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_save_state(&a, nullptr, buf.data(), buf.size(), &len));
+
+    chip8_init(&b);
+    ASSERT_EQ(CHIP8_OK, chip8_load_state(&b, nullptr, buf.data(), len));
+    EXPECT_EQ(0, memcmp(ram_of(a).data(), ram_of(b).data(), MEMORY_SIZE));
+}
+
+TEST(SaveState, RejectsBadInputWithoutTouchingTarget) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 42);
+    run_frames(a, 5);
+
+    std::vector<uint8_t> buf(CHIP8_STATE_MAX_SIZE);
+    size_t len = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_save_state(&a, nullptr, buf.data(), buf.size(), &len));
+
+    load_program(b, kProg, 42);
+    const uint16_t pc = b.chip8_regs.PC;
+
+    for (size_t cut : { (size_t)0, (size_t)3, (size_t)20, len - 1 }) {
+        EXPECT_EQ(CHIP8_ERR_STATE_INVALID, chip8_load_state(&b, nullptr, buf.data(), cut)) << cut;
+    }
+
+    std::vector<uint8_t> bad(buf.begin(), buf.begin() + len);
+    bad[0] = 'X';
+    EXPECT_EQ(CHIP8_ERR_STATE_INVALID, chip8_load_state(&b, nullptr, bad.data(), len));
+
+    uint8_t other_base[MEMORY_SIZE] = { 1 };
+    EXPECT_EQ(CHIP8_ERR_STATE_BASE_MISMATCH, chip8_load_state(&b, other_base, buf.data(), len));
+
+    EXPECT_EQ(pc, b.chip8_regs.PC);
+}
+
+TEST(SaveState, ReportsSmallBuffer) {
+    static struct Chip8 a;
+    load_program(a, kProg, 42);
+    uint8_t small[16];
+    size_t len = 0;
+    EXPECT_EQ(CHIP8_ERR_BUFFER_TOO_SMALL, chip8_save_state(&a, nullptr, small, sizeof(small), &len));
+    EXPECT_EQ(CHIP8_ERR_NULL_ARG, chip8_save_state(&a, nullptr, nullptr, 0, &len));
+}
+
+TEST(SaveState, KeepsHiresScreenAndFlags) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 42);
+    screen_set_hires(&a.chip8_disp, true);
+    const uint8_t sprite[2] = {0xFF, 0x81};
+    (void)screen_draw_sprite(&a.chip8_disp, 100, 50, sprite, 2);
+    for (uint8_t i = 0; i < NUM_REGS; ++i) a.chip8_regs.RPL[i] = (uint8_t)(0xA0 + i);
+
+    std::vector<uint8_t> buf(CHIP8_STATE_MAX_SIZE);
+    size_t len = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_save_state(&a, nullptr, buf.data(), buf.size(), &len));
+
+    chip8_init(&b);
+    ASSERT_EQ(CHIP8_OK, chip8_load_state(&b, nullptr, buf.data(), len));
+    EXPECT_TRUE(b.chip8_disp.hires);
+    EXPECT_EQ(1u, screen_get_pixel(&b.chip8_disp, 107, 51));
+    EXPECT_EQ(screen_hash(&a.chip8_disp), screen_hash(&b.chip8_disp));
+    EXPECT_EQ(0, memcmp(a.chip8_regs.RPL, b.chip8_regs.RPL, NUM_REGS));
+}
+
+TEST(SaveState, KeepsXOChipPlanesAndAudio) {
+    static struct Chip8 a, b;
+    load_program(a, kProg, 42);
+    screen_select_planes(&a.chip8_disp, 2);
+    const uint8_t dot[1] = {0x80};
+    (void)screen_draw_sprite(&a.chip8_disp, 9, 9, dot, 1);
+    screen_select_planes(&a.chip8_disp, 3);
+    for (uint8_t i = 0; i < AUDIO_PATTERN_BYTES; ++i) a.chip8_regs.pattern[i] = (uint8_t)(i * 17);
+    a.chip8_regs.has_pattern = true;
+    a.chip8_regs.pitch = 99;
+    ASSERT_EQ(CHIP8_OK, memory_write(&a.chip8_mem, 0xFFF0, 0x5A));   // above the classic 4 KB
+
+    std::vector<uint8_t> buf(CHIP8_STATE_MAX_SIZE);
+    size_t len = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_save_state(&a, nullptr, buf.data(), buf.size(), &len));
+
+    chip8_init(&b);
+    ASSERT_EQ(CHIP8_OK, chip8_load_state(&b, nullptr, buf.data(), len));
+    EXPECT_EQ(2u, screen_get_color(&b.chip8_disp, 9, 9));
+    EXPECT_EQ(2u, screen_plane_count(&b.chip8_disp));
+    EXPECT_EQ(screen_hash(&a.chip8_disp), screen_hash(&b.chip8_disp));
+    EXPECT_TRUE(b.chip8_regs.has_pattern);
+    EXPECT_EQ(99, b.chip8_regs.pitch);
+    EXPECT_EQ(0, memcmp(a.chip8_regs.pattern, b.chip8_regs.pattern, AUDIO_PATTERN_BYTES));
+    EXPECT_EQ(0x5A, memory_peek(&b.chip8_mem, 0xFFF0));
+}
@@ -0,0 +1,202 @@
+// tests/test_screen.cpp
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "screen.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+TEST(Screen, InitIsBlankAndDirty) {
+    Screen s{};
+    screen_init(&s);
+    EXPECT_TRUE(screen_consume_dirty(&s));
+    EXPECT_FALSE(screen_consume_dirty(&s));
+    for (int y = 0; y < DISPLAY_HEIGHT; ++y) EXPECT_EQ(0u, screen_rows(&s)[y]);
+}
+
+TEST(Screen, SpriteRowPackingMSBIsLeftmost) {
+    Screen s{}; screen_init(&s);
+    const uint8_t sprite[1] = {0xA5}; // 1010 0101
+    EXPECT_FALSE(screen_draw_sprite(&s, 8, 3, sprite, 1));
+
+    EXPECT_EQ(0x00A5000000000000ull, screen_rows(&s)[3]);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 8, 3));
+    EXPECT_EQ(0u, screen_get_pixel(&s, 9, 3));
+    EXPECT_EQ(1u, screen_get_pixel(&s, 15, 3));
+}
+
+TEST(Screen, SpriteWrapsHorizontallyAndVertically) {
+    Screen s{}; screen_init(&s);
+    const uint8_t sprite[2] = {0xFF, 0x81};
+    (void)screen_draw_sprite(&s, 60, 31, sprite, 2);
+
+    // row 31: x = 60..63 and 0..3
+    for (uint8_t x : {60, 61, 62, 63, 0, 1, 2, 3}) EXPECT_EQ(1u, screen_get_pixel(&s, x, 31)) << int(x);
+    EXPECT_EQ(0u, screen_get_pixel(&s, 4, 31));
+    // second row wraps to y = 0: only x = 60 and x = 3
+    EXPECT_EQ(1u, screen_get_pixel(&s, 60, 0));
+    EXPECT_EQ(1u, screen_get_pixel(&s, 3, 0));
+    EXPECT_EQ(0u, screen_get_pixel(&s, 61, 0));
+}
+
+TEST(Screen, XorDrawReportsCollisionAndErases) {
+    Screen s{}; screen_init(&s);
+    const uint8_t sprite[3] = {0xF0, 0x90, 0xF0};
+    EXPECT_FALSE(screen_draw_sprite(&s, 62, 10, sprite, 3));
+    (void)screen_consume_dirty(&s);
+
+    EXPECT_TRUE(screen_draw_sprite(&s, 62, 10, sprite, 3));
+    EXPECT_TRUE(screen_consume_dirty(&s));
+    for (int y = 0; y < DISPLAY_HEIGHT; ++y) EXPECT_EQ(0u, screen_rows(&s)[y]);
+}
+
+TEST(Screen, EmptySpriteDoesNotDirty) {
+    Screen s{}; screen_init(&s);
+    (void)screen_consume_dirty(&s);
+    const uint8_t sprite[2] = {0x00, 0x00};
+    EXPECT_FALSE(screen_draw_sprite(&s, 0, 0, sprite, 2));
+    EXPECT_FALSE(screen_consume_dirty(&s));
+}
+
+TEST(Screen, SetToggleAndPixelsView) {
+    Screen s{}; screen_init(&s);
+    EXPECT_EQ(CHIP8_OK, screen_set_pixel(&s, 5, 7, 1));
+    EXPECT_EQ(CHIP8_ERR_PIXEL_SET_FAILURE, screen_set_pixel(&s, 5, 7, 1)); // unchanged
+    EXPECT_TRUE(screen_toggle_pixel(&s, 5, 7));   // 1 -> 0 is a collision
+    EXPECT_FALSE(screen_toggle_pixel(&s, 69, 39)); // wraps to (5, 7): 0 -> 1
+
+    static uint8_t px[DISPLAY_WIDTH * DISPLAY_HEIGHT];
+    ASSERT_EQ(px, screen_pixels(&s, px));
+    for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; ++i) {
+        EXPECT_EQ(i == 7 * DISPLAY_WIDTH + 5 ? 1u : 0u, px[i]) << i;
+    }
+}
+
+TEST(Screen, DirtyRowsTrackOnlyTouchedRows) {
+    Screen s{}; screen_init(&s);
+    EXPECT_EQ(0xFFFFFFFFull, screen_consume_dirty_rows(&s)); // init dirties every row
+
+    const uint8_t sprite[3] = {0x80, 0x00, 0x01};
+    (void)screen_draw_sprite(&s, 0, 30, sprite, 3);   // rows 30, (31 blank), 0
+    EXPECT_EQ((1ull << 30) | 1ull, screen_consume_dirty_rows(&s));
+
+    (void)screen_toggle_pixel(&s, 3, 37);              // wraps to row 5
+    EXPECT_EQ(1ull << 5, screen_consume_dirty_rows(&s));
+    EXPECT_EQ(0ull, screen_consume_dirty_rows(&s));
+}
+
+TEST(Screen, HashTracksContent) {
+    Screen a{}, b{}; screen_init(&a); screen_init(&b);
+    EXPECT_EQ(screen_hash(&a), screen_hash(&b));
+
+    const uint8_t sprite[1] = {0x80};
+    (void)screen_draw_sprite(&a, 1, 2, sprite, 1);
+    EXPECT_NE(screen_hash(&a), screen_hash(&b));
+
+    (void)screen_draw_sprite(&b, 1, 2, sprite, 1);
+    EXPECT_EQ(screen_hash(&a), screen_hash(&b));
+}
+
+TEST(Screen, HiresSwitchClearsAndWrapsAt128x64) {
+    Screen s{}; screen_init(&s);
+    const uint8_t dot[1] = {0x80};
+    (void)screen_draw_sprite(&s, 1, 1, dot, 1);
+    (void)screen_consume_dirty_rows(&s);
+
+    screen_set_hires(&s, true);
+    EXPECT_EQ(HIRES_WIDTH, screen_width(&s));
+    EXPECT_EQ(HIRES_HEIGHT, screen_height(&s));
+    EXPECT_EQ(~0ull, screen_consume_dirty_rows(&s));   // every hi-res row repaints
+    EXPECT_EQ(0u, screen_get_pixel(&s, 1, 1));
+
+    const uint8_t sprite[2] = {0xFF, 0x81};
+    EXPECT_FALSE(screen_draw_sprite(&s, 124, 63, sprite, 2));
+    // row 63: x = 124..127 (right word) and 0..3 (left word)
+    EXPECT_EQ(0x000000000000000Full, screen_rows_right(&s)[63]);
+    EXPECT_EQ(0xF000000000000000ull, screen_rows(&s)[63]);
+    // second row wraps to y = 0: x = 124 and x = 3
+    EXPECT_EQ(1u, screen_get_pixel(&s, 124, 0));
+    EXPECT_EQ(1u, screen_get_pixel(&s, 3, 0));
+    EXPECT_EQ(0u, screen_get_pixel(&s, 125, 0));
+
+    screen_set_hires(&s, false);
+    EXPECT_EQ(DISPLAY_WIDTH, screen_width(&s));
+    EXPECT_EQ(0u, screen_rows(&s)[63]);
+    EXPECT_EQ(0u, screen_rows_right(&s)[63]);
+}
+
+TEST(Screen, Sprite16CrossesWordBoundary) {
+    Screen s{}; screen_init(&s);
+    screen_set_hires(&s, true);
+    uint8_t sprite[32] = {};
+    sprite[0] = 0xFF; sprite[1] = 0x01;   // row 0: 1111 1111 0000 0001
+    sprite[31] = 0x80;                    // row 15: 0000 0000 1000 0000
+
+    EXPECT_FALSE(screen_draw_sprite16(&s, 60, 10, sprite));
+    EXPECT_EQ(0x000000000000000Full, screen_rows(&s)[10]);        // x 60..63
+    EXPECT_EQ(0xF010000000000000ull, screen_rows_right(&s)[10]);  // x 64..67, 75
+    EXPECT_EQ(1u, screen_get_pixel(&s, 68, 25));                   // row 15, bit 7 of byte 1
+    EXPECT_TRUE(screen_draw_sprite16(&s, 60, 10, sprite));         // XOR erases
+    EXPECT_EQ(0u, screen_rows(&s)[10]);
+    EXPECT_EQ(0u, screen_rows_right(&s)[10]);
+}
+
+TEST(Screen, ScrollsShiftWholeRows) {
+    Screen s{}; screen_init(&s);
+    const uint8_t dot[1] = {0x80};
+    (void)screen_draw_sprite(&s, 10, 5, dot, 1);
+
+    screen_scroll_down(&s, 3);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 10, 8));
+    screen_scroll_right(&s, 4);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 14, 8));
+    screen_scroll_left(&s, 4);
+    screen_scroll_left(&s, 4);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 6, 8));
+    screen_scroll_left(&s, 8);   // pixels leave the screen instead of wrapping
+    EXPECT_EQ(0u, screen_rows(&s)[8]);
+    EXPECT_EQ(0xFFFFFFFFull, screen_consume_dirty_rows(&s));
+
+    // Hi-res: horizontal scrolls carry pixels between the two row words.
+    screen_set_hires(&s, true);
+    (void)screen_draw_sprite(&s, 62, 63, dot, 1);
+    screen_scroll_right(&s, 4);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 66, 63));
+    EXPECT_EQ(0u, screen_rows(&s)[63]);
+    screen_scroll_left(&s, 4);
+    screen_scroll_left(&s, 4);
+    EXPECT_EQ(1u, screen_get_pixel(&s, 58, 63));
+    EXPECT_EQ(0u, screen_rows_right(&s)[63]);
+    screen_scroll_down(&s, 1);   // bottom row falls off
+    EXPECT_EQ(0u, screen_rows(&s)[63]);
+    EXPECT_EQ(0u, screen_rows(&s)[0]);
+}
+
+TEST(Screen, PlanesDrawClearAndHashSeparately) {
+    Screen s{}; screen_init(&s);
+    const uint8_t dot[1] = {0x80};
+    (void)screen_draw_sprite(&s, 2, 2, dot, 1);
+    const uint64_t one_plane = screen_hash(&s);
+
+    screen_select_planes(&s, 2);
+    EXPECT_EQ(1u, screen_plane_count(&s));
+    screen_clear(&s);                                   // plane 1 untouched
+    EXPECT_EQ(1u, screen_get_color(&s, 2, 2));
+    EXPECT_EQ(one_plane, screen_hash(&s));              // blank plane 2 adds nothing
+
+    (void)screen_draw_sprite(&s, 2, 2, dot, 1);
+    EXPECT_EQ(3u, screen_get_color(&s, 2, 2));
+    EXPECT_EQ(1u, screen_get_pixel(&s, 2, 2));          // plane 1 view
+    EXPECT_NE(one_plane, screen_hash(&s));
+
+    screen_select_planes(&s, 3);
+    EXPECT_EQ(2u, screen_plane_count(&s));
+    const uint8_t both[2] = {0x80, 0x00};               // plane 1 row, plane 2 row
+    EXPECT_TRUE(screen_draw_sprite(&s, 2, 2, both, 1));
+    EXPECT_EQ(2u, screen_get_color(&s, 2, 2));
+
+    screen_set_hires(&s, true);                         // mode switch clears both planes
+    EXPECT_EQ(0u, screen_rows2(&s)[2]);
+    EXPECT_EQ(0u, screen_get_color(&s, 2, 2));
+}
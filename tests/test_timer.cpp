@@ -0,0 +1,79 @@
+// tests/test_timer.cpp
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "timer.h"
+#include "regs.h"
+}
+
+static const uint64_t kTickNs = 1000000000ull / 60ull;
+
+TEST(Timer, TicksAt60HzAndKeepsRemainder) {
+    Registers r{}; r.DT = 10; r.ST = 10;
+    TimerState ts; timer_state_init(&ts);
+
+    regs_tick_timers(&r, &ts, kTickNs / 2, nullptr, nullptr);
+    EXPECT_EQ(10, r.DT);                       // half a tick: nothing yet
+    regs_tick_timers(&r, &ts, kTickNs / 2 + 1, nullptr, nullptr);
+    EXPECT_EQ(9, r.DT);
+    regs_tick_timers(&r, &ts, 3 * kTickNs, nullptr, nullptr);
+    EXPECT_EQ(6, r.DT);
+    EXPECT_EQ(6, r.ST);
+}
+
+TEST(Timer, BeepEdges) {
+    Registers r{}; r.ST = 2;
+    TimerState ts; timer_state_init(&ts);
+    bool start = false, stop = false;
+
+    EXPECT_TRUE(regs_tick_timers(&r, &ts, 0, &start, &stop));
+    EXPECT_TRUE(start);  EXPECT_FALSE(stop);
+
+    EXPECT_FALSE(regs_tick_timers(&r, &ts, kTickNs, &start, &stop)); // ST 2 -> 1
+    EXPECT_FALSE(start); EXPECT_FALSE(stop);
+
+    EXPECT_TRUE(regs_tick_timers(&r, &ts, kTickNs, &start, &stop));  // ST 1 -> 0
+    EXPECT_FALSE(start); EXPECT_TRUE(stop);
+}
+
+/* Two instances must not share accumulator or edge state. */
+TEST(Timer, InstancesAreIndependent) {
+    Registers a{}, b{}; a.DT = 5; b.DT = 5; a.ST = 1;
+    TimerState ta, tb; timer_state_init(&ta); timer_state_init(&tb);
+
+    bool start_a = false, start_b = false;
+    regs_tick_timers(&a, &ta, kTickNs - 1, &start_a, nullptr);
+    regs_tick_timers(&b, &tb, 1, &start_b, nullptr);
+    EXPECT_EQ(5, a.DT);
+    EXPECT_EQ(5, b.DT);            // shared accumulator would have reached a full tick
+    EXPECT_TRUE(start_a);
+    EXPECT_FALSE(start_b);         // b never had ST > 0
+}
+
+TEST(Timer, ParallelInstancesAreDeterministic) {
+    constexpr int kThreads = 8;
+    std::vector<Registers> regs(kThreads);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < kThreads; ++t) {
+        pool.emplace_back([&regs, t] {
+            Registers& r = regs[t];
+            r.DT = 200;
+            TimerState ts; timer_state_init(&ts);
+            // 100000 slices of just over 1/1000 tick: exactly 100 ticks in total
+            for (int i = 0; i < 100000; ++i) regs_tick_timers(&r, &ts, (kTickNs + 999) / 1000, nullptr, nullptr);
+        });
+    }
+    for (auto& th : pool) th.join();
+    for (int t = 0; t < kThreads; ++t) EXPECT_EQ(100, regs[t].DT) << "thread " << t;
+}
+
+TEST(Timer, TickFrameDecrementsOnce) {
+    Registers r{}; r.DT = 1; r.ST = 0;
+    regs_tick_frame(&r);
+    EXPECT_EQ(0, r.DT);
+    EXPECT_EQ(0, r.ST);
+    regs_tick_frame(&r);
+    EXPECT_EQ(0, r.DT);
+}
@@ -0,0 +1,131 @@
+// tests/test_trace.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "chip8.h"
+#include "trace.h"
+#include "regs.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+#include "test_util.h"
+
+static std::vector<TraceRecord> read_all(const std::string& path, TraceHeader* h) {
+    std::vector<TraceRecord> out;
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return out;
+    if (trace_read_header(f, h) == CHIP8_OK) {
+        TraceRecord buf[1000];
+        size_t n;
+        while ((n = trace_read(f, buf, 1000)) > 0) out.insert(out.end(), buf, buf + n);
+    }
+    std::fclose(f);
+    return out;
+}
+
+TEST(Trace, RingWritesEveryRecordInOrder) {
+    const std::string path = temp_path("chip8_trace_ring.c8t");
+    TraceRing* ring = nullptr;
+    // smallest ring, waiting when full: the writer thread must keep up
+    ASSERT_EQ(CHIP8_OK, trace_open(&ring, path.c_str(), 1, 0x1234, false));
+
+    TraceWriter w{};
+    w.ring = ring;
+    Registers regs{};
+    const uint32_t kCount = 100000;
+    for (uint32_t k = 0; k < kCount; ++k) {
+        regs.I = (uint16_t)k;
+        regs.V[3] = (uint8_t)k;
+        regs.V[0xF] = (uint8_t)(k >> 8);
+        trace_record(&w, (uint16_t)(0x200 + (k & 0xFF) * 2), 0x7305, &regs);
+    }
+    trace_writer_flush(&w);
+
+    TraceStats stats;
+    ASSERT_EQ(CHIP8_OK, trace_close(ring, &stats));
+    EXPECT_EQ(kCount, stats.records);
+    EXPECT_EQ(0u, stats.dropped);
+
+    TraceHeader h;
+    const std::vector<TraceRecord> recs = read_all(path, &h);
+    EXPECT_EQ(0x1234u, h.rom_hash);
+    EXPECT_EQ(kCount, h.records);
+    ASSERT_EQ(kCount, recs.size());
+    for (uint32_t k = 0; k < kCount; ++k) {
+        ASSERT_EQ(k, recs[k].cycle);
+        ASSERT_EQ(0x200 + (k & 0xFF) * 2, recs[k].pc);
+        ASSERT_EQ(0x7305, recs[k].op);
+        ASSERT_EQ((uint16_t)k, recs[k].i);
+        ASSERT_EQ((uint8_t)k, recs[k].vx);
+        ASSERT_EQ((uint8_t)(k >> 8), recs[k].vf);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Trace, RejectsOtherFiles) {
+    const std::string path = temp_path("chip8_trace_bad.c8t");
+    FILE* f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, f);
+    std::fputs("C8IR not a trace, but long enough for a header", f);
+    std::fclose(f);
+
+    TraceHeader h;
+    EXPECT_TRUE(read_all(path, &h).empty());
+    f = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(nullptr, f);
+    EXPECT_EQ(CHIP8_ERR_TRACE_INVALID, trace_read_header(f, &h));
+    std::fclose(f);
+    std::remove(path.c_str());
+
+    TraceRing* ring = nullptr;
+    EXPECT_EQ(CHIP8_ERR_FILE_OPEN, trace_open(&ring, temp_path("does/not/exist.c8t").c_str(), 0, 0, false));
+    EXPECT_EQ(nullptr, ring);
+}
+
+#ifdef CHIP8_TRACE
+/* The trace of a run is the sequence chip8_step() executes, idle cycles counted. */
+TEST(Trace, RecordsTheInterpretersRun) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    const uint16_t prog[] = {
+        0x6305,   // 0x200: LD V3, 5
+        0x7301,   // 0x202: ADD V3, 1
+        0xA300,   // 0x204: LD I, 0x300
+        0x1206,   // 0x206: JP 0x206   (halt: skipped as idle)
+    };
+    for (size_t k = 0; k < 4; ++k) {
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, (uint16_t)(0x200 + 2 * k), (uint8_t)(prog[k] >> 8)));
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, (uint16_t)(0x201 + 2 * k), (uint8_t)(prog[k] & 0xFF)));
+    }
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+
+    const std::string path = temp_path("chip8_trace_run.c8t");
+    TraceRing* ring = nullptr;
+    ASSERT_EQ(CHIP8_OK, trace_open(&ring, path.c_str(), 0, 0, false));
+    chip8_set_trace(&c8, ring);
+    uint32_t ran = 0;
+    ASSERT_EQ(CHIP8_OK, chip8_run_blocks(&c8, 100, &ran));   // one block ending in the JP, then 96 idle
+    ASSERT_EQ(CHIP8_OK, chip8_step(&c8));                     // the JP again, at cycle 100
+    chip8_set_trace(&c8, nullptr);
+    ASSERT_EQ(CHIP8_OK, trace_close(ring, nullptr));
+
+    TraceHeader h;
+    const std::vector<TraceRecord> recs = read_all(path, &h);
+    ASSERT_EQ(5u, recs.size());
+    EXPECT_EQ(0x6305, recs[0].op);
+    EXPECT_EQ(5, recs[0].vx);
+    EXPECT_EQ(0x202, recs[1].pc);
+    EXPECT_EQ(6, recs[1].vx);
+    EXPECT_EQ(0x300, recs[2].i);
+    EXPECT_EQ(2u, recs[2].cycle);
+    EXPECT_EQ(0x206, recs[3].pc);
+    EXPECT_EQ(3u, recs[3].cycle);
+    EXPECT_EQ(0x206, recs[4].pc);
+    EXPECT_EQ(100u, recs[4].cycle);
+    chip8_destroy(&c8);
+    std::remove(path.c_str());
+}
+#endif
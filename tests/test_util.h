@@ -0,0 +1,47 @@
+// tests/test_util.h
+// Fixture helpers shared by the test programs.
+#ifndef CHIP8_TEST_UTIL_H
+#define CHIP8_TEST_UTIL_H
+
+#include <gtest/gtest.h>
+#include <string>
+#ifdef _WIN32
+  #include <process.h>   // _getpid
+  #define getpid _getpid
+#else
+  #include <unistd.h>    // getpid
+#endif
+
+extern "C" {
+#include "chip8.h"
+#include "mem.h"
+#include "config.h"
+#include "chip8_status.h"
+}
+
+/* Reset `c8`, seed its RNG, load a big-endian opcode sequence at
+ * PROGRAM_START_ADDRESS and point PC at it. */
+static inline void load_program(struct Chip8& c8, const uint16_t* ops, size_t count, uint64_t seed) {
+    chip8_init(&c8);
+    chip8_seed(&c8, seed);
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t a = (uint16_t)(PROGRAM_START_ADDRESS + 2 * i);
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, a,     (uint8_t)(ops[i] >> 8)));
+        ASSERT_EQ(CHIP8_OK, memory_write(&c8.chip8_mem, a + 1, (uint8_t)(ops[i] & 0xFF)));
+    }
+    c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+}
+
+template <size_t N>
+static inline void load_program(struct Chip8& c8, const uint16_t (&ops)[N], uint64_t seed) {
+    load_program(c8, ops, N, seed);
+}
+
+/* A temp file path unique per process and test: ctest runs each test binary
+ * whole and case by case, possibly in parallel, so a fixed name would be shared. */
+static inline std::string temp_path(const char* name) {
+    const ::testing::TestInfo* t = ::testing::UnitTest::GetInstance()->current_test_info();
+    return ::testing::TempDir() + std::to_string(getpid()) + "_" + (t ? t->name() : "") + "_" + name;
+}
+
+#endif /* CHIP8_TEST_UTIL_H */
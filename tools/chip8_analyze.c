@@ -0,0 +1,147 @@
+// tools/chip8_analyze.c
+// Static analyzer: loads a ROM, follows its control flow without running it
+// and reports the reachable code, basic blocks and unresolvable jumps.
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "chip8.h"
+#include "chip8_status.h"
+#include "analyze.h"
+#include "disasm.h"
+#include "instr.h"
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <path/to/rom>\n"
+            "  --entry ADDR  start address, hex (default 0x%03X)\n"
+            "  --blocks      list the basic blocks and their successors\n"
+            "  --disasm      list the reachable code, a blank line before each block\n"
+            "  --map         byte map of the ROM: C instruction, c operand,\n"
+            "                D data loaded by LD I, . other data\n",
+            argv0, PROGRAM_START_ADDRESS);
+}
+
+static const char* const END_NAMES[] = {
+    [BLOCK_END_FALL]     = "fall",
+    [BLOCK_END_JUMP]     = "jump",
+    [BLOCK_END_BRANCH]   = "skip",
+    [BLOCK_END_CALL]     = "call",
+    [BLOCK_END_RET]      = "ret",
+    [BLOCK_END_HALT]     = "halt",
+    [BLOCK_END_INDIRECT] = "indirect",
+    [BLOCK_END_STOP]     = "stop",
+};
+
+/* One past the last non-zero byte of the program area: the ROM's extent. */
+static size_t rom_end(const Memory* m) {
+    size_t end = PROGRAM_START_ADDRESS;
+    for (size_t a = PROGRAM_START_ADDRESS; a < MEMORY_SIZE; ++a) {
+        if (memory_peek(m, (uint16_t)a) != 0) end = a + 1;
+    }
+    return end;
+}
+
+static void print_blocks(const RomAnalysis* a, const Memory* m) {
+    for (size_t i = 0; i < a->block_count; ++i) {
+        const RomBlock* b = &a->blocks[i];
+        const uint16_t op = (uint16_t)((memory_peek(m, b->last) << 8) | memory_peek(m, (uint16_t)(b->last + 1)));
+        char text[INSTR_DISASM_MAX];
+        instr_disasm(op, text, sizeof(text));
+        printf("0x%03X-0x%03X %3u instr  %-8s %-16s", (unsigned)b->start, (unsigned)b->last,
+               (unsigned)b->instrs, END_NAMES[b->end], text);
+        for (uint8_t s = 0; s < b->nsucc; ++s) printf(" -> 0x%03X", (unsigned)b->succ[s]);
+        putchar('\n');
+    }
+}
+
+static void print_disasm(const RomAnalysis* a, const Memory* m) {
+    char line[DISASM_LINE_MAX];
+    for (size_t p = 0; p < MEMORY_SIZE; ++p) {
+        if (!(a->flags[p] & ANALYZE_CODE)) continue;
+        if (a->flags[p] & ANALYZE_LEADER) putchar('\n');
+        disasm_line(m, (uint16_t)p, line, NULL);
+        puts(line);
+    }
+}
+
+static void print_map(const RomAnalysis* a, size_t end) {
+    for (size_t line = PROGRAM_START_ADDRESS; line < end; line += 64) {
+        char buf[65];
+        size_t n = 0;
+        for (size_t p = line; p < end && n < 64; ++p, ++n) {
+            const uint8_t f = a->flags[p];
+            buf[n] = (f & ANALYZE_CODE) ? 'C' : (f & ANALYZE_OPERAND) ? 'c' : (f & ANALYZE_DATA_REF) ? 'D' : '.';
+        }
+        buf[n] = '\0';
+        printf("0x%03X %s\n", (unsigned)line, buf);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* argv0    = (argc > 0 ? argv[0] : "chip8_analyze");
+    const char* rom_path = NULL;
+    unsigned long entry  = PROGRAM_START_ADDRESS;
+    bool blocks = false;
+    bool map    = false;
+    bool disasm = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool ok = true;
+        if (strcmp(a, "--entry") == 0 && i + 1 < argc) {
+            char* end = NULL;
+            entry = strtoul(argv[++i], &end, 16);
+            ok = end && *end == '\0' && entry < MEMORY_SIZE;
+        }
+        else if (strcmp(a, "--blocks") == 0) blocks = true;
+        else if (strcmp(a, "--disasm") == 0) disasm = true;
+        else if (strcmp(a, "--map")    == 0) map = true;
+        else if (a[0] != '-' && !rom_path) rom_path = a;
+        else ok = false;
+
+        if (!ok) { usage(argv0); return 2; }
+    }
+    if (!rom_path) { usage(argv0); return 2; }
+
+    static struct Chip8 chip8;
+    chip8_init(&chip8);
+    Chip8Status st = chip8_load_rom(&chip8, rom_path);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Failed to load ROM: %s (%s)\n", rom_path, chip8_status_str(st));
+        chip8_destroy(&chip8);
+        return 3;
+    }
+
+    static RomAnalysis an;
+    st = rom_analyze(&chip8.chip8_mem, (uint16_t)entry, &an);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Analysis failed: %s\n", chip8_status_str(st));
+        chip8_destroy(&chip8);
+        return 3;
+    }
+
+    const size_t end = rom_end(&chip8.chip8_mem);
+    const size_t size = end - PROGRAM_START_ADDRESS;
+    size_t code_in_rom = 0;
+    for (size_t p = PROGRAM_START_ADDRESS; p < end; ++p) {
+        if (an.flags[p] & (ANALYZE_CODE | ANALYZE_OPERAND)) ++code_in_rom;
+    }
+
+    printf("rom=%s size=%zu code_bytes=%zu data_bytes=%zu instrs=%zu blocks=%zu indirect=%zu unknown=%zu\n",
+           rom_path, size, an.code_bytes, size - code_in_rom, an.instr_count, an.block_count,
+           an.indirect_count, an.unknown_count);
+    for (size_t p = 0; p < MEMORY_SIZE; ++p) {
+        if (an.flags[p] & ANALYZE_INDIRECT) printf("indirect jump at 0x%03X\n", (unsigned)p);
+        if (an.flags[p] & ANALYZE_UNKNOWN)  printf("unknown opcode at 0x%03X\n", (unsigned)p);
+    }
+    if (blocks) print_blocks(&an, &chip8.chip8_mem);
+    if (disasm) print_disasm(&an, &chip8.chip8_mem);
+    if (map) print_map(&an, end);
+
+    rom_analysis_free(&an);
+    chip8_destroy(&chip8);
+    return 0;
+}
@@ -0,0 +1,362 @@
+// tools/chip8_aot.c
+// Ahead-of-time translator: turns the reachable code of one or more ROMs into
+// a C source file with one run function per ROM plus an AotTable (see aot.h),
+// to be linked against chip8_core. Register, timer, I and flow-control
+// instructions are emitted inline; the rest call back into the interpreter's
+// handlers.
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "chip8.h"
+#include "chip8_status.h"
+#include "analyze.h"
+#include "aot.h"
+#include "instr.h"
+#include "quirks.h"
+#include "replay.h"   // input_log_rom_hash
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <rom>...\n"
+            "  --out PATH    write the C source to PATH (default stdout)\n"
+            "  --table NAME  name of the AotTable to define (default aot_table)\n"
+            "  --quirks P    profile to translate for: auto (ROM database, else\n"
+            "                default), default, vip, chip48, schip or xochip (default auto)\n",
+            argv0);
+}
+
+/* A unit under construction: instructions [start, start + bytes). */
+typedef struct {
+    uint16_t start;
+    uint16_t bytes;
+    uint16_t instrs;
+} Unit;
+
+/* Chip8Quirks enumerators, for the generated source. */
+static const char* const QUIRKS_ENUM[CHIP8_QUIRKS_COUNT] = {
+    [CHIP8_QUIRKS_DEFAULT] = "CHIP8_QUIRKS_DEFAULT",
+    [CHIP8_QUIRKS_VIP]     = "CHIP8_QUIRKS_VIP",
+    [CHIP8_QUIRKS_CHIP48]  = "CHIP8_QUIRKS_CHIP48",
+    [CHIP8_QUIRKS_SCHIP]   = "CHIP8_QUIRKS_SCHIP",
+    [CHIP8_QUIRKS_XOCHIP]  = "CHIP8_QUIRKS_XOCHIP",
+};
+
+static uint16_t peek_op(const Memory* m, uint16_t pc) {
+    return (uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1)));
+}
+
+static const char* base_name(const char* path) {
+    const char* b = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') b = p + 1;
+    }
+    return b;
+}
+
+/* True if the interpreter may fast-forward a wait loop entered at `pc`
+ * (chip8_idle_state): such units yield to it while idle skipping is on. */
+static bool idle_head(const Memory* m, uint16_t pc) {
+    const uint16_t op = peek_op(m, pc);
+    if (pc & 1u) return false;                                                            /* never skipped */
+    if (((op & 0xF000u) == 0x1000u && OP_NNN(op) == pc) || op == 0x00FDu) return true;   /* JP self, EXIT */
+    if ((op & 0xF0FFu) == 0xF00Au) return true;                                          /* LD Vx, K */
+    if ((op & 0xF0FFu) == 0xF007u && (size_t)pc + 5u < MEMORY_SIZE) {                     /* LD Vx, DT loop */
+        const uint16_t skip = peek_op(m, (uint16_t)(pc + 2)), jump = peek_op(m, (uint16_t)(pc + 4));
+        return jump == (0x1000u | pc) && OP_X(skip) == OP_X(op) &&
+               ((skip & 0xF000u) == 0x3000u || (skip & 0xF000u) == 0x4000u);
+    }
+    return false;
+}
+
+/* Cut the analysed blocks into units: a new unit starts after every
+ * instruction that ends a decode-cache block. Units outside the program
+ * area or past AOT_SPAN are dropped, and so are units sharing bytes with an
+ * earlier one (code reached at both parities): owner[] holds one unit per byte. */
+static size_t build_units(const RomAnalysis* a, const Memory* m, Chip8Quirks q, Unit* out) {
+    static bool owned[AOT_SPAN];
+    memset(owned, 0, sizeof(owned));
+    size_t n = 0;
+    for (size_t b = 0; b < a->block_count; ++b) {
+        const RomBlock* blk = &a->blocks[b];
+        Unit u = { blk->start, 0, 0 };
+        uint16_t pc = blk->start;
+        for (uint16_t i = 0; i < blk->instrs; ++i) {
+            const uint16_t op = peek_op(m, pc);
+            Instr in;
+            instr_decode_quirks(op, q, &in);
+            const uint16_t len = (op == 0xF000u) ? 4u : 2u;
+            u.bytes  = (uint16_t)(u.bytes + len);
+            u.instrs = (uint16_t)(u.instrs + 1);
+            pc = (uint16_t)(pc + len);
+
+            if (instr_ends_block(&in) || i + 1 == blk->instrs) {
+                bool usable = u.start >= PROGRAM_START_ADDRESS && (size_t)u.start + u.bytes <= AOT_SPAN;
+                for (uint16_t k = 0; usable && k < u.bytes; ++k) usable = !owned[u.start + k];
+                if (usable) {
+                    memset(&owned[u.start], 1, u.bytes);
+                    out[n++] = u;
+                }
+                u.start = pc;
+                u.bytes = 0;
+                u.instrs = 0;
+            }
+        }
+    }
+    return n;
+}
+
+/* One instruction as C. Inline forms mirror the handlers in instr.c
+ * statement for statement, with the profile's quirks resolved here. JP and
+ * CALL always end a unit and are emitted by emit_unit(). Returns true if
+ * the instruction always continues at the next one. */
+static bool emit_instr(FILE* out, const Memory* m, uint16_t pc, const QuirksProfile* p) {
+    const uint16_t op = peek_op(m, pc);
+    const unsigned x = OP_X(op), y = OP_Y(op), kk = OP_KK(op);
+    const InstrKind kind = instr_kind(op);
+
+    char text[INSTR_DISASM_MAX];
+    instr_disasm(op, text, sizeof(text));
+    fprintf(out, "    /* 0x%03X %04X  %s */\n", (unsigned)pc, (unsigned)op, text);
+    switch (kind) {
+    case INSTR_SYS:      break;
+    case INSTR_RET:      fprintf(out, "    (void)stack_pop(&c8->chip8_stack, r, &r->PC);\n"); return false;
+    case INSTR_SE_IMM:   fprintf(out, "    if (r->V[%u] == 0x%02X) aot_skip(r, &c8->chip8_mem);\n", x, kk); return false;
+    case INSTR_SNE_IMM:  fprintf(out, "    if (r->V[%u] != 0x%02X) aot_skip(r, &c8->chip8_mem);\n", x, kk); return false;
+    case INSTR_SE_REG:   fprintf(out, "    if (r->V[%u] == r->V[%u]) aot_skip(r, &c8->chip8_mem);\n", x, y); return false;
+    case INSTR_SNE_REG:  fprintf(out, "    if (r->V[%u] != r->V[%u]) aot_skip(r, &c8->chip8_mem);\n", x, y); return false;
+    case INSTR_LD_IMM:   fprintf(out, "    r->V[%u] = 0x%02X;\n", x, kk); break;
+    case INSTR_ADD_IMM:  fprintf(out, "    r->V[%u] = (uint8_t)(r->V[%u] + 0x%02X);\n", x, x, kk); break;
+    case INSTR_LD_REG:   fprintf(out, "    r->V[%u] = r->V[%u];\n", x, y); break;
+    case INSTR_OR: case INSTR_AND: case INSTR_XOR:
+        fprintf(out, "    r->V[%u] %c= r->V[%u];\n", x, kind == INSTR_OR ? '|' : kind == INSTR_AND ? '&' : '^', y);
+        if (p->vf_reset) fprintf(out, "    r->V[15] = 0;\n");
+        break;
+    case INSTR_ADD_REG:
+        fprintf(out, "    { const uint16_t sum = (uint16_t)(r->V[%u] + r->V[%u]);\n"
+                     "      r->V[15] = (uint8_t)(sum > 0xFF);\n"
+                     "      r->V[%u] = (uint8_t)sum; }\n", x, y, x);
+        break;
+    case INSTR_SUB:
+        fprintf(out, "    r->V[15] = (uint8_t)(r->V[%u] > r->V[%u]);\n"
+                     "    r->V[%u] = (uint8_t)(r->V[%u] - r->V[%u]);\n", x, y, x, x, y);
+        break;
+    case INSTR_SUBN:
+        fprintf(out, "    r->V[15] = (uint8_t)(r->V[%u] > r->V[%u]);\n"
+                     "    r->V[%u] = (uint8_t)(r->V[%u] - r->V[%u]);\n", y, x, x, y, x);
+        break;
+    case INSTR_SHR:
+        if (p->shift_vy) fprintf(out, "    { const uint8_t v = r->V[%u]; r->V[%u] = (uint8_t)(v >> 1); r->V[15] = (uint8_t)(v & 1); }\n", y, x);
+        else             fprintf(out, "    r->V[15] = (uint8_t)(r->V[%u] & 1);\n    r->V[%u] >>= 1;\n", x, x);
+        break;
+    case INSTR_SHL:
+        if (p->shift_vy) fprintf(out, "    { const uint8_t v = r->V[%u]; r->V[%u] = (uint8_t)(v << 1); r->V[15] = (uint8_t)(v >> 7); }\n", y, x);
+        else             fprintf(out, "    r->V[15] = (uint8_t)(r->V[%u] >> 7);\n    r->V[%u] = (uint8_t)(r->V[%u] << 1);\n", x, x, x);
+        break;
+    case INSTR_LD_I:     fprintf(out, "    r->I = 0x%03X;\n", (unsigned)OP_NNN(op)); break;
+    case INSTR_RND:      fprintf(out, "    r->V[%u] = (uint8_t)((rng_next(&r->rng) & 0xFF) & 0x%02X);\n", x, kk); break;
+    case INSTR_LD_VX_DT: fprintf(out, "    r->V[%u] = r->DT;\n", x); break;
+    case INSTR_LD_DT:    fprintf(out, "    r->DT = r->V[%u];\n", x); break;
+    case INSTR_LD_ST:    fprintf(out, "    r->ST = r->V[%u];\n", x); break;
+    case INSTR_ADD_I:    fprintf(out, "    r->I = (uint16_t)(r->I + r->V[%u]);\n", x); break;
+    case INSTR_LD_F:     fprintf(out, "    r->I = (uint16_t)(FONT_START_ADDR + (r->V[%u] & 0x0F) * DEFAULT_SPRITE_HIGHT);\n", x); break;
+    case INSTR_LD_HF:    fprintf(out, "    r->I = (uint16_t)(BIG_FONT_START_ADDR + (r->V[%u] & 0x0F) * BIG_SPRITE_HEIGHT);\n", x); break;
+    case INSTR_PITCH:    fprintf(out, "    r->pitch = r->V[%u];\n", x); break;
+    default:
+        /* the handler may move PC (Fx0A, EXIT, F000) or start a display wait */
+        fprintf(out, "    aot_exec(c8, 0x%04X);\n", (unsigned)op);
+        return false;
+    }
+    return true;
+}
+
+/* Continue at `addr`: straight to its label if it starts a unit. */
+static void emit_goto(FILE* out, const uint16_t* entry, uint16_t addr) {
+    if (addr < AOT_SPAN && entry[addr]) fprintf(out, "    goto u_%03X;\n", (unsigned)addr);
+    else                                fprintf(out, "    goto out;\n");
+}
+
+/* Unit `k`: the entry check, then its instructions, then where to go next. */
+static void emit_unit(FILE* out, const Memory* m, const Unit* u, size_t k, const uint16_t* entry,
+                      const QuirksProfile* p) {
+    fprintf(out, "\nu_%03X:\n", (unsigned)u->start);
+    if (idle_head(m, u->start)) fprintf(out, "    if (c8->chip8_skip_idle) goto out;\n");
+    fprintf(out, "    if (left < %u || state[%zu] != AOT_UNIT_LIVE) goto out;\n", (unsigned)u->instrs, k);
+    fprintf(out, "    left -= %u;\n", (unsigned)u->instrs);
+    fprintf(out, "    r->PC = 0x%03X;\n", (unsigned)(u->start + 2u * u->instrs));
+
+    uint16_t pc = u->start;
+    for (uint16_t i = 0; i + 1 < u->instrs; ++i) {
+        (void)emit_instr(out, m, pc, p);
+        pc = (uint16_t)(pc + 2);   /* only a unit's last instruction can be F000 nnnn */
+    }
+
+    const uint16_t op = peek_op(m, pc);
+    const uint16_t nnn = OP_NNN(op);
+    switch (instr_kind(op)) {
+    case INSTR_JP:
+        fprintf(out, "    /* 0x%03X %04X  JP 0x%03X */\n", (unsigned)pc, (unsigned)op, (unsigned)nnn);
+        fprintf(out, "    r->PC = 0x%03X;\n", (unsigned)nnn);
+        emit_goto(out, entry, nnn);
+        break;
+    case INSTR_CALL:
+        fprintf(out, "    /* 0x%03X %04X  CALL 0x%03X */\n", (unsigned)pc, (unsigned)op, (unsigned)nnn);
+        fprintf(out, "    if (stack_push(&c8->chip8_stack, r, r->PC) != CHIP8_OK) goto dispatch;\n");
+        fprintf(out, "    r->PC = 0x%03X;\n", (unsigned)nnn);
+        emit_goto(out, entry, nnn);
+        break;
+    default:
+        if (emit_instr(out, m, pc, p)) emit_goto(out, entry, (uint16_t)(u->start + u->bytes));
+        else                           fprintf(out, "    goto dispatch;\n");
+        break;
+    }
+}
+
+/* Emit one ROM as module `idx`; returns false if it cannot be loaded. */
+static bool emit_module(FILE* out, size_t idx, const char* path, bool quirks_auto, Chip8Quirks quirks) {
+    static struct Chip8 c8;
+    chip8_init(&c8);
+    Chip8Status st = chip8_load_rom(&c8, path);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Failed to load ROM: %s (%s)\n", path, chip8_status_str(st));
+        chip8_destroy(&c8);
+        return false;
+    }
+    const Memory* m = &c8.chip8_mem;
+    const Chip8Quirks q = quirks_auto ? chip8_detect_quirks(&c8) : quirks;
+    const QuirksProfile* p = quirks_profile(q);
+
+    static RomAnalysis an;
+    st = rom_analyze(m, PROGRAM_START_ADDRESS, &an);
+    static Unit units[AOT_MAX_UNITS];
+    const size_t n = (st == CHIP8_OK) ? build_units(&an, m, q, units) : 0;
+    rom_analysis_free(&an);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Analysis failed: %s (%s)\n", path, chip8_status_str(st));
+        chip8_destroy(&c8);
+        return false;
+    }
+
+    /* The image covers the ROM and every unit, so all of them can be verified. */
+    size_t end = PROGRAM_START_ADDRESS;
+    for (size_t a = PROGRAM_START_ADDRESS; a < MEMORY_SIZE; ++a) {
+        if (memory_peek(m, (uint16_t)a) != 0) end = a + 1;
+    }
+    if (end == PROGRAM_START_ADDRESS) end++;   /* all-zero ROM: keep the array non-empty */
+    for (size_t i = 0; i < n; ++i) {
+        if ((size_t)units[i].start + units[i].bytes > end) end = (size_t)units[i].start + units[i].bytes;
+    }
+
+    static uint16_t entry[AOT_SPAN];
+    memset(entry, 0, sizeof(entry));
+    for (size_t i = 0; i < n; ++i) entry[units[i].start] = (uint16_t)(i + 1);
+
+    fprintf(out, "\n/* ---------- %s (%s, %zu units) ---------- */\n", base_name(path), p->name, n);
+    if (n > 0) {
+        fprintf(out, "\nstatic uint32_t rom%zu_run(struct Chip8* c8, const uint32_t budget) {\n"
+                     "    Registers* const r = &c8->chip8_regs;\n"
+                     "    const uint8_t* const state = c8->chip8_aot_state;\n"
+                     "    uint32_t left = budget;\n"
+                     "\ndispatch:\n"
+                     "    if (r->vblank_wait) goto out;\n"
+                     "    switch (r->PC) {\n", idx);
+        for (size_t i = 0; i < n; ++i) {
+            fprintf(out, "    case 0x%03X: goto u_%03X;\n", (unsigned)units[i].start, (unsigned)units[i].start);
+        }
+        fprintf(out, "    default: goto out;\n    }\n");
+        for (size_t i = 0; i < n; ++i) emit_unit(out, m, &units[i], i, entry, p);
+        fprintf(out, "\nout:\n    return budget - left;\n}\n");
+    }
+
+    fprintf(out, "\nstatic const uint8_t rom%zu_image[] = {", idx);
+    for (size_t a = PROGRAM_START_ADDRESS; a < end; ++a) {
+        if ((a - PROGRAM_START_ADDRESS) % 16 == 0) fprintf(out, "\n   ");
+        fprintf(out, " 0x%02X,", memory_peek(m, (uint16_t)a));
+    }
+    fprintf(out, "\n};\n");
+
+    /* C has no empty initialisers: a ROM with no usable unit gets NULL tables. */
+    if (n > 0) {
+        fprintf(out, "\nstatic const AotUnit rom%zu_units[] = {\n", idx);
+        for (size_t i = 0; i < n; ++i) {
+            fprintf(out, "    { 0x%03X, %u, %u },\n", (unsigned)units[i].start,
+                    (unsigned)units[i].bytes, (unsigned)units[i].instrs);
+        }
+        fprintf(out, "};\n");
+
+        fprintf(out, "\nstatic const uint16_t rom%zu_entry[AOT_SPAN] = {\n", idx);
+        for (size_t i = 0; i < n; ++i) fprintf(out, "    [0x%03X] = %zu,\n", (unsigned)units[i].start, i + 1);
+        fprintf(out, "};\n");
+
+        fprintf(out, "\nstatic const uint16_t rom%zu_owner[AOT_SPAN] = {", idx);
+        for (size_t i = 0; i < n; ++i) {
+            fprintf(out, "\n   ");
+            for (unsigned a = units[i].start; a < (unsigned)units[i].start + units[i].bytes; ++a) {
+                fprintf(out, " [0x%03X] = %zu,", a, i + 1);
+            }
+        }
+        fprintf(out, "\n};\n");
+    }
+
+    fprintf(out, "\nstatic const AotModule rom%zu = {\n"
+                 "    \"%s\", 0x%016llxull, %s,\n"
+                 "    rom%zu_image, sizeof(rom%zu_image),\n",
+            idx, base_name(path), (unsigned long long)input_log_rom_hash(m), QUIRKS_ENUM[q], idx, idx);
+    if (n > 0) fprintf(out, "    rom%zu_units, %zu, rom%zu_entry, rom%zu_owner, rom%zu_run,\n};\n", idx, n, idx, idx, idx);
+    else       fprintf(out, "    NULL, 0, NULL, NULL, NULL,\n};\n");
+
+    chip8_destroy(&c8);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* argv0    = (argc > 0 ? argv[0] : "chip8_aot");
+    const char* out_path = NULL;
+    const char* table    = "aot_table";
+    const char* quirks_name = "auto";
+    const char* roms[256];
+    size_t rom_count = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool ok = true;
+        if      (strcmp(a, "--out")    == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(a, "--table")  == 0 && i + 1 < argc) table = argv[++i];
+        else if (strcmp(a, "--quirks") == 0 && i + 1 < argc) quirks_name = argv[++i];
+        else if (a[0] != '-' && rom_count < sizeof(roms) / sizeof(roms[0])) roms[rom_count++] = a;
+        else ok = false;
+
+        if (!ok) { usage(argv0); return 2; }
+    }
+    const bool quirks_auto = strcmp(quirks_name, "auto") == 0;
+    Chip8Quirks quirks = CHIP8_QUIRKS_DEFAULT;
+    if (rom_count == 0 || (!quirks_auto && !quirks_from_name(quirks_name, &quirks))) { usage(argv0); return 2; }
+
+    FILE* out = stdout;
+    if (out_path && !(out = fopen(out_path, "w"))) {
+        fprintf(stderr, "Cannot write %s\n", out_path);
+        return 3;
+    }
+
+    fprintf(out, "/* Generated by chip8_aot; do not edit. */\n"
+                 "#include \"chip8.h\"\n"
+                 "#include \"aot.h\"\n"
+                 "#include \"stack.h\"\n");
+    bool ok = true;
+    for (size_t i = 0; i < rom_count && ok; ++i) ok = emit_module(out, i, roms[i], quirks_auto, quirks);
+
+    if (ok) {
+        fprintf(out, "\nstatic const AotModule* const %s_modules[] = {\n", table);
+        for (size_t i = 0; i < rom_count; ++i) fprintf(out, "    &rom%zu,\n", i);
+        fprintf(out, "};\n\nconst AotTable %s = { %s_modules, %zu };\n", table, table, rom_count);
+    }
+
+    if (out != stdout && fclose(out) != 0) ok = false;
+    if (!ok) {
+        if (out_path) remove(out_path);
+        return 3;
+    }
+    return 0;
+}
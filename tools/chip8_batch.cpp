@@ -0,0 +1,308 @@
+// tools/chip8_batch.cpp
+// Batch ROM runner: executes every ROM in a directory (optionally several
+// seeds each) for a fixed cycle budget on all cores, and reports per-run
+// results as CSV or JSON. Each worker owns its own struct Chip8.
+//
+// Written in C++17 for portable threads and directory iteration; the
+// emulator itself is the C core (chip8_core).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "config.h"
+#include "chip8.h"
+#include "chip8_status.h"
+#include "aot.h"
+#include "replay.h"   // input_log_rom_hash
+#include "screen.h"
+}
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Job {
+    std::string rom;
+    uint32_t    seed = 0;
+};
+
+struct Result {
+    uint64_t    cycles  = 0;
+    uint64_t    hash    = 0;
+    double      wall_ms = 0.0;
+    Chip8Status status  = CHIP8_OK;
+};
+
+struct Options {
+    std::string dir;
+    uint64_t    cycles  = 1000000;
+    uint64_t    hz      = CPU_CLOCK_HZ;
+    uint32_t    seeds   = 1;
+    unsigned    threads = 0;          // 0 = hardware concurrency
+    bool        json    = false;
+    std::string out;                  // empty = stdout
+    bool        quirks_auto = true;   // per-ROM profile from the ROM database
+    Chip8Quirks quirks  = CHIP8_QUIRKS_DEFAULT;
+    bool        aot     = false;      // run the ROM's translation from aot_games
+};
+
+/* ---------- work-stealing pool ---------- */
+
+// One deque per worker: the owner pops from the back, thieves take from the
+// front. Jobs are coarse (a whole ROM run), so a mutex per deque is enough.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned workers) : queues_(workers) {}
+
+    void push(unsigned worker, size_t job) {
+        std::lock_guard<std::mutex> lk(queues_[worker].mu);
+        queues_[worker].jobs.push_back(job);
+    }
+
+    template <class Fn>
+    void run(Fn&& fn) {
+        std::vector<std::thread> threads;
+        threads.reserve(queues_.size());
+        for (unsigned w = 0; w < queues_.size(); ++w) {
+            threads.emplace_back([this, w, &fn] {
+                size_t job = 0;
+                while (pop_or_steal(w, job)) fn(w, job);
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+
+private:
+    struct Queue {
+        std::mutex         mu;
+        std::deque<size_t> jobs;
+    };
+
+    bool pop_or_steal(unsigned w, size_t& out) {
+        {
+            Queue& q = queues_[w];
+            std::lock_guard<std::mutex> lk(q.mu);
+            if (!q.jobs.empty()) { out = q.jobs.back(); q.jobs.pop_back(); return true; }
+        }
+        // Jobs are only queued before run(), so one empty sweep means done.
+        for (size_t i = 1; i < queues_.size(); ++i) {
+            Queue& victim = queues_[(w + i) % queues_.size()];
+            std::lock_guard<std::mutex> lk(victim.mu);
+            if (!victim.jobs.empty()) { out = victim.jobs.front(); victim.jobs.pop_front(); return true; }
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues_;
+};
+
+/* ---------- one run ---------- */
+
+Result run_one(struct Chip8* c8, const Options& opt, const Job& job) {
+    Result r;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    chip8_init(c8);
+    chip8_seed(c8, job.seed);
+    r.status = chip8_load_rom(c8, job.rom.c_str());
+    if (r.status == CHIP8_OK) {
+        c8->chip8_regs.PC = PROGRAM_START_ADDRESS;
+        chip8_set_quirks(c8, opt.quirks_auto ? chip8_detect_quirks(c8) : opt.quirks);
+#ifdef CHIP8_AOT_GAMES
+        if (opt.aot) chip8_set_aot(c8, aot_find(&aot_games, input_log_rom_hash(&c8->chip8_mem)));
+#endif
+
+        uint32_t per_frame = (uint32_t)std::max<uint64_t>(1, opt.hz / TIMER_CLOCK_HZ);
+        uint64_t left = opt.cycles;
+        while (left > 0) {
+            uint32_t ran = 0;
+            if (left >= per_frame) {
+                r.status = chip8_run_frame(c8, per_frame, &ran);
+            } else {
+                r.status = chip8_run_blocks(c8, (uint32_t)left, &ran);
+            }
+            r.cycles += ran;
+            left     -= ran;
+            if (r.status != CHIP8_OK) break;
+        }
+    }
+
+    r.hash = screen_hash(&c8->chip8_disp);
+    chip8_destroy(c8);
+    r.wall_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+/* ---------- output ---------- */
+
+std::string json_escape(const std::string& s) {
+    std::string o;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') { o += '\\'; o += ch; }
+        else if ((unsigned char)ch < 0x20) { char b[8]; snprintf(b, sizeof(b), "\\u%04x", ch); o += b; }
+        else o += ch;
+    }
+    return o;
+}
+
+std::string csv_escape(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string o = "\"";
+    for (char ch : s) { if (ch == '"') o += '"'; o += ch; }
+    return o + "\"";
+}
+
+void write_results(FILE* f, const Options& opt,
+                   const std::vector<Job>& jobs, const std::vector<Result>& res) {
+    if (opt.json) fprintf(f, "[\n");
+    else          fprintf(f, "rom,seed,cycles,status,fb_hash,wall_ms\n");
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const Job& j = jobs[i];
+        const Result& r = res[i];
+        if (opt.json) {
+            fprintf(f, "  {\"rom\": \"%s\", \"seed\": %u, \"cycles\": %llu, \"status\": \"%s\", "
+                       "\"fb_hash\": \"%016llx\", \"wall_ms\": %.3f}%s\n",
+                    json_escape(j.rom).c_str(), j.seed, (unsigned long long)r.cycles,
+                    chip8_status_str(r.status), (unsigned long long)r.hash, r.wall_ms,
+                    (i + 1 < jobs.size()) ? "," : "");
+        } else {
+            fprintf(f, "%s,%u,%llu,%s,%016llx,%.3f\n",
+                    csv_escape(j.rom).c_str(), j.seed, (unsigned long long)r.cycles,
+                    csv_escape(chip8_status_str(r.status)).c_str(),
+                    (unsigned long long)r.hash, r.wall_ms);
+        }
+    }
+    if (opt.json) fprintf(f, "]\n");
+}
+
+/* ---------- CLI ---------- */
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <rom-directory>\n"
+            "  --cycles N       cycle budget per run (default 1000000)\n"
+            "  --hz N           CPU cycles per second, sets cycles per 60 Hz frame (default %d)\n"
+            "  --seeds N        runs per ROM, seeds 0..N-1 (default 1)\n"
+            "  --threads N      worker threads (default: all cores)\n"
+            "  --format F       csv | json (default csv)\n"
+            "  --out PATH       write results to PATH instead of stdout\n"
+            "  --quirks P       auto (ROM database, the default), default, vip, chip48,\n"
+            "                   schip or xochip\n"
+            "  --aot            run each ROM's ahead-of-time translation where one was\n"
+            "                   built (ROM/GAMES, -DCHIP8_BUILD_AOT=ON); others interpret\n",
+            argv0, CPU_CLOCK_HZ);
+}
+
+bool parse_u64(const char* s, uint64_t& out) {
+    if (!s || !*s) return false;
+    char* end = nullptr;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (!end || *end != '\0') return false;
+    out = (uint64_t)v;
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        uint64_t n = 0;
+        if      (!strcmp(a, "--cycles")  && parse_u64(v, n)) { opt.cycles = n; ++i; }
+        else if (!strcmp(a, "--hz")      && parse_u64(v, n) && n) { opt.hz = n; ++i; }
+        else if (!strcmp(a, "--seeds")   && parse_u64(v, n) && n) { opt.seeds = (uint32_t)n; ++i; }
+        else if (!strcmp(a, "--threads") && parse_u64(v, n)) { opt.threads = (unsigned)n; ++i; }
+        else if (!strcmp(a, "--format")  && v && (!strcmp(v, "csv") || !strcmp(v, "json"))) {
+            opt.json = !strcmp(v, "json"); ++i;
+        }
+        else if (!strcmp(a, "--out") && v) { opt.out = v; ++i; }
+        else if (!strcmp(a, "--quirks") && v && (!strcmp(v, "auto") || quirks_from_name(v, &opt.quirks))) {
+            opt.quirks_auto = !strcmp(v, "auto"); ++i;
+        }
+        else if (!strcmp(a, "--aot")) opt.aot = true;
+        else if (a[0] != '-' && opt.dir.empty()) opt.dir = a;
+        else return false;
+    }
+    return !opt.dir.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* argv0 = (argc > 0 ? argv[0] : "chip8_batch");
+    Options opt;
+    if (!parse_args(argc, argv, opt)) { usage(argv0); return 2; }
+#ifndef CHIP8_AOT_GAMES
+    if (opt.aot) {
+        fprintf(stderr, "--aot: no translated ROMs built in (configure with -DCHIP8_BUILD_AOT=ON)\n");
+        return 2;
+    }
+#endif
+
+    // Collect *.ch8 files; sorted so output order is stable across runs.
+    std::vector<std::string> roms;
+    std::error_code ec;
+    for (const auto& e : fs::directory_iterator(opt.dir, ec)) {
+        if (e.is_regular_file() && e.path().extension() == ".ch8") roms.push_back(e.path().string());
+    }
+    if (ec) {
+        fprintf(stderr, "Cannot read directory: %s (%s)\n", opt.dir.c_str(), ec.message().c_str());
+        return 3;
+    }
+    std::sort(roms.begin(), roms.end());
+
+    std::vector<Job> jobs;
+    for (const auto& rom : roms) {
+        for (uint32_t s = 0; s < opt.seeds; ++s) jobs.push_back(Job{rom, s});
+    }
+
+    unsigned workers = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    workers = (unsigned)std::max<size_t>(1, std::min<size_t>(workers, jobs.size()));
+
+    WorkStealingPool pool(workers);
+    for (size_t i = 0; i < jobs.size(); ++i) pool.push((unsigned)(i % workers), i);
+
+    // One emulator per worker, reused across that worker's jobs.
+    std::vector<std::unique_ptr<struct Chip8>> machines;
+    for (unsigned w = 0; w < workers; ++w) machines.emplace_back(new struct Chip8());
+
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> failures{0};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    pool.run([&](unsigned w, size_t job) {
+        results[job] = run_one(machines[w].get(), opt, jobs[job]);
+        if (results[job].status != CHIP8_OK) failures.fetch_add(1, std::memory_order_relaxed);
+    });
+    const double total_ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - t0).count();
+
+    FILE* f = stdout;
+    if (!opt.out.empty()) {
+#ifdef _MSC_VER
+        if (fopen_s(&f, opt.out.c_str(), "w") != 0) f = nullptr;
+#else
+        f = fopen(opt.out.c_str(), "w");
+#endif
+        if (!f) { fprintf(stderr, "Cannot open output: %s\n", opt.out.c_str()); return 3; }
+    }
+    write_results(f, opt, jobs, results);
+    if (f != stdout) fclose(f);
+
+    fprintf(stderr, "%zu runs on %u threads in %.1f ms, %zu failed\n",
+            jobs.size(), workers, total_ms, failures.load());
+    return failures.load() ? 4 : 0;
+}
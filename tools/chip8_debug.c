@@ -0,0 +1,309 @@
+// tools/chip8_debug.c
+// Command-line debugger: runs a ROM headless under debug_run() and takes
+// gdb-like commands (breakpoints, conditional breakpoints, watchpoints,
+// stepping, registers, memory and disassembly) from --ex and then stdin.
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "chip8.h"
+#include "chip8_status.h"
+#include "debug.h"
+#include "disasm.h"
+#include "quirks.h"
+#include "timer.h"
+
+#define MAX_EX    16
+#define MAX_ARGS  8
+#define DEFAULT_CONTINUE_FRAMES 3600u   /* one emulated minute per "continue" */
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <path/to/rom>\n"
+            "  --hz N       CPU cycles per second (default %d)\n"
+            "  --quirks P   quirks profile: auto (ROM database, else default), default,\n"
+            "               vip, chip48, schip or xochip (default auto)\n"
+            "  --ex CMD     run CMD before reading commands from stdin (repeatable)\n"
+            "Type \"help\" at the prompt for the commands.\n",
+            argv0, CPU_CLOCK_HZ);
+}
+
+static void help(void) {
+    puts("break ADDR [if REG OP VALUE]  stop before even ADDR (REG: V0-VF, I, DT, ST; OP: == != < <= > >=)\n"
+         "delete ADDR                   remove the breakpoint at ADDR\n"
+         "watch ADDR [LEN]              stop before a write to [ADDR, ADDR+LEN) (Fx33, Fx55, 5xy2)\n"
+         "rwatch ADDR [LEN]             stop before a read of it (Dxyn, Fx65, 5xy3, F002)\n"
+         "awatch ADDR [LEN]             stop before either\n"
+         "unwatch ADDR [LEN]            stop watching it\n"
+         "info                          list breakpoints and watched bytes\n"
+         "continue [FRAMES]             run until a stop (at most FRAMES 60 Hz frames, default 3600)\n"
+         "step [N]                      execute N instructions (default 1)\n"
+         "regs                          print the registers\n"
+         "x ADDR [LEN]                  dump LEN bytes of RAM (default 16)\n"
+         "list [ADDR [N]]               disassemble N instructions (default: 8 at PC)\n"
+         "quit\n"
+         "Addresses are hex; values are decimal, or hex with 0x.");
+}
+
+typedef struct {
+    struct Chip8 c8;
+    Debugger     dbg;
+    uint32_t     cycles_per_frame;
+    uint32_t     frame_left;   /* cycles until the next timer tick */
+    uint64_t     cycles;
+} Session;
+
+/* ---------- parsing ---------- */
+
+static bool parse_num(const char* s, int base, unsigned long* out) {
+    if (!s || !*s) return false;
+    char* end = NULL;
+    *out = strtoul(s, &end, base);
+    return end && *end == '\0';
+}
+
+static bool parse_addr(const char* s, uint16_t* out) {
+    unsigned long v;
+    if (!parse_num(s, 16, &v) || v >= MEMORY_SIZE) return false;
+    *out = (uint16_t)v;
+    return true;
+}
+
+static bool parse_reg(const char* s, uint8_t* out) {
+    if      (strcmp(s, "I")  == 0) *out = DEBUG_REG_I;
+    else if (strcmp(s, "DT") == 0) *out = DEBUG_REG_DT;
+    else if (strcmp(s, "ST") == 0) *out = DEBUG_REG_ST;
+    else if ((s[0] == 'V' || s[0] == 'v') && s[1] && !s[2]) {
+        unsigned long v;
+        if (!parse_num(s + 1, 16, &v)) return false;
+        *out = (uint8_t)v;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parse_cmp(const char* s, uint8_t* out) {
+    static const char* const names[] = { "", "==", "!=", "<", "<=", ">", ">=" };
+    for (uint8_t k = DEBUG_CMP_EQ; k <= DEBUG_CMP_GE; ++k) {
+        if (strcmp(s, names[k]) == 0) { *out = k; return true; }
+    }
+    return false;
+}
+
+static const char* reg_name(uint8_t reg) {
+    static const char* const v[16] = { "V0", "V1", "V2", "V3", "V4", "V5", "V6", "V7",
+                                       "V8", "V9", "VA", "VB", "VC", "VD", "VE", "VF" };
+    if (reg == DEBUG_REG_I)  return "I";
+    if (reg == DEBUG_REG_DT) return "DT";
+    if (reg == DEBUG_REG_ST) return "ST";
+    return v[reg & 0x0Fu];
+}
+
+/* ---------- output ---------- */
+
+static void print_where(const Session* s) {
+    char line[DISASM_LINE_MAX];
+    (void)disasm_line(&s->c8.chip8_mem, s->c8.chip8_regs.PC, line, NULL);
+    printf("%s\n", line);
+}
+
+static void print_regs(const Session* s) {
+    const Registers* r = &s->c8.chip8_regs;
+    for (int k = 0; k < NUM_REGS; ++k) printf("V%X=%02X%c", k, r->V[k], (k % 8 == 7) ? '\n' : ' ');
+    printf("I=%04X PC=%04X SP=%X DT=%02X ST=%02X cycle=%llu\n", r->I, r->PC, r->SP, r->DT, r->ST,
+           (unsigned long long)s->cycles);
+}
+
+static void print_info(const Session* s) {
+    const Debugger* d = &s->dbg;
+    if (d->break_count == 0) puts("no breakpoints");
+    for (size_t k = 0; k < d->break_count; ++k) {
+        const DebugBreak* b = &d->breaks[k];
+        static const char* const cmp[] = { "", "==", "!=", "<", "<=", ">", ">=" };
+        if (b->cond.cmp == DEBUG_CMP_NONE) printf("break 0x%03X\n", (unsigned)b->addr);
+        else printf("break 0x%03X if %s %s %u\n", (unsigned)b->addr, reg_name(b->cond.reg),
+                    cmp[b->cond.cmp], (unsigned)b->cond.value);
+    }
+    printf("%zu bytes watched\n", d->watch_count);
+}
+
+static void print_stop(const Session* s, const DebugEvent* ev, Chip8Status st) {
+    switch (ev->reason) {
+    case DEBUG_STOP_BREAK:       printf("Breakpoint at 0x%03X\n", (unsigned)ev->pc); break;
+    case DEBUG_STOP_WATCH_READ:  printf("Read of 0x%03X at 0x%03X\n", (unsigned)ev->addr, (unsigned)ev->pc); break;
+    case DEBUG_STOP_WATCH_WRITE: printf("Write of 0x%03X at 0x%03X\n", (unsigned)ev->addr, (unsigned)ev->pc); break;
+    case DEBUG_STOP_NONE:        break;
+    }
+    if (st != CHIP8_OK) printf("Stopped: %s\n", chip8_status_str(st));
+    print_where(s);
+}
+
+/* ---------- running ---------- */
+
+/* Run up to `cycles` cycles in 60 Hz frames until something stops it. */
+static Chip8Status run(Session* s, uint64_t cycles, DebugEvent* ev) {
+    ev->reason = DEBUG_STOP_NONE;
+    while (cycles > 0) {
+        uint32_t budget = s->frame_left;
+        if (budget > cycles) budget = (uint32_t)cycles;
+        uint32_t ran = 0;
+        const Chip8Status st = debug_run(&s->dbg, &s->c8, budget, &ran, ev);
+        s->cycles     += ran;
+        s->frame_left -= ran;
+        cycles        -= ran;
+        if (s->frame_left == 0) {
+            regs_tick_frame(&s->c8.chip8_regs);
+            s->frame_left = s->cycles_per_frame;
+        }
+        if (st != CHIP8_OK || ev->reason != DEBUG_STOP_NONE) return st;
+    }
+    return CHIP8_OK;
+}
+
+/* ---------- commands ---------- */
+
+static bool cmd_is(const char* a, const char* full, const char* abbrev) {
+    return strcmp(a, full) == 0 || (abbrev && strcmp(a, abbrev) == 0);
+}
+
+/* Execute one command line; returns false on "quit". */
+static bool execute(Session* s, char* line) {
+    char* argv[MAX_ARGS];
+    int argc = 0;
+    for (char* t = strtok(line, " \t\r\n"); t && argc < MAX_ARGS; t = strtok(NULL, " \t\r\n")) argv[argc++] = t;
+    if (argc == 0) return true;
+
+    const char* c = argv[0];
+    uint16_t addr = 0;
+    unsigned long n = 0;
+
+    if (cmd_is(c, "quit", "q")) return false;
+    if (cmd_is(c, "help", "h")) {
+        help();
+    } else if (cmd_is(c, "break", "b")) {
+        DebugCond cond = { 0, DEBUG_CMP_NONE, 0 };
+        const bool cond_ok = argc == 2 ||
+            (argc == 6 && strcmp(argv[2], "if") == 0 && parse_reg(argv[3], &cond.reg) &&
+             parse_cmp(argv[4], &cond.cmp) && parse_num(argv[5], 0, &n) && n <= 0xFFFFu);
+        if (argc < 2 || !parse_addr(argv[1], &addr) || !cond_ok) { puts("usage: break ADDR [if REG OP VALUE]"); return true; }
+        cond.value = (uint16_t)n;
+        const Chip8Status st = debug_set_break(&s->dbg, addr, &cond);
+        if (st != CHIP8_OK) printf("break: %s\n", chip8_status_str(st));
+        else printf("Breakpoint at 0x%03X\n", (unsigned)addr);
+    } else if (cmd_is(c, "delete", "d")) {
+        if (argc != 2 || !parse_addr(argv[1], &addr)) { puts("usage: delete ADDR"); return true; }
+        if (!debug_clear_break(&s->dbg, addr)) printf("No breakpoint at 0x%03X\n", (unsigned)addr);
+    } else if (cmd_is(c, "watch", NULL) || cmd_is(c, "rwatch", NULL) || cmd_is(c, "awatch", NULL) ||
+               cmd_is(c, "unwatch", NULL)) {
+        n = 1;
+        if (argc < 2 || argc > 3 || !parse_addr(argv[1], &addr) || (argc == 3 && !parse_num(argv[2], 0, &n))) {
+            printf("usage: %s ADDR [LEN]\n", c);
+            return true;
+        }
+        const unsigned kinds = (c[0] == 'w') ? DEBUG_WATCH_WRITE
+                             : (c[0] == 'r') ? DEBUG_WATCH_READ
+                             : DEBUG_WATCH_READ | DEBUG_WATCH_WRITE;
+        const Chip8Status st = debug_watch(&s->dbg, addr, n, kinds, c[0] != 'u');
+        if (st != CHIP8_OK) printf("%s: %s\n", c, chip8_status_str(st));
+    } else if (cmd_is(c, "info", "i")) {
+        print_info(s);
+    } else if (cmd_is(c, "continue", "c") || cmd_is(c, "step", "s")) {
+        const bool step = c[0] == 's';
+        n = step ? 1 : DEFAULT_CONTINUE_FRAMES;
+        if (argc > 2 || (argc == 2 && (!parse_num(argv[1], 10, &n) || n == 0))) {
+            printf("usage: %s\n", step ? "step [N]" : "continue [FRAMES]");
+            return true;
+        }
+        DebugEvent ev;
+        const Chip8Status st = run(s, step ? (uint64_t)n : (uint64_t)n * s->cycles_per_frame, &ev);
+        print_stop(s, &ev, st);
+    } else if (cmd_is(c, "regs", "r")) {
+        print_regs(s);
+    } else if (cmd_is(c, "x", NULL)) {
+        n = 16;
+        if (argc < 2 || argc > 3 || !parse_addr(argv[1], &addr) || (argc == 3 && !parse_num(argv[2], 0, &n))) {
+            puts("usage: x ADDR [LEN]");
+            return true;
+        }
+        if (n > MEMORY_SIZE - (size_t)addr) n = MEMORY_SIZE - (size_t)addr;
+        dump_n(&s->c8, addr, n, 8);
+    } else if (cmd_is(c, "list", "l")) {
+        addr = s->c8.chip8_regs.PC;
+        n = 8;
+        if (argc > 3 || (argc >= 2 && !parse_addr(argv[1], &addr)) || (argc == 3 && !parse_num(argv[2], 0, &n))) {
+            puts("usage: list [ADDR [N]]");
+            return true;
+        }
+        for (; n > 0; --n) {
+            char text[DISASM_LINE_MAX];
+            const size_t len = disasm_line(&s->c8.chip8_mem, addr, text, NULL);
+            if (len == 0) break;
+            printf("%s%s\n", debug_has_break(&s->dbg, addr) ? "*" : " ", text);
+            if ((size_t)addr + len >= MEMORY_SIZE) break;
+            addr = (uint16_t)(addr + len);
+        }
+    } else {
+        printf("Unknown command \"%s\"; try \"help\".\n", c);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* argv0    = (argc > 0 ? argv[0] : "chip8_debug");
+    const char* rom_path = NULL;
+    const char* quirks_name = "auto";
+    const char* ex[MAX_EX];
+    int ex_count = 0;
+    unsigned long cpu_hz = CPU_CLOCK_HZ;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool ok = true;
+        if      (strcmp(a, "--hz")     == 0 && i + 1 < argc) ok = parse_num(argv[++i], 10, &cpu_hz) && cpu_hz > 0;
+        else if (strcmp(a, "--quirks") == 0 && i + 1 < argc) quirks_name = argv[++i];
+        else if (strcmp(a, "--ex")     == 0 && i + 1 < argc) { ok = ex_count < MAX_EX; if (ok) ex[ex_count++] = argv[++i]; }
+        else if (a[0] != '-' && !rom_path) rom_path = a;
+        else ok = false;
+
+        if (!ok) { usage(argv0); return 2; }
+    }
+    if (!rom_path) { usage(argv0); return 2; }
+    const bool quirks_auto = strcmp(quirks_name, "auto") == 0;
+    Chip8Quirks quirks = CHIP8_QUIRKS_DEFAULT;
+    if (!quirks_auto && !quirks_from_name(quirks_name, &quirks)) { usage(argv0); return 2; }
+
+    static Session s;
+    chip8_init(&s.c8);
+    debug_init(&s.dbg);
+    Chip8Status st = chip8_load_rom(&s.c8, rom_path);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Failed to load ROM: %s (%s)\n", rom_path, chip8_status_str(st));
+        chip8_destroy(&s.c8);
+        return 3;
+    }
+    s.c8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    chip8_set_quirks(&s.c8, quirks_auto ? chip8_detect_quirks(&s.c8) : quirks);
+    s.cycles_per_frame = (uint32_t)(cpu_hz / TIMER_CLOCK_HZ);
+    if (s.cycles_per_frame == 0) s.cycles_per_frame = 1;
+    s.frame_left = s.cycles_per_frame;
+
+    bool running = true;
+    for (int k = 0; k < ex_count && running; ++k) {
+        char line[256];
+        snprintf(line, sizeof(line), "%s", ex[k]);
+        running = execute(&s, line);
+    }
+    char line[256];
+    while (running) {
+        fputs("(chip8) ", stdout);
+        fflush(stdout);
+        if (!fgets(line, sizeof(line), stdin)) break;
+        running = execute(&s, line);
+    }
+
+    chip8_destroy(&s.c8);
+    return 0;
+}
@@ -0,0 +1,313 @@
+// tools/chip8_headless.c
+// Headless runner: executes a ROM for a fixed budget of cycles/frames with
+// no window and no audio device. Intended for CI and batch servers.
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "chip8.h"
+#include "chip8_status.h"
+#include "instr.h"
+#include "analyze.h"
+#include "aot.h"
+#include "replay.h"
+#include "screen.h"
+#include "timer.h"
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <path/to/rom>\n"
+            "  --cycles N   stop after N CPU cycles (default 100000)\n"
+            "  --frames N   stop after N 60 Hz frames (overrides --cycles)\n"
+            "  --hz N       CPU cycles per second (default %d)\n"
+            "  --seed N     seed for the Cxkk RNG (default 0)\n"
+            "  --quirks P   quirks profile: auto (ROM database, else default), default,\n"
+            "               vip, chip48, schip or xochip (default auto)\n"
+            "  --dump       print the final framebuffer as ASCII\n"
+            "  --bench      report wall time and cycles per second\n"
+            "  --no-blocks  single-step chip8_step() instead of chip8_run_blocks()\n"
+            "  --no-icache  fetch + full decode every cycle (baseline for --bench)\n"
+            "  --no-idle    execute wait loops instead of fast-forwarding them\n"
+            "  --predecode  fill the decode cache from a static analysis of the ROM\n"
+            "               before running (see chip8_analyze)\n"
+            "  --aot        run the ROM's ahead-of-time translation where RAM matches\n"
+            "               (ROM/GAMES, built with -DCHIP8_BUILD_AOT=ON)\n"
+            "  --replay F   replay the input recording F (its seed, quirks, frame length\n"
+            "               and length; --cycles/--frames still cap the run)\n"
+            "  --profile N  print the profiler report with the N hottest addresses\n"
+            "               (needs a -DCHIP8_ENABLE_PROFILER=ON build)\n"
+            "  --trace F    write a binary execution trace to F, for chip8_trace\n"
+            "               (needs a -DCHIP8_ENABLE_TRACE=ON build; not with --no-icache)\n"
+            "  --trace-drop drop trace records instead of waiting when the writer\n"
+            "               falls behind\n",
+            argv0, CPU_CLOCK_HZ);
+}
+
+/* Parse a non-negative integer argument; returns false on garbage. */
+static bool parse_u64(const char* s, uint64_t* out) {
+    if (!s || !*s) return false;
+    char* end = NULL;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (!end || *end != '\0') return false;
+    *out = (uint64_t)v;
+    return true;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Uncached step: refetch and fully decode every cycle, as before the decode cache. */
+static Chip8Status step_uncached(struct Chip8* c8) {
+    Registers* regs = &c8->chip8_regs;
+    if (regs->vblank_wait) return CHIP8_OK;   /* display wait: an idle cycle */
+    const uint16_t pc = regs->PC;
+    if ((size_t)pc + 1u >= MEMORY_SIZE) return CHIP8_ERR_MEM_OOB;
+
+    const Memory* m = &c8->chip8_mem;
+    const uint16_t op = (uint16_t)((memory_peek(m, pc) << 8) | memory_peek(m, (uint16_t)(pc + 1)));
+    Instr in;
+    instr_decode_quirks(op, chip8_get_quirks(c8), &in);
+    regs->PC = (uint16_t)(pc + 2);
+    in.fn(&in, regs, &c8->chip8_mem, &c8->chip8_disp, &c8->chip8_stack, &c8->chip8_kbd);
+    return CHIP8_OK;
+}
+
+static void dump_screen(const Screen* scr) {
+    static const char shade[4] = { '.', '#', '+', '@' };   /* colour 0..3 (XO-CHIP planes) */
+    const uint8_t w = screen_width(scr), h = screen_height(scr);
+    for (uint8_t y = 0; y < h; ++y) {
+        char line[HIRES_WIDTH + 1];
+        for (uint8_t x = 0; x < w; ++x) {
+            line[x] = shade[screen_get_color(scr, x, y)];
+        }
+        line[w] = '\0';
+        puts(line);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* argv0    = (argc > 0 ? argv[0] : "chip8_headless");
+    const char* rom_path = NULL;
+    uint64_t max_cycles  = 100000ull;
+    uint64_t max_frames  = 0;
+    uint64_t cpu_hz      = CPU_CLOCK_HZ;
+    uint64_t seed        = 0;
+    bool     dump        = false;
+    bool     bench       = false;
+    bool     use_icache  = true;
+    bool     use_blocks  = true;
+    bool     skip_idle   = true;
+    bool     predecode   = false;
+    bool     use_aot     = false;
+    bool     cycles_set  = false;
+    uint64_t profile_top = 0;   /* 0 = no report */
+    const char* replay_path = NULL;
+    const char* quirks_name = "auto";
+    const char* trace_path  = NULL;
+    bool     trace_drop  = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool ok = true;
+        if      (strcmp(a, "--cycles") == 0 && i + 1 < argc) { ok = parse_u64(argv[++i], &max_cycles); cycles_set = true; }
+        else if (strcmp(a, "--frames") == 0 && i + 1 < argc) ok = parse_u64(argv[++i], &max_frames);
+        else if (strcmp(a, "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+        else if (strcmp(a, "--profile") == 0 && i + 1 < argc) ok = parse_u64(argv[++i], &profile_top) && profile_top > 0;
+        else if (strcmp(a, "--hz")     == 0 && i + 1 < argc) ok = parse_u64(argv[++i], &cpu_hz);
+        else if (strcmp(a, "--seed")   == 0 && i + 1 < argc) ok = parse_u64(argv[++i], &seed);
+        else if (strcmp(a, "--quirks") == 0 && i + 1 < argc) quirks_name = argv[++i];
+        else if (strcmp(a, "--trace")  == 0 && i + 1 < argc) trace_path = argv[++i];
+        else if (strcmp(a, "--trace-drop") == 0) trace_drop = true;
+        else if (strcmp(a, "--dump")   == 0) dump = true;
+        else if (strcmp(a, "--bench")  == 0) bench = true;
+        else if (strcmp(a, "--no-blocks") == 0) use_blocks = false;
+        else if (strcmp(a, "--no-icache") == 0) use_icache = false;
+        else if (strcmp(a, "--no-idle")   == 0) skip_idle  = false;
+        else if (strcmp(a, "--predecode") == 0) predecode  = true;
+        else if (strcmp(a, "--aot")       == 0) use_aot    = true;
+        else if (a[0] != '-' && !rom_path) rom_path = a;
+        else ok = false;
+
+        if (!ok) { usage(argv0); return 2; }
+    }
+    if (!rom_path || cpu_hz == 0) { usage(argv0); return 2; }
+    const bool quirks_auto = strcmp(quirks_name, "auto") == 0;
+    Chip8Quirks quirks = CHIP8_QUIRKS_DEFAULT;
+    if (!quirks_auto && !quirks_from_name(quirks_name, &quirks)) { usage(argv0); return 2; }
+#ifndef CHIP8_AOT_GAMES
+    if (use_aot) {
+        fprintf(stderr, "--aot: no translated ROMs built in (configure with -DCHIP8_BUILD_AOT=ON)\n");
+        return 2;
+    }
+#endif
+#ifndef CHIP8_TRACE
+    if (trace_path) {
+        fprintf(stderr, "--trace: tracing not built in (configure with -DCHIP8_ENABLE_TRACE=ON)\n");
+        return 2;
+    }
+#endif
+    (void)trace_drop;
+#ifndef CHIP8_PROFILE
+    if (profile_top) {
+        fprintf(stderr, "--profile: profiler not built in (configure with -DCHIP8_ENABLE_PROFILER=ON)\n");
+        return 2;
+    }
+#endif
+
+    /* A recording fixes the seed, quirks profile, frame length and (unless
+     * capped) run length; an explicit --quirks must agree with it. */
+    InputLog log;
+    InputPlayer player;
+    input_player_init(&player, NULL);
+    if (replay_path) {
+        Chip8Status ls = input_log_load(&log, replay_path);
+        if (ls != CHIP8_OK) {
+            fprintf(stderr, "Failed to load recording: %s (%s)\n", replay_path, chip8_status_str(ls));
+            return 3;
+        }
+        if (!quirks_auto && log.quirks != quirks) {
+            fprintf(stderr, "Recording %s: %s\n", replay_path, chip8_status_str(CHIP8_ERR_REPLAY_QUIRKS_MISMATCH));
+            input_log_free(&log);
+            return 3;
+        }
+        input_player_init(&player, &log);
+        seed = log.seed;
+        if (!cycles_set) max_cycles = log.end_cycle;
+        cpu_hz = (uint64_t)log.cycles_per_frame * TIMER_CLOCK_HZ;
+    }
+
+    /* Cycles per 60 Hz frame; DT/ST tick once per frame. */
+    uint64_t cycles_per_frame = cpu_hz / TIMER_CLOCK_HZ;
+    if (cycles_per_frame == 0) cycles_per_frame = 1;
+    if (max_frames > 0) max_cycles = max_frames * cycles_per_frame;
+
+    static struct Chip8 chip8;   /* off the stack: profiler builds add 512 KB of counters */
+    chip8_init(&chip8);
+    chip8_seed(&chip8, seed);
+    chip8.chip8_skip_idle = skip_idle;
+
+    Chip8Status st = chip8_load_rom(&chip8, rom_path);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "Failed to load ROM: %s (%s)\n", rom_path, chip8_status_str(st));
+        chip8_destroy(&chip8);
+        if (replay_path) input_log_free(&log);
+        return 3;
+    }
+    if (replay_path && input_log_rom_hash(&chip8.chip8_mem) != log.rom_hash) {
+        fprintf(stderr, "Recording %s: %s\n", replay_path, chip8_status_str(CHIP8_ERR_REPLAY_ROM_MISMATCH));
+        chip8_destroy(&chip8);
+        input_log_free(&log);
+        return 3;
+    }
+    chip8.chip8_regs.PC = PROGRAM_START_ADDRESS;
+    chip8_set_quirks(&chip8, replay_path ? log.quirks : quirks_auto ? chip8_detect_quirks(&chip8) : quirks);
+    if (predecode) {
+        static RomAnalysis an;
+        st = rom_analyze(&chip8.chip8_mem, PROGRAM_START_ADDRESS, &an);
+        if (st != CHIP8_OK) {
+            fprintf(stderr, "ROM analysis failed: %s\n", chip8_status_str(st));
+            chip8_destroy(&chip8);
+            if (replay_path) input_log_free(&log);
+            return 3;
+        }
+        (void)chip8_predecode(&chip8, &an);
+        rom_analysis_free(&an);
+    }
+#ifdef CHIP8_AOT_GAMES
+    if (use_aot) {
+        const AotModule* mod = aot_find(&aot_games, input_log_rom_hash(&chip8.chip8_mem));
+        if (!mod) fprintf(stderr, "--aot: %s was not translated; interpreting\n", rom_path);
+        else if (mod->quirks != chip8_get_quirks(&chip8)) {
+            fprintf(stderr, "--aot: %s was translated for quirks %s; interpreting\n", rom_path, quirks_profile(mod->quirks)->name);
+        }
+        chip8_set_aot(&chip8, mod);
+    }
+#endif
+
+#ifdef CHIP8_TRACE
+    TraceRing* trace = NULL;
+    if (trace_path) {
+        st = trace_open(&trace, trace_path, 0, input_log_rom_hash(&chip8.chip8_mem), trace_drop);
+        if (st != CHIP8_OK) {
+            fprintf(stderr, "Failed to open trace: %s (%s)\n", trace_path, chip8_status_str(st));
+            chip8_destroy(&chip8);
+            if (replay_path) input_log_free(&log);
+            return 3;
+        }
+        chip8_set_trace(&chip8, trace);
+    }
+#endif
+
+    uint64_t cycles = 0;
+    uint64_t frame_left = cycles_per_frame;   /* cycles until the next timer tick */
+    const uint64_t t0 = now_ns();
+    while (cycles < max_cycles) {
+        input_player_apply(&player, &chip8.chip8_kbd, cycles);
+
+        uint64_t ran = 0;
+        if (use_icache && use_blocks) {
+            /* never run past the next timer tick, input event or the cycle budget */
+            uint64_t budget = frame_left;
+            if (budget > max_cycles - cycles) budget = max_cycles - cycles;
+            if (budget > input_player_until_next(&player, cycles)) budget = input_player_until_next(&player, cycles);
+            if (budget > UINT32_MAX) budget = UINT32_MAX;
+            uint32_t n = 0;
+            st = chip8_run_blocks(&chip8, (uint32_t)budget, &n);
+            ran = n;
+        } else {
+            st = use_icache ? chip8_step(&chip8) : step_uncached(&chip8);
+            if (st == CHIP8_OK) ran = 1;
+        }
+        cycles     += ran;
+        frame_left -= ran;
+        if (st != CHIP8_OK) break;
+
+        if (frame_left == 0) {
+            regs_tick_frame(&chip8.chip8_regs);
+            frame_left = cycles_per_frame;
+        }
+    }
+    const uint64_t wall_ns = now_ns() - t0;
+#ifdef CHIP8_TRACE
+    if (trace) {
+        chip8_set_trace(&chip8, NULL);
+        TraceStats ts;
+        const Chip8Status cs = trace_close(trace, &ts);
+        if (cs != CHIP8_OK) fprintf(stderr, "Trace %s: %s\n", trace_path, chip8_status_str(cs));
+        printf("trace=%s records=%llu dropped=%llu stalls=%llu\n", trace_path, (unsigned long long)ts.records,
+               (unsigned long long)ts.dropped, (unsigned long long)ts.stalls);
+    }
+#endif
+
+    printf("rom=%s seed=%llu cycles=%llu frames=%llu status=%s pc=0x%03X quirks=%s fb_hash=%016llx\n",
+           rom_path,
+           (unsigned long long)seed,
+           (unsigned long long)cycles,
+           (unsigned long long)(cycles / cycles_per_frame),
+           chip8_status_str(st),
+           (unsigned)chip8.chip8_regs.PC,
+           quirks_profile(chip8_get_quirks(&chip8))->name,
+           (unsigned long long)screen_hash(&chip8.chip8_disp));
+    if (bench) {
+        const double secs = (double)wall_ns / 1e9;
+        printf("wall_ms=%.3f cycles_per_sec=%.0f idle_skipped=%llu (%s)\n",
+               secs * 1e3,
+               secs > 0.0 ? (double)cycles / secs : 0.0,
+               (unsigned long long)chip8.chip8_idle_cycles,
+               !use_icache ? "fetch+exec" : !use_blocks ? "decode cache" : (chip8.chip8_aot ? "basic blocks + aot" : "basic blocks"));
+    }
+    if (dump) dump_screen(&chip8.chip8_disp);
+#ifdef CHIP8_PROFILE
+    if (profile_top) prof_report(&chip8.chip8_prof, &chip8.chip8_mem, stdout, (size_t)profile_top);
+#endif
+    chip8_destroy(&chip8);
+    if (replay_path) input_log_free(&log);
+
+    return (st == CHIP8_OK) ? 0 : 4;
+}
@@ -0,0 +1,129 @@
+// tools/chip8_trace.c
+// Trace decoder: prints the records of a binary execution trace written by
+// chip8_headless --trace, one disassembled instruction per line with the
+// registers it changed.
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "chip8_status.h"
+#include "instr.h"
+#include "trace.h"
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] <trace>\n"
+            "  --from N     skip records before cycle N\n"
+            "  --count N    stop after printing N records\n"
+            "  --pc ADDR    only records at address ADDR (hex)\n"
+            "  --summary    print the header and per-address counts only\n",
+            argv0);
+}
+
+/* What each kind leaves behind that is worth showing. */
+enum { SHOW_VX = 1u, SHOW_VF = 2u, SHOW_I = 4u };
+
+static unsigned show_mask(InstrKind kind) {
+    switch (kind) {
+    case INSTR_LD_IMM: case INSTR_ADD_IMM: case INSTR_LD_REG: case INSTR_RND:
+    case INSTR_LD_VX_DT: case INSTR_LD_KEY: case INSTR_LD_RPL: case INSTR_LD_RANGE:
+        return SHOW_VX;
+    case INSTR_OR: case INSTR_AND: case INSTR_XOR:   /* VF for the vf_reset quirk */
+    case INSTR_ADD_REG: case INSTR_SUB: case INSTR_SHR: case INSTR_SUBN: case INSTR_SHL:
+        return SHOW_VX | SHOW_VF;
+    case INSTR_DRW:
+        return SHOW_VF;
+    case INSTR_LD_I: case INSTR_ADD_I: case INSTR_LD_F: case INSTR_LD_HF: case INSTR_LD_LONG:
+    case INSTR_ST_REGS:   /* I moves under the index quirks */
+        return SHOW_I;
+    case INSTR_LD_REGS:
+        return SHOW_VX | SHOW_I;
+    default:
+        return 0;
+    }
+}
+
+static bool parse_num(const char* s, int base, unsigned long long* out) {
+    if (!s || !*s) return false;
+    char* end = NULL;
+    *out = strtoull(s, &end, base);
+    return end && *end == '\0';
+}
+
+static void print_record(const TraceRecord* r) {
+    char text[INSTR_DISASM_MAX];
+    instr_disasm(r->op, text, sizeof(text));
+    if (r->op == 0xF000u) snprintf(text, sizeof(text), "LD I, 0x%04X", (unsigned)r->i);
+
+    const unsigned show = show_mask(instr_kind(r->op));
+    printf("%12llu 0x%03X %04X  %-16s", (unsigned long long)r->cycle, (unsigned)r->pc, (unsigned)r->op, text);
+    if (show & SHOW_VX) printf(" V%X=%02X", (unsigned)OP_X(r->op), (unsigned)r->vx);
+    if (show & SHOW_VF) printf(" VF=%02X", (unsigned)r->vf);
+    if (show & SHOW_I)  printf(" I=0x%03X", (unsigned)r->i);
+    putchar('\n');
+}
+
+int main(int argc, char** argv) {
+    const char* argv0 = (argc > 0 ? argv[0] : "chip8_trace");
+    const char* path  = NULL;
+    unsigned long long from = 0, count = 0, pc = 0;
+    bool by_pc   = false;
+    bool summary = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool ok = true;
+        if      (strcmp(a, "--from")  == 0 && i + 1 < argc) ok = parse_num(argv[++i], 10, &from);
+        else if (strcmp(a, "--count") == 0 && i + 1 < argc) ok = parse_num(argv[++i], 10, &count) && count > 0;
+        else if (strcmp(a, "--pc")    == 0 && i + 1 < argc) { ok = parse_num(argv[++i], 16, &pc) && pc < MEMORY_SIZE; by_pc = true; }
+        else if (strcmp(a, "--summary") == 0) summary = true;
+        else if (a[0] != '-' && !path) path = a;
+        else ok = false;
+
+        if (!ok) { usage(argv0); return 2; }
+    }
+    if (!path) { usage(argv0); return 2; }
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 3;
+    }
+    TraceHeader h;
+    Chip8Status st = trace_read_header(fp, &h);
+    if (st != CHIP8_OK) {
+        fprintf(stderr, "%s: %s\n", path, chip8_status_str(st));
+        fclose(fp);
+        return 3;
+    }
+
+    static uint64_t per_pc[MEMORY_SIZE];
+    static TraceRecord recs[4096];
+    uint64_t total = 0, printed = 0, last_cycle = 0;
+    size_t n;
+    bool done = false;
+    while (!done && (n = trace_read(fp, recs, sizeof(recs) / sizeof(recs[0]))) > 0) {
+        for (size_t k = 0; k < n; ++k) {
+            const TraceRecord* r = &recs[k];
+            ++total;
+            last_cycle = r->cycle;
+            if (summary) { per_pc[r->pc]++; continue; }
+            if (r->cycle < from || (by_pc && r->pc != pc)) continue;
+            print_record(r);
+            if (count && ++printed == count) { done = true; break; }
+        }
+    }
+    fclose(fp);
+
+    if (summary) {
+        printf("trace=%s rom_hash=%016llx records=%llu dropped=%llu last_cycle=%llu%s\n", path,
+               (unsigned long long)h.rom_hash, (unsigned long long)total, (unsigned long long)h.dropped,
+               (unsigned long long)last_cycle, h.records == 0 && total ? " (not closed)" : "");
+        for (size_t a = 0; a < MEMORY_SIZE; ++a) {
+            if (per_pc[a]) printf("0x%03X %12llu\n", (unsigned)a, (unsigned long long)per_pc[a]);
+        }
+    }
+    return 0;
+}